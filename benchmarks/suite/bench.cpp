@@ -0,0 +1,596 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/sorters.h>
+#include <cpp-sort/sorters/parallel_counting_sorter.h>
+#include <cpp-sort/sorters/parallel_merge_sorter.h>
+#include <cpp-sort/sorters/parallel_pdq_sorter.h>
+#include <cpp-sort/sorters/parallel_ska_sorter.h>
+#include <cpp-sort/sorters/parallel_spread_sorter.h>
+#include <cpp-sort/version.h>
+#include "distributions.h"
+#include "rdtsc.h"
+#include "statistics.h"
+
+// Runs every combination of the selected sorters, distributions, sizes
+// and element types, and writes the results as JSON so that different
+// runs can be compared with compare.py; run with --help for the options
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    // Always use a steady clock
+    using clock_type = std::conditional_t<
+        std::chrono::high_resolution_clock::is_steady,
+        std::chrono::high_resolution_clock,
+        std::chrono::steady_clock
+    >;
+
+    ////////////////////////////////////////////////////////////
+    // Instrumentation
+
+    // Comparison function object counting the number of comparisons it
+    // performs, the counter is atomic for the sake of parallel sorters
+    struct counting_less
+    {
+        std::atomic<std::uint64_t>* count;
+
+        template<typename T, typename U>
+        auto operator()(const T& lhs, const U& rhs) const
+            -> bool
+        {
+            count->fetch_add(1, std::memory_order_relaxed);
+            return lhs < rhs;
+        }
+    };
+
+    // Wrapper counting how many times the elements are copied or moved,
+    // be it with a constructor or an assignment
+    std::atomic<std::uint64_t> moves_count(0);
+
+    template<typename T>
+    struct counted
+    {
+        T value;
+
+        counted() = default;
+
+        explicit counted(const T& value):
+            value(value)
+        {}
+
+        counted(const counted& other):
+            value(other.value)
+        {
+            moves_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        counted(counted&& other) noexcept:
+            value(std::move(other.value))
+        {
+            moves_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        auto operator=(const counted& other)
+            -> counted&
+        {
+            value = other.value;
+            moves_count.fetch_add(1, std::memory_order_relaxed);
+            return *this;
+        }
+
+        auto operator=(counted&& other) noexcept
+            -> counted&
+        {
+            value = std::move(other.value);
+            moves_count.fetch_add(1, std::memory_order_relaxed);
+            return *this;
+        }
+
+        friend auto operator<(const counted& lhs, const counted& rhs)
+            -> bool
+        {
+            return lhs.value < rhs.value;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Element types
+
+    // The distributions generate integers which are then converted to the
+    // element type in a way that preserves their order
+
+    template<typename T>
+    auto from_integer(long long value)
+        -> T
+    {
+        return static_cast<T>(value);
+    }
+
+    template<>
+    auto from_integer<std::string>(long long value)
+        -> std::string
+    {
+        std::ostringstream ss;
+        ss << std::setw(20) << std::setfill('0') << value;
+        return ss.str();
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Sorters
+
+    template<typename T>
+    struct sorter_case
+    {
+        std::string name;
+        // Quadratic sorters are only run when explicitly selected
+        bool quadratic;
+        std::function<void(std::vector<T>&)> sort;
+        // Empty when the sorter can't count the corresponding operation
+        std::function<std::uint64_t(std::vector<T>&)> count_comparisons;
+        std::function<std::uint64_t(const std::vector<T>&)> count_moves;
+    };
+
+    template<typename T, typename Sorter>
+    auto make_comparisons_counter(std::true_type)
+        -> std::function<std::uint64_t(std::vector<T>&)>
+    {
+        return [](std::vector<T>& collection) {
+            std::atomic<std::uint64_t> count(0);
+            Sorter{}(collection, counting_less{&count});
+            return count.load();
+        };
+    }
+
+    template<typename T, typename Sorter>
+    auto make_comparisons_counter(std::false_type)
+        -> std::function<std::uint64_t(std::vector<T>&)>
+    {
+        return nullptr;
+    }
+
+    template<typename T, typename Sorter>
+    auto make_moves_counter(std::true_type)
+        -> std::function<std::uint64_t(const std::vector<T>&)>
+    {
+        return [](const std::vector<T>& collection) {
+            std::vector<counted<T>> wrapped;
+            wrapped.reserve(collection.size());
+            for (auto& value: collection) {
+                wrapped.emplace_back(value);
+            }
+            moves_count = 0;
+            Sorter{}(wrapped);
+            return moves_count.load();
+        };
+    }
+
+    template<typename T, typename Sorter>
+    auto make_moves_counter(std::false_type)
+        -> std::function<std::uint64_t(const std::vector<T>&)>
+    {
+        return nullptr;
+    }
+
+    template<typename T, typename Sorter>
+    auto add_sorter(std::vector<sorter_case<T>>& cases, const char* name, bool quadratic, std::true_type)
+        -> void
+    {
+        cases.push_back({
+            name,
+            quadratic,
+            [](std::vector<T>& collection) { Sorter{}(collection); },
+            make_comparisons_counter<T, Sorter>(std::integral_constant<bool,
+                cppsort::is_comparison_sorter_v<Sorter, std::vector<T>&, counting_less>
+            >{}),
+            make_moves_counter<T, Sorter>(std::integral_constant<bool,
+                cppsort::is_sorter_v<Sorter, std::vector<counted<T>>&>
+            >{})
+        });
+    }
+
+    template<typename T, typename Sorter>
+    auto add_sorter(std::vector<sorter_case<T>>&, const char*, bool, std::false_type)
+        -> void
+    {
+        // The sorter can't sort elements of type T
+    }
+
+    template<typename T, typename Sorter>
+    auto add_sorter(std::vector<sorter_case<T>>& cases, const char* name, bool quadratic=false)
+        -> void
+    {
+        add_sorter<T, Sorter>(cases, name, quadratic, std::integral_constant<bool,
+            cppsort::is_sorter_v<Sorter, std::vector<T>&>
+        >{});
+    }
+
+    template<typename T>
+    auto make_sorters()
+        -> std::vector<sorter_case<T>>
+    {
+        std::vector<sorter_case<T>> cases;
+        add_sorter<T, cppsort::block_sorter<>>(cases, "block_sorter");
+        add_sorter<T, cppsort::counting_sorter>(cases, "counting_sorter");
+        add_sorter<T, cppsort::drop_merge_sorter>(cases, "drop_merge_sorter");
+        add_sorter<T, cppsort::grail_sorter<>>(cases, "grail_sorter");
+        add_sorter<T, cppsort::heap_sorter>(cases, "heap_sorter");
+        add_sorter<T, cppsort::insertion_sorter>(cases, "insertion_sorter", true);
+        add_sorter<T, cppsort::merge_insertion_sorter>(cases, "merge_insertion_sorter", true);
+        add_sorter<T, cppsort::merge_sorter>(cases, "merge_sorter");
+        add_sorter<T, cppsort::parallel_counting_sorter<>>(cases, "parallel_counting_sorter");
+        add_sorter<T, cppsort::parallel_merge_sorter<>>(cases, "parallel_merge_sorter");
+        add_sorter<T, cppsort::parallel_pdq_sorter<>>(cases, "parallel_pdq_sorter");
+        add_sorter<T, cppsort::parallel_ska_sorter<>>(cases, "parallel_ska_sorter");
+        add_sorter<T, cppsort::parallel_spread_sorter<>>(cases, "parallel_spread_sorter");
+        add_sorter<T, cppsort::pdq_sorter>(cases, "pdq_sorter");
+        add_sorter<T, cppsort::poplar_sorter>(cases, "poplar_sorter");
+        add_sorter<T, cppsort::quick_merge_sorter>(cases, "quick_merge_sorter");
+        add_sorter<T, cppsort::quick_sorter>(cases, "quick_sorter");
+        add_sorter<T, cppsort::selection_sorter>(cases, "selection_sorter", true);
+        add_sorter<T, cppsort::ska_sorter>(cases, "ska_sorter");
+        add_sorter<T, cppsort::smooth_sorter>(cases, "smooth_sorter");
+        add_sorter<T, cppsort::spin_sorter>(cases, "spin_sorter");
+        add_sorter<T, cppsort::split_sorter>(cases, "split_sorter");
+        add_sorter<T, cppsort::spread_sorter>(cases, "spread_sorter");
+        add_sorter<T, cppsort::std_sorter>(cases, "std_sorter");
+        add_sorter<T, cppsort::tim_sorter>(cases, "tim_sorter");
+        add_sorter<T, cppsort::verge_sorter>(cases, "verge_sorter");
+        return cases;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Distributions
+
+    using distribution_f = std::function<void(std::back_insert_iterator<std::vector<long long>>, std::size_t)>;
+
+    struct distribution_case
+    {
+        std::string name;
+        distribution_f generate;
+        // Some distributions only make sense for big enough collections
+        std::size_t min_size;
+    };
+
+    auto make_distributions()
+        -> std::vector<distribution_case>
+    {
+        return {
+            { "shuffled",                   shuffled{},                 0       },
+            { "shuffled_16_values",         shuffled_16_values{},       0       },
+            { "all_equal",                  all_equal{},                0       },
+            { "ascending",                  ascending{},                0       },
+            { "descending",                 descending{},               0       },
+            { "pipe_organ",                 pipe_organ{},               0       },
+            { "push_front",                 push_front{},               0       },
+            { "push_middle",                push_middle{},              0       },
+            { "ascending_sawtooth",         ascending_sawtooth{},       0       },
+            { "ascending_sawtooth_bad",     ascending_sawtooth_bad{},   0       },
+            { "descending_sawtooth",        descending_sawtooth{},      0       },
+            { "descending_sawtooth_bad",    descending_sawtooth_bad{},  0       },
+            { "alternating",                alternating{},              0       },
+            { "alternating_16_values",      alternating_16_values{},    0       },
+            { "inversions_1",               inversions(0.01),           1       },
+            { "inversions_10",              inversions(0.1),            1       },
+            { "vergesort_killer",           vergesort_killer{},         1000    }
+        };
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Command line
+
+    struct options
+    {
+        std::vector<std::string> sorters;
+        std::vector<std::string> distributions = { "shuffled" };
+        std::vector<std::size_t> sizes = { 1'000, 100'000 };
+        std::vector<std::string> types = { "int" };
+        std::chrono::duration<double> min_time = 1s;
+        std::size_t max_repetitions = 100;
+        std::uint_fast32_t seed = static_cast<std::uint_fast32_t>(std::time(nullptr));
+        bool count_operations = true;
+        std::string output;
+    };
+
+    auto split(const std::string& list)
+        -> std::vector<std::string>
+    {
+        std::vector<std::string> res;
+        std::istringstream ss(list);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            if (not item.empty()) {
+                res.push_back(item);
+            }
+        }
+        return res;
+    }
+
+    auto selected(const std::vector<std::string>& selection, const std::string& name)
+        -> bool
+    {
+        return std::find(std::begin(selection), std::end(selection), name) != std::end(selection);
+    }
+
+    auto print_usage(const char* program)
+        -> void
+    {
+        std::cerr
+            << "usage: " << program << " [options]\n"
+            << "  --sorters=a,b,...        sorters to run, all the non-quadratic ones by default\n"
+            << "  --distributions=a,b,...  distributions to run, or \"all\" (default: shuffled)\n"
+            << "  --sizes=n,m,...          sizes of the collections (default: 1000,100000)\n"
+            << "  --types=a,b,...          int, int64, double, string or \"all\" (default: int)\n"
+            << "  --min-time=seconds       minimal time spent on every benchmark (default: 1)\n"
+            << "  --max-repetitions=n      maximal number of runs of every benchmark (default: 100)\n"
+            << "  --seed=n                 seed of the distributions (default: current time)\n"
+            << "  --no-counters            don't count comparisons and moves\n"
+            << "  --output=file            write the JSON results to a file instead of stdout\n"
+            << "  --list                   list the available sorters and distributions\n";
+    }
+
+    auto parse_options(int argc, char** argv)
+        -> options
+    {
+        options opts;
+        for (int i = 1 ; i < argc ; ++i) {
+            std::string arg = argv[i];
+            auto pos = arg.find('=');
+            std::string key = arg.substr(0, pos);
+            std::string value = pos == std::string::npos ? "" : arg.substr(pos + 1);
+
+            if (key == "--sorters") {
+                opts.sorters = split(value);
+            } else if (key == "--distributions") {
+                opts.distributions = split(value);
+            } else if (key == "--sizes") {
+                opts.sizes.clear();
+                for (auto& size: split(value)) {
+                    opts.sizes.push_back(std::stoull(size));
+                }
+            } else if (key == "--types") {
+                opts.types = split(value);
+                if (opts.types == std::vector<std::string>{ "all" }) {
+                    opts.types = { "int", "int64", "double", "string" };
+                }
+            } else if (key == "--min-time") {
+                opts.min_time = std::chrono::duration<double>(std::stod(value));
+            } else if (key == "--max-repetitions") {
+                opts.max_repetitions = std::max<std::size_t>(std::stoull(value), 1);
+            } else if (key == "--seed") {
+                opts.seed = std::stoul(value);
+            } else if (key == "--no-counters") {
+                opts.count_operations = false;
+            } else if (key == "--output") {
+                opts.output = value;
+            } else if (key == "--list") {
+                std::cout << "sorters:";
+                for (auto& sorter: make_sorters<int>()) {
+                    std::cout << ' ' << sorter.name;
+                }
+                std::cout << "\ndistributions:";
+                for (auto& distribution: make_distributions()) {
+                    std::cout << ' ' << distribution.name;
+                }
+                std::cout << "\ntypes: int int64 double string\n";
+                std::exit(EXIT_SUCCESS);
+            } else {
+                print_usage(argv[0]);
+                std::exit(key == "--help" ? EXIT_SUCCESS : EXIT_FAILURE);
+            }
+        }
+        return opts;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Benchmark code proper
+
+    struct result
+    {
+        std::string sorter;
+        std::string distribution;
+        std::string type;
+        std::size_t size;
+        std::size_t repetitions;
+        double ns_per_element;
+        double ns_per_element_mean;
+        double ns_per_element_stddev;
+        double cycles_per_element;
+        // Negative when the operation can't be counted
+        long long comparisons;
+        long long moves;
+    };
+
+    auto median(std::vector<double> values)
+        -> double
+    {
+        std::sort(std::begin(values), std::end(values));
+        return values[values.size() / 2];
+    }
+
+    template<typename T>
+    auto run_benchmarks(const options& opts, const std::string& type_name, std::vector<result>& results)
+        -> void
+    {
+        auto distributions = make_distributions();
+        for (auto& sorter: make_sorters<T>()) {
+            if (opts.sorters.empty() ? sorter.quadratic : not selected(opts.sorters, sorter.name)) {
+                continue;
+            }
+
+            for (auto& distribution: distributions) {
+                if (not selected(opts.distributions, "all") &&
+                    not selected(opts.distributions, distribution.name)) {
+                    continue;
+                }
+
+                for (auto size: opts.sizes) {
+                    if (size < distribution.min_size) {
+                        continue;
+                    }
+
+                    // Seed the distribution manually to ensure that all algorithms
+                    // sort the same collections when there is randomness
+                    distributions_prng.seed(opts.seed);
+                    auto generate = [&] {
+                        std::vector<long long> values;
+                        values.reserve(size);
+                        distribution.generate(std::back_inserter(values), size);
+                        std::vector<T> collection;
+                        collection.reserve(size);
+                        for (long long value: values) {
+                            collection.push_back(from_integer<T>(value));
+                        }
+                        return collection;
+                    };
+
+                    std::vector<double> times;
+                    std::vector<double> cycles;
+                    auto total_start = clock_type::now();
+                    do {
+                        auto collection = generate();
+                        auto start = clock_type::now();
+                        std::uint64_t start_cycles = rdtsc();
+                        sorter.sort(collection);
+                        std::uint64_t end_cycles = rdtsc();
+                        auto end = clock_type::now();
+                        if (not std::is_sorted(std::begin(collection), std::end(collection))) {
+                            throw std::runtime_error(sorter.name + " failed to sort " + distribution.name);
+                        }
+                        times.push_back(std::chrono::duration<double, std::nano>(end - start).count() / size);
+                        cycles.push_back(double(end_cycles - start_cycles) / size);
+                    } while (clock_type::now() - total_start < opts.min_time &&
+                             times.size() < opts.max_repetitions);
+
+                    result res;
+                    res.sorter = sorter.name;
+                    res.distribution = distribution.name;
+                    res.type = type_name;
+                    res.size = size;
+                    res.repetitions = times.size();
+                    res.ns_per_element = median(times);
+                    res.ns_per_element_mean = average(times);
+                    res.ns_per_element_stddev = standard_deviation(times, res.ns_per_element_mean);
+                    res.cycles_per_element = median(cycles);
+                    res.comparisons = -1;
+                    res.moves = -1;
+                    if (opts.count_operations && sorter.count_comparisons) {
+                        auto collection = generate();
+                        res.comparisons = static_cast<long long>(sorter.count_comparisons(collection));
+                    }
+                    if (opts.count_operations && sorter.count_moves) {
+                        res.moves = static_cast<long long>(sorter.count_moves(generate()));
+                    }
+                    results.push_back(res);
+
+                    std::cerr << std::left << std::setw(24) << res.sorter
+                              << std::setw(26) << res.distribution
+                              << std::setw(8) << res.type
+                              << std::right << std::setw(10) << res.size
+                              << std::fixed << std::setprecision(2)
+                              << std::setw(12) << res.ns_per_element << " ns/elem"
+                              << std::setw(12) << res.cycles_per_element << " cycles/elem\n";
+                }
+            }
+        }
+    }
+
+    auto write_json(std::ostream& out, const options& opts, const std::vector<result>& results)
+        -> void
+    {
+        auto now = std::time(nullptr);
+        char date[64];
+        std::strftime(date, sizeof date, "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+        out << std::setprecision(6) << std::fixed;
+        out << "{\n"
+            << "  \"context\": {\n"
+            << "    \"date\": \"" << date << "\",\n"
+            << "    \"library_version\": \"" << CPPSORT_VERSION_MAJOR << '.'
+                                             << CPPSORT_VERSION_MINOR << '.'
+                                             << CPPSORT_VERSION_PATCH << "\",\n"
+    #ifdef __VERSION__
+            << "    \"compiler\": \"" << __VERSION__ << "\",\n"
+    #endif
+            << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+            << "    \"seed\": " << opts.seed << ",\n"
+            << "    \"min_time\": " << opts.min_time.count() << "\n"
+            << "  },\n"
+            << "  \"benchmarks\": [";
+        for (std::size_t i = 0 ; i < results.size() ; ++i) {
+            auto& res = results[i];
+            out << (i == 0 ? "\n" : ",\n")
+                << "    {\n"
+                << "      \"name\": \"" << res.sorter << '/' << res.distribution << '/'
+                                         << res.type << '/' << res.size << "\",\n"
+                << "      \"sorter\": \"" << res.sorter << "\",\n"
+                << "      \"distribution\": \"" << res.distribution << "\",\n"
+                << "      \"type\": \"" << res.type << "\",\n"
+                << "      \"size\": " << res.size << ",\n"
+                << "      \"repetitions\": " << res.repetitions << ",\n"
+                << "      \"ns_per_element\": " << res.ns_per_element << ",\n"
+                << "      \"ns_per_element_mean\": " << res.ns_per_element_mean << ",\n"
+                << "      \"ns_per_element_stddev\": " << res.ns_per_element_stddev << ",\n"
+                << "      \"cycles_per_element\": " << res.cycles_per_element << ",\n"
+                << "      \"comparisons\": ";
+            if (res.comparisons < 0) out << "null"; else out << res.comparisons;
+            out << ",\n      \"moves\": ";
+            if (res.moves < 0) out << "null"; else out << res.moves;
+            out << "\n    }";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    auto opts = parse_options(argc, argv);
+    std::cerr << "SEED: " << opts.seed << '\n';
+
+    std::vector<result> results;
+    for (auto& type: opts.types) {
+        if (type == "int") {
+            run_benchmarks<int>(opts, type, results);
+        } else if (type == "int64") {
+            run_benchmarks<std::int64_t>(opts, type, results);
+        } else if (type == "double") {
+            run_benchmarks<double>(opts, type, results);
+        } else if (type == "string") {
+            run_benchmarks<std::string>(opts, type, results);
+        } else {
+            std::cerr << "unknown type: " << type << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (opts.output.empty()) {
+        write_json(std::cout, opts, results);
+    } else {
+        std::ofstream output_file(opts.output);
+        write_json(output_file, opts, results);
+    }
+}
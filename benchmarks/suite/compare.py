@@ -0,0 +1,77 @@
+# -*- coding: utf-8 -*-
+
+# Copyright (c) 2020 Morwenn
+# SPDX-License-Identifier: MIT
+
+"""
+Compares two JSON files produced by cpp-sort-bench and reports the
+benchmarks whose time per element changed by more than a threshold.
+The exit status is 1 when at least one regression was found, which
+makes the script usable in a CI job.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_benchmarks(path):
+    with open(path) as fd:
+        data = json.load(fd)
+    return {bench['name']: bench for bench in data['benchmarks']}
+
+
+def relative_change(old, new):
+    if old == 0:
+        return 0.0
+    return (new - old) / old
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two runs of the cpp-sort benchmark suite.")
+    parser.add_argument('baseline', help="JSON results of the reference run")
+    parser.add_argument('contender', help="JSON results of the run to compare to the reference")
+    parser.add_argument('--threshold', type=float, default=0.05,
+                        help="relative slowdown above which a benchmark is a regression (default: 0.05)")
+    parser.add_argument('--metric', default='ns_per_element',
+                        choices=['ns_per_element', 'cycles_per_element', 'comparisons', 'moves'],
+                        help="metric to compare (default: ns_per_element)")
+    args = parser.parse_args()
+
+    baseline = load_benchmarks(args.baseline)
+    contender = load_benchmarks(args.contender)
+
+    regressions = 0
+    print("{:<70} {:>14} {:>14} {:>9}".format("benchmark", "baseline", "contender", "change"))
+    for name, old in baseline.items():
+        new = contender.get(name)
+        if new is None:
+            continue
+        old_value = old.get(args.metric)
+        new_value = new.get(args.metric)
+        if old_value is None or new_value is None:
+            continue
+
+        change = relative_change(old_value, new_value)
+        marker = ""
+        if change > args.threshold:
+            marker = "  REGRESSION"
+            regressions += 1
+        elif change < -args.threshold:
+            marker = "  improvement"
+        print("{:<70} {:>14.2f} {:>14.2f} {:>+8.1f}%{}".format(
+            name, old_value, new_value, change * 100, marker
+        ))
+
+    missing = sorted(set(baseline) ^ set(contender))
+    if missing:
+        print("\nbenchmarks present in only one of the runs:")
+        for name in missing:
+            print("  " + name)
+
+    print("\n{} regression(s) above {:.1f}%".format(regressions, args.threshold * 100))
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2018 Morwenn
+ * Copyright (c) 2015-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #ifndef CPPSORT_ADAPTERS_H_
@@ -18,5 +18,6 @@
 #include <cpp-sort/adapters/small_array_adapter.h>
 #include <cpp-sort/adapters/stable_adapter.h>
 #include <cpp-sort/adapters/verge_adapter.h>
+#include <cpp-sort/adapters/workspace_adapter.h>
 
 #endif // CPPSORT_ADAPTERS_H_
@@ -8,6 +8,7 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <cstdint>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -19,14 +20,26 @@
 #include <cpp-sort/utility/adapter_storage.h>
 #include <cpp-sort/utility/as_function.h>
 #include <cpp-sort/utility/size.h>
+#include "../detail/apply_permutation.h"
 #include "../detail/associate_iterator.h"
 #include "../detail/checkers.h"
 #include "../detail/iterator_traits.h"
+#include "../detail/key_index_iterator.h"
 #include "../detail/memory.h"
+#include "../detail/pdqsort.h"
+#include "../detail/radix_key.h"
+#include "../detail/scope_exit.h"
 #include "../detail/type_traits.h"
 
 namespace cppsort
 {
+    namespace utility
+    {
+        // Tag asking schwartz_adapter to encode the projected
+        // elements into integers sorted with a radix sort
+        struct radix_keys {};
+    }
+
     namespace detail
     {
         struct data_getter
@@ -50,22 +63,19 @@ namespace cppsort
             typename Sorter
         >
         auto sort_with_schwartz(ForwardIterator first, difference_type_t<ForwardIterator> size,
-                                Compare compare, Projection projection, Sorter&& sorter)
+                                Compare compare, Projection projection, Sorter&& sorter,
+                                std::false_type /* separate keys */)
             -> decltype(auto)
         {
-            static_assert(not std::is_same<Sorter, std_sorter>::value,
-                          "std_sorter doesn't work with schwartz_adapter");
-            static_assert(not std::is_same<Sorter, stable_adapter<std_sorter>>::value,
-                          "stable_adapter<std_sorter> doesn't work with schwartz_adapter");
-
             auto&& proj = utility::as_function(projection);
             using proj_t = projected_t<ForwardIterator, Projection>;
             using value_t = association<ForwardIterator, proj_t>;
             using difference_type = difference_type_t<ForwardIterator>;
 
-            // Collection of projected elements
+            // Collection of projected elements, every one of them
+            // associated to the iterator of the original element
             std::unique_ptr<value_t, operator_deleter> projected(
-                static_cast<value_t*>(::operator new(size * sizeof(value_t))),
+                static_cast<value_t*>(detail::allocate(size * sizeof(value_t))),
                 operator_deleter(size * sizeof(value_t))
             );
             destruct_n<value_t> d(0);
@@ -89,10 +99,286 @@ namespace cppsort
             );
         }
 
+        template<
+            typename RandomAccessIterator,
+            typename Compare,
+            typename Projection,
+            typename Sorter
+        >
+        auto sort_with_schwartz(RandomAccessIterator first, difference_type_t<RandomAccessIterator> size,
+                                Compare compare, Projection projection, Sorter&& sorter,
+                                std::true_type /* separate keys */)
+            -> decltype(auto)
+        {
+            auto&& proj = utility::as_function(projection);
+            using proj_t = projected_t<RandomAccessIterator, Projection>;
+            using difference_type = difference_type_t<RandomAccessIterator>;
+
+            // Projected keys and original positions of the elements are
+            // stored in two distinct arrays: the adapted sorter only has
+            // to read contiguous keys to compare elements, and the moves
+            // of the original elements are delayed until the end
+
+            std::unique_ptr<proj_t, operator_deleter> keys(
+                static_cast<proj_t*>(detail::allocate(size * sizeof(proj_t))),
+                operator_deleter(size * sizeof(proj_t))
+            );
+            destruct_n<proj_t> d(0);
+            std::unique_ptr<proj_t, destruct_n<proj_t>&> h2(keys.get(), d);
+
+            std::unique_ptr<difference_type, operator_deleter> indices(
+                static_cast<difference_type*>(detail::allocate(size * sizeof(difference_type))),
+                operator_deleter(size * sizeof(difference_type))
+            );
+
+            auto it = first;
+            for (difference_type count = 0 ; count != size ; ++count) {
+                ::new(keys.get() + count) proj_t(proj(*it));
+                ++d;
+                indices.get()[count] = count;
+                ++it;
+            }
+
+#ifndef __cpp_lib_uncaught_exceptions
+            // Sort the keys alongside the original positions
+            std::forward<Sorter>(sorter)(
+                key_index_iterator<proj_t, difference_type>(keys.get(), indices.get()),
+                key_index_iterator<proj_t, difference_type>(keys.get() + size, indices.get() + size),
+                std::move(compare),
+                key_getter{}
+            );
+#else
+            // Work around the sorters that return void
+            auto exit_function = make_scope_success([&] {
+#endif
+                ////////////////////////////////////////////////////////////
+                // Move the elements to their final positions
+
+                apply_permutation(first, size, indices.get());
+#ifdef __cpp_lib_uncaught_exceptions
+            });
+
+            if (size < 2) {
+                exit_function.release();
+            }
+
+            return std::forward<Sorter>(sorter)(
+                key_index_iterator<proj_t, difference_type>(keys.get(), indices.get()),
+                key_index_iterator<proj_t, difference_type>(keys.get() + size, indices.get() + size),
+                std::move(compare),
+                key_getter{}
+            );
+#endif
+        }
+
+        template<
+            typename ForwardIterator,
+            typename Compare,
+            typename Projection,
+            typename Sorter
+        >
+        auto sort_with_schwartz(ForwardIterator first, difference_type_t<ForwardIterator> size,
+                                Compare compare, Projection projection, Sorter&& sorter)
+            -> decltype(auto)
+        {
+            static_assert(not std::is_same<Sorter, std_sorter>::value,
+                          "std_sorter doesn't work with schwartz_adapter");
+            static_assert(not std::is_same<Sorter, stable_adapter<std_sorter>>::value,
+                          "stable_adapter<std_sorter> doesn't work with schwartz_adapter");
+
+            // Elements are either sorted alongside their projections, or
+            // only moved once the projections have been sorted separately;
+            // the latter pays off when moving elements around while sorting
+            // is more expensive than walking a permutation, which is
+            // typically not the case for trivially copyable types, or when
+            // the keys are arithmetic types that radix sorters read best
+            // from a contiguous array
+            using separate_keys = std::integral_constant<bool,
+                std::is_base_of<
+                    std::random_access_iterator_tag,
+                    iterator_category_t<ForwardIterator>
+                >::value && (
+                    not std::is_trivially_copyable<value_type_t<ForwardIterator>>::value ||
+                    std::is_arithmetic<projected_t<ForwardIterator, Projection>>::value
+                )
+            >;
+            return sort_with_schwartz(std::move(first), size,
+                                      std::move(compare), std::move(projection),
+                                      std::forward<Sorter>(sorter), separate_keys{});
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Sort with radix keys
+
+        template<typename Sorter, typename Iterator, typename Compare, typename Projection>
+        using sorter_result_t = decltype(std::declval<Sorter&>()(
+            std::declval<Iterator>(), std::declval<Iterator>(),
+            std::declval<Compare>(), std::declval<Projection>()
+        ));
+
+        template<
+            typename RandomAccessIterator,
+            typename Compare,
+            typename Projection,
+            typename Sorter
+        >
+        auto sort_with_radix_keys(RandomAccessIterator first, difference_type_t<RandomAccessIterator> size,
+                                  Compare compare, Projection projection, Sorter&& sorter,
+                                  std::true_type /* encodable keys */)
+            -> void
+        {
+            auto&& proj = utility::as_function(projection);
+            using proj_t = projected_t<RandomAccessIterator, Projection>;
+            using difference_type = difference_type_t<RandomAccessIterator>;
+            using iterator = key_index_iterator<std::uint64_t, difference_type>;
+            constexpr bool exact = radix_key_traits<proj_t>::exact;
+
+            // The projected keys are encoded into integers sorted with ska_sort,
+            // the keys themselves are only kept to break the ties between equal
+            // encoded keys when the encoding can't be exact
+
+            std::unique_ptr<proj_t, operator_deleter> keys(
+                static_cast<proj_t*>(detail::allocate(exact ? 0 : size * sizeof(proj_t))),
+                operator_deleter(exact ? 0 : size * sizeof(proj_t))
+            );
+            destruct_n<proj_t> d(0);
+            std::unique_ptr<proj_t, destruct_n<proj_t>&> h2(keys.get(), d);
+
+            std::unique_ptr<std::uint64_t, operator_deleter> encoded(
+                static_cast<std::uint64_t*>(detail::allocate(size * sizeof(std::uint64_t))),
+                operator_deleter(size * sizeof(std::uint64_t))
+            );
+            std::unique_ptr<difference_type, operator_deleter> indices(
+                static_cast<difference_type*>(detail::allocate(size * sizeof(difference_type))),
+                operator_deleter(size * sizeof(difference_type))
+            );
+
+            auto it = first;
+            for (difference_type count = 0 ; count != size ; ++count) {
+                std::uint64_t key;
+                if (exact) {
+                    key = radix_key(proj(*it));
+                } else {
+                    ::new(keys.get() + count) proj_t(proj(*it));
+                    ++d;
+                    key = radix_key(keys.get()[count]);
+                }
+                // Reverse the order of the encoded keys for std::greater<>
+                if (std::is_same<Compare, std::greater<>>::value) {
+                    key = ~key;
+                }
+                encoded.get()[count] = key;
+                indices.get()[count] = count;
+                ++it;
+            }
+
+            iterator encoded_first(encoded.get(), indices.get());
+            ska_sort(encoded_first, encoded_first + size, key_getter{});
+
+            // ska_sort isn't stable: when the adapted sorter is, elements with
+            // equal encoded keys are put back in their original order before
+            // being sorted again according to their original keys if needed
+            constexpr bool stable = is_stable<
+                remove_cvref_t<Sorter>(RandomAccessIterator, RandomAccessIterator, Compare, Projection)
+            >::value;
+            auto tie_projection = [&keys](auto&& value) -> const proj_t& {
+                return keys.get()[value.index];
+            };
+
+            auto enc = encoded.get();
+            difference_type run_begin = 0;
+            while (run_begin != size) {
+                difference_type run_end = run_begin + 1;
+                while (run_end != size && enc[run_end] == enc[run_begin]) {
+                    ++run_end;
+                }
+                if (run_end - run_begin > 1) {
+                    if (stable) {
+                        pdqsort(indices.get() + run_begin, indices.get() + run_end,
+                                std::less<>{}, utility::identity{});
+                    }
+                    if (not exact) {
+                        sorter(encoded_first + run_begin, encoded_first + run_end,
+                               compare, tie_projection);
+                    }
+                }
+                run_begin = run_end;
+            }
+
+            apply_permutation(first, size, indices.get());
+        }
+
+        template<
+            typename ForwardIterator,
+            typename Compare,
+            typename Projection,
+            typename Sorter
+        >
+        auto sort_with_radix_keys(ForwardIterator first, difference_type_t<ForwardIterator> size,
+                                  Compare compare, Projection projection, Sorter&& sorter,
+                                  std::false_type /* encodable keys */)
+            -> decltype(auto)
+        {
+            return sort_with_schwartz(std::move(first), size,
+                                      std::move(compare), std::move(projection),
+                                      std::forward<Sorter>(sorter));
+        }
+
+        template<
+            typename ForwardIterator,
+            typename Compare,
+            typename Projection,
+            typename Sorter
+        >
+        auto sort_with_key_encoding(ForwardIterator first, difference_type_t<ForwardIterator> size,
+                                    Compare compare, Projection projection, Sorter&& sorter,
+                                    std::false_type /* radix keys */)
+            -> decltype(auto)
+        {
+            return sort_with_schwartz(std::move(first), size,
+                                      std::move(compare), std::move(projection),
+                                      std::forward<Sorter>(sorter));
+        }
+
+        template<
+            typename ForwardIterator,
+            typename Compare,
+            typename Projection,
+            typename Sorter
+        >
+        auto sort_with_key_encoding(ForwardIterator first, difference_type_t<ForwardIterator> size,
+                                    Compare compare, Projection projection, Sorter&& sorter,
+                                    std::true_type /* radix keys */)
+            -> decltype(auto)
+        {
+            // Keys can only be radix-sorted when the projected type can be
+            // encoded and when the order is that of std::less<> or
+            // std::greater<>, the regular algorithm is used otherwise; the
+            // adapted sorter is mostly replaced by the radix sort, which is
+            // only done when it returns nothing so that no result is lost
+            using proj_t = projected_t<ForwardIterator, Projection>;
+            using encodable_keys = std::integral_constant<bool,
+                std::is_base_of<
+                    std::random_access_iterator_tag,
+                    iterator_category_t<ForwardIterator>
+                >::value &&
+                radix_key_traits<proj_t>::encodable && (
+                    std::is_same<Compare, std::less<>>::value ||
+                    std::is_same<Compare, std::greater<>>::value
+                ) &&
+                std::is_void<
+                    detected_t<sorter_result_t, Sorter, ForwardIterator, Compare, Projection>
+                >::value
+            >;
+            return sort_with_radix_keys(std::move(first), size,
+                                        std::move(compare), std::move(projection),
+                                        std::forward<Sorter>(sorter), encodable_keys{});
+        }
+
         ////////////////////////////////////////////////////////////
         // Adapter
 
-        template<typename Sorter>
+        template<typename Sorter, typename KeyEncoding>
         struct schwartz_adapter_impl:
             utility::adapter_storage<Sorter>,
             check_iterator_category<Sorter>,
@@ -115,9 +401,9 @@ namespace cppsort
             auto operator()(ForwardIterable&& iterable, Compare compare, Projection projection) const
                 -> decltype(auto)
             {
-                return sort_with_schwartz(std::begin(iterable), utility::size(iterable),
-                                          std::move(compare), std::move(projection),
-                                          this->get());
+                return sort_with_key_encoding(std::begin(iterable), utility::size(iterable),
+                                              std::move(compare), std::move(projection), this->get(),
+                                              std::is_same<KeyEncoding, utility::radix_keys>{});
             }
 
             template<
@@ -132,9 +418,9 @@ namespace cppsort
                             Compare compare, Projection projection) const
                 -> decltype(auto)
             {
-                return sort_with_schwartz(first, std::distance(first, last),
-                                          std::move(compare), std::move(projection),
-                                          this->get());
+                return sort_with_key_encoding(first, std::distance(first, last),
+                                              std::move(compare), std::move(projection), this->get(),
+                                              std::is_same<KeyEncoding, utility::radix_keys>{});
             }
 
             template<typename ForwardIterable, typename Compare=std::less<>>
@@ -179,22 +465,22 @@ namespace cppsort
         };
     }
 
-    template<typename Sorter>
+    template<typename Sorter, typename KeyEncoding>
     struct schwartz_adapter:
-        sorter_facade<detail::schwartz_adapter_impl<Sorter>>
+        sorter_facade<detail::schwartz_adapter_impl<Sorter, KeyEncoding>>
     {
         schwartz_adapter() = default;
 
         constexpr explicit schwartz_adapter(Sorter sorter):
-            sorter_facade<detail::schwartz_adapter_impl<Sorter>>(std::move(sorter))
+            sorter_facade<detail::schwartz_adapter_impl<Sorter, KeyEncoding>>(std::move(sorter))
         {}
     };
 
     ////////////////////////////////////////////////////////////
     // is_stable specialization
 
-    template<typename Sorter, typename... Args>
-    struct is_stable<schwartz_adapter<Sorter>(Args...)>:
+    template<typename Sorter, typename KeyEncoding, typename... Args>
+    struct is_stable<schwartz_adapter<Sorter, KeyEncoding>(Args...)>:
         is_stable<Sorter(Args...)>
     {};
 }
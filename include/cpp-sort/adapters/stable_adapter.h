@@ -107,7 +107,7 @@ namespace cppsort
             // Bind index to iterator
 
             std::unique_ptr<value_t, operator_deleter> iterators(
-                static_cast<value_t*>(::operator new(size * sizeof(value_t))),
+                static_cast<value_t*>(detail::allocate(size * sizeof(value_t))),
                 operator_deleter(size * sizeof(value_t))
             );
             destruct_n<value_t> d(0);
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_ADAPTERS_WORKSPACE_ADAPTER_H_
+#define CPPSORT_ADAPTERS_WORKSPACE_ADAPTER_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <utility>
+#include <cpp-sort/fwd.h>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/adapter_storage.h>
+#include <cpp-sort/utility/memory_resource.h>
+#include "../detail/checkers.h"
+
+namespace cppsort
+{
+    ////////////////////////////////////////////////////////////
+    // Adapter
+
+    namespace detail
+    {
+        // The workspace takes its memory from the resource installed
+        // when it is created; copying an adapter gives the copy its own
+        // empty workspace with the same upstream resource: sharing the
+        // memory would make it unsafe to use both adapters from
+        // different threads
+        struct workspace
+        {
+            workspace() noexcept:
+                workspace(utility::get_memory_resource())
+            {}
+
+            explicit workspace(utility::memory_resource* upstream) noexcept:
+                upstream(upstream),
+                pool(upstream)
+            {}
+
+            workspace(const workspace& other) noexcept:
+                workspace(other.upstream)
+            {}
+
+            auto operator=(const workspace&) noexcept
+                -> workspace&
+            {
+                return *this;
+            }
+
+            utility::memory_resource* upstream;
+            utility::scratch_pool pool;
+        };
+
+        template<typename Sorter>
+        struct workspace_adapter_impl:
+            utility::adapter_storage<Sorter>,
+            check_iterator_category<Sorter>,
+            check_is_always_stable<Sorter>
+        {
+            workspace_adapter_impl() = default;
+
+            constexpr explicit workspace_adapter_impl(Sorter&& sorter):
+                utility::adapter_storage<Sorter>(std::move(sorter))
+            {}
+
+            // The call operators are const so that the adapter can be
+            // composed with other adapters, but every call modifies
+            // the workspace: a given adapter must not be used by
+            // several threads at once
+
+            template<typename Iterator, typename... Args>
+            auto operator()(Iterator first, Iterator last, Args&&... args) const
+                -> decltype(this->get()(std::move(first), std::move(last), std::forward<Args>(args)...))
+            {
+                utility::scoped_memory_resource _(&storage.pool);
+                return this->get()(std::move(first), std::move(last), std::forward<Args>(args)...);
+            }
+
+            template<typename Iterable, typename... Args>
+            auto operator()(Iterable&& iterable, Args&&... args) const
+                -> decltype(this->get()(std::forward<Iterable>(iterable), std::forward<Args>(args)...))
+            {
+                utility::scoped_memory_resource _(&storage.pool);
+                return this->get()(std::forward<Iterable>(iterable), std::forward<Args>(args)...);
+            }
+
+            mutable workspace storage;
+        };
+    }
+
+    template<typename Sorter>
+    struct workspace_adapter:
+        sorter_facade<detail::workspace_adapter_impl<Sorter>>
+    {
+        ////////////////////////////////////////////////////////////
+        // Construction
+
+        workspace_adapter() = default;
+
+        constexpr explicit workspace_adapter(Sorter sorter):
+            sorter_facade<detail::workspace_adapter_impl<Sorter>>(std::move(sorter))
+        {}
+
+        ////////////////////////////////////////////////////////////
+        // Workspace management
+
+        // Size in bytes of the memory kept between calls
+        auto capacity() const noexcept
+            -> std::size_t
+        {
+            return this->storage.pool.capacity();
+        }
+
+        auto reserve(std::size_t size) noexcept
+            -> void
+        {
+            this->storage.pool.reserve(size);
+        }
+
+        // Gives the memory back to the upstream resource
+        auto shrink_to_fit() noexcept
+            -> void
+        {
+            this->storage.pool.release();
+        }
+    };
+
+    ////////////////////////////////////////////////////////////
+    // is_stable specialization
+
+    template<typename Sorter, typename... Args>
+    struct is_stable<workspace_adapter<Sorter>(Args...)>:
+        is_stable<Sorter(Args...)>
+    {};
+}
+
+#endif // CPPSORT_ADAPTERS_WORKSPACE_ADAPTER_H_
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2019 Morwenn
+ * Copyright (c) 2016-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #ifndef CPPSORT_COMPARATORS_CASE_INSENSITIVE_LESS_H_
@@ -8,12 +8,14 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
-#include <algorithm>
 #include <iterator>
 #include <locale>
+#include <string>
 #include <type_traits>
 #include <utility>
+#include <cpp-sort/utility/functional.h>
 #include <cpp-sort/utility/static_const.h>
+#include "../detail/case_folding.h"
 #include "../detail/type_traits.h"
 
 namespace cppsort
@@ -23,32 +25,12 @@ namespace cppsort
         ////////////////////////////////////////////////////////////
         // Case insensitive comparison for char sequences
 
-        template<typename CharT>
-        struct char_less
-        {
-            const std::ctype<CharT>& ct;
-
-            char_less(const std::ctype<CharT>& ct):
-                ct(ct)
-            {}
-
-            auto operator()(CharT lhs, CharT rhs) const
-                -> bool
-            {
-              return ct.tolower(lhs) < ct.tolower(rhs);
-            }
-        };
-
         template<typename T>
         auto case_insensitive_less(const T& lhs, const T& rhs, const std::locale& loc)
             -> bool
         {
             using char_type = remove_cvref_t<decltype(*std::begin(lhs))>;
-            const auto& ct = std::use_facet<std::ctype<char_type>>(loc);
-
-            return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
-                                                std::begin(rhs), std::end(rhs),
-                                                char_less<char_type>(ct));
+            return cached_case_folder<char_type>(loc).less(lhs, rhs);
         }
 
         template<typename T>
@@ -173,13 +155,13 @@ namespace cppsort
                     using char_type = remove_cvref_t<decltype(*std::begin(std::declval<T&>()))>;
 
                     std::locale loc;
-                    const std::ctype<char_type>& ct;
+                    case_folder<char_type> folder;
 
                 public:
 
                     explicit refined_case_insensitive_less_locale_fn(const std::locale& loc):
                         loc(loc),
-                        ct(std::use_facet<std::ctype<char_type>>(loc))
+                        folder(this->loc)
                     {}
 
                     template<typename U=T>
@@ -199,9 +181,7 @@ namespace cppsort
                             bool
                         >
                     {
-                        return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
-                                                            std::begin(rhs), std::end(rhs),
-                                                            char_less<char_type>(ct));
+                        return folder.less(lhs, rhs);
                     }
             };
 
@@ -213,13 +193,13 @@ namespace cppsort
                     using char_type = remove_cvref_t<decltype(*std::begin(std::declval<T&>()))>;
 
                     std::locale loc;
-                    const std::ctype<char_type>& ct;
+                    case_folder<char_type> folder;
 
                 public:
 
                     refined_case_insensitive_less_fn():
                         loc(),
-                        ct(std::use_facet<std::ctype<char_type>>(loc))
+                        folder(loc)
                     {}
 
                     template<typename U=T>
@@ -255,9 +235,7 @@ namespace cppsort
                             bool
                         >
                     {
-                        return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
-                                                            std::begin(rhs), std::end(rhs),
-                                                            char_less<char_type>(ct));
+                        return folder.less(lhs, rhs);
                     }
 
                     auto operator()(const std::locale& loc) const
@@ -269,13 +247,63 @@ namespace cppsort
         }
     }
 
+    ////////////////////////////////////////////////////////////
+    // Case-folded keys
+
+    namespace detail
+    {
+        struct case_folded_locale_fn:
+            utility::projection_base
+        {
+            private:
+
+                std::locale loc;
+
+            public:
+
+                explicit case_folded_locale_fn(const std::locale& loc):
+                    loc(loc)
+                {}
+
+                template<typename T>
+                auto operator()(const T& value) const
+                    -> decltype(detail::case_fold(value, loc))
+                {
+                    return detail::case_fold(value, loc);
+                }
+        };
+
+        struct case_folded_fn:
+            utility::projection_base
+        {
+            template<typename T>
+            auto operator()(const T& value) const
+                -> decltype(detail::case_fold(value, std::declval<const std::locale&>()))
+            {
+                std::locale loc;
+                return detail::case_fold(value, loc);
+            }
+
+            inline auto operator()(const std::locale& loc) const
+                -> case_folded_locale_fn
+            {
+                return case_folded_locale_fn(loc);
+            }
+        };
+    }
+
     using case_insensitive_less_t = detail::case_insensitive_less_fn;
+    using case_folded_t = detail::case_folded_fn;
 
     namespace
     {
         constexpr auto&& case_insensitive_less = utility::static_const<
             detail::case_insensitive_less_fn
         >::value;
+
+        constexpr auto&& case_folded = utility::static_const<
+            detail::case_folded_fn
+        >::value;
     }
 }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2019 Morwenn
+ * Copyright (c) 2016-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #ifndef CPPSORT_COMPARATORS_NATURAL_LESS_H_
@@ -9,8 +9,12 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <cctype>
+#include <climits>
+#include <cstddef>
 #include <iterator>
+#include <string>
 #include <utility>
+#include <cpp-sort/utility/functional.h>
 #include <cpp-sort/utility/static_const.h>
 
 namespace cppsort
@@ -19,6 +23,24 @@ namespace cppsort
     {
         ////////////////////////////////////////////////////////////
         // Natural order for char sequences
+        //
+        // Sequences are compared chunk by chunk, where a chunk is either
+        // a run of digits or a single other character: runs of digits are
+        // compared by numeric value whatever their leading zeros, other
+        // characters are compared as unsigned char, and a run of digits
+        // compares to another character like its first digit would
+
+        inline auto is_natural_digit(char value) noexcept
+            -> bool
+        {
+            return std::isdigit(static_cast<unsigned char>(value));
+        }
+
+        inline auto natural_char_less(char lhs, char rhs) noexcept
+            -> bool
+        {
+            return std::char_traits<char>::lt(lhs, rhs);
+        }
 
         template<typename ForwardIterator1, typename ForwardIterator2>
         auto natural_less_impl(ForwardIterator1 begin1, ForwardIterator1 end1,
@@ -26,59 +48,42 @@ namespace cppsort
             -> bool
         {
             while (begin1 != end1 && begin2 != end2) {
-                auto last1 = begin1;
-                auto last2 = begin2;
-                do {
-                    if (not std::isdigit(*last1)) break;
-                    ++last1;
-                } while (last1 != end1);
-                do {
-                    if (not std::isdigit(*last2)) break;
-                    ++last2;
-                } while (last2 != end2);
-
-                if (last1 != begin1 && last2 != begin2) {
+                if (is_natural_digit(*begin1) && is_natural_digit(*begin2)) {
                     // Skip leading zeros
-                    do {
-                        if (*begin1 != '0') break;
+                    while (begin1 != end1 && *begin1 == '0') {
                         ++begin1;
-                    } while (begin1 != last1);
-                    do {
-                        if (*begin2 != '0') break;
+                    }
+                    while (begin2 != end2 && *begin2 == '0') {
                         ++begin2;
-                    } while (begin2 != last2);
+                    }
 
                     // Compare numbers
+                    auto last1 = begin1;
+                    while (last1 != end1 && is_natural_digit(*last1)) {
+                        ++last1;
+                    }
+                    auto last2 = begin2;
+                    while (last2 != end2 && is_natural_digit(*last2)) {
+                        ++last2;
+                    }
                     auto size1 = std::distance(begin1, last1);
                     auto size2 = std::distance(begin2, last2);
                     if (size1 != size2) {
                         return size1 < size2;
                     }
-                    if (size1 == 0) {
-                        return false;
-                    }
 
-                    // Sizes are equal and not 0
-                    while (begin1 != end1) {
+                    // Sizes are equal
+                    for (; begin1 != last1 ; ++begin1, ++begin2) {
                         if (*begin1 != *begin2) {
                             return *begin1 < *begin2;
                         }
-                        ++begin1;
-                        ++begin2;
                     }
-                }
-
-                if (begin1 == end1) {
-                    return begin2 != end2;
-                }
-                if (begin2 == end2) {
-                    return false;
+                    continue;
                 }
 
                 if (*begin1 != *begin2) {
-                    return *begin1 < *begin2;
+                    return natural_char_less(*begin1, *begin2);
                 }
-
                 ++begin1;
                 ++begin2;
             }
@@ -111,13 +116,80 @@ namespace cppsort
         };
     }
 
+    ////////////////////////////////////////////////////////////
+    // Natural order keys
+
+    namespace detail
+    {
+        // Encodes a sequence of chars into a string whose lexicographical
+        // order is the natural order of the original sequence: other
+        // characters are kept as is, while a run of digits is replaced
+        // with '0' (so that it compares to other characters like any
+        // digit would), the number of its significant digits written as
+        // a byte count followed by big-endian bytes, then the significant
+        // digits themselves
+        template<typename T>
+        auto natural_key(const T& value)
+            -> std::string
+        {
+            std::string res;
+            auto first = std::begin(value);
+            auto last = std::end(value);
+            while (first != last) {
+                if (not is_natural_digit(*first)) {
+                    res.push_back(*first);
+                    ++first;
+                    continue;
+                }
+
+                while (first != last && *first == '0') {
+                    ++first;
+                }
+                auto digits_begin = first;
+                std::size_t nb_digits = 0;
+                while (first != last && is_natural_digit(*first)) {
+                    ++first;
+                    ++nb_digits;
+                }
+
+                res.push_back('0');
+                unsigned char nb_bytes = 0;
+                for (auto tmp = nb_digits ; tmp != 0 ; tmp >>= CHAR_BIT) {
+                    ++nb_bytes;
+                }
+                res.push_back(static_cast<char>(nb_bytes));
+                for (int byte = nb_bytes - 1 ; byte >= 0 ; --byte) {
+                    res.push_back(static_cast<char>((nb_digits >> (byte * CHAR_BIT)) & UCHAR_MAX));
+                }
+                res.append(digits_begin, first);
+            }
+            return res;
+        }
+
+        struct natural_key_fn:
+            utility::projection_base
+        {
+            template<typename T>
+            auto operator()(const T& value) const
+                -> decltype(detail::natural_key(value))
+            {
+                return detail::natural_key(value);
+            }
+        };
+    }
+
     using natural_less_t = detail::natural_less_fn;
+    using natural_key_t = detail::natural_key_fn;
 
     namespace
     {
         constexpr auto&& natural_less = utility::static_const<
             detail::natural_less_fn
         >::value;
+
+        constexpr auto&& natural_key = utility::static_const<
+            detail::natural_key_fn
+        >::value;
     }
 }
 
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_APPLY_PERMUTATION_H_
+#define CPPSORT_DETAIL_APPLY_PERMUTATION_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/utility/iter_move.h>
+#include "config.h"
+#include "iterator_traits.h"
+#include "memory.h"
+#include "type_traits.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    //
+    // The functions below reorder [first, first + size) so that the
+    // element at position pos is the one that was at the position
+    // described by sources[pos] beforehand, where sources is either
+    // an array of integer indices or an array of iterators into the
+    // range; sources is left in an unspecified state afterwards
+    //
+
+    template<
+        typename RandomAccessIterator,
+        typename Source,
+        bool = std::is_integral<Source>::value
+    >
+    struct permutation_source
+    {
+        using difference_type = difference_type_t<RandomAccessIterator>;
+
+        static auto position(RandomAccessIterator, Source source)
+            -> difference_type
+        {
+            return source;
+        }
+
+        static auto make(RandomAccessIterator, difference_type pos)
+            -> Source
+        {
+            Source res = pos;
+            return res;
+        }
+    };
+
+    template<typename RandomAccessIterator, typename Source>
+    struct permutation_source<RandomAccessIterator, Source, false>
+    {
+        using difference_type = difference_type_t<RandomAccessIterator>;
+
+        static auto position(RandomAccessIterator first, Source source)
+            -> difference_type
+        {
+            return source - first;
+        }
+
+        static auto make(RandomAccessIterator first, difference_type pos)
+            -> Source
+        {
+            return first + pos;
+        }
+    };
+
+    // Elements can only be prefetched when they have an address
+    template<typename RandomAccessIterator>
+    auto prefetch_element(RandomAccessIterator it)
+        -> std::enable_if_t<std::is_lvalue_reference<reference_t<RandomAccessIterator>>::value>
+    {
+        CPPSORT_PREFETCH(std::addressof(*it));
+    }
+
+    template<typename RandomAccessIterator>
+    auto prefetch_element(RandomAccessIterator)
+        -> std::enable_if_t<not std::is_lvalue_reference<reference_t<RandomAccessIterator>>::value>
+    {}
+
+    ////////////////////////////////////////////////////////////
+    // In-place algorithm
+
+    // Walks the cycles of the permutation and moves every element
+    // directly to its final position. It requires no extra memory
+    // but every step depends on the previous one, which makes it
+    // bound by the latency of the memory accesses: the source of
+    // the next step is read one step ahead so that the element and
+    // the source it will need can be prefetched meanwhile
+    template<typename RandomAccessIterator, typename Source>
+    auto apply_permutation_cycles(RandomAccessIterator first,
+                                  difference_type_t<RandomAccessIterator> size,
+                                  Source* sources)
+        -> void
+    {
+        using utility::iter_move;
+        using difference_type = difference_type_t<RandomAccessIterator>;
+        using source = permutation_source<RandomAccessIterator, Source>;
+
+        // Positions whose element is in place are marked as such
+        for (difference_type start = 0 ; start != size ; ++start) {
+            difference_type next = source::position(first, sources[start]);
+            if (next == start) continue;
+
+            auto tmp = iter_move(first + start);
+            difference_type current = start;
+            while (next != start) {
+                difference_type after = source::position(first, sources[next]);
+                prefetch_element(first + after);
+                CPPSORT_PREFETCH(sources + after);
+
+                first[current] = iter_move(first + next);
+                sources[current] = source::make(first, current);
+                current = next;
+                next = after;
+            }
+            first[current] = std::move(tmp);
+            sources[current] = source::make(first, current);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Buffered algorithm
+
+    // Gathers the elements in sorted order in a buffer, then moves
+    // them back: the reads are independent from each other, which
+    // allows the processor to perform many of them at once, and the
+    // writes are sequential. Returns false without doing anything
+    // when there is not enough memory for the buffer
+    template<typename RandomAccessIterator, typename Source>
+    auto apply_permutation_buffered(RandomAccessIterator first,
+                                    difference_type_t<RandomAccessIterator> size,
+                                    Source* sources)
+        -> bool
+    {
+        using utility::iter_move;
+        using rvalue_type = remove_cvref_t<rvalue_reference_t<RandomAccessIterator>>;
+        using difference_type = difference_type_t<RandomAccessIterator>;
+        using source = permutation_source<RandomAccessIterator, Source>;
+
+        temporary_buffer<rvalue_type> buffer(size);
+        if (buffer.size() < size) {
+            return false;
+        }
+
+        destruct_n<rvalue_type> d(0);
+        std::unique_ptr<rvalue_type, destruct_n<rvalue_type>&> h2(buffer.data(), d);
+
+        auto ptr = buffer.data();
+        for (difference_type pos = 0 ; pos != size ; ++pos) {
+            ::new(ptr) rvalue_type(iter_move(first + source::position(first, sources[pos])));
+            ++d;
+            ++ptr;
+        }
+
+        ptr = buffer.data();
+        for (difference_type pos = 0 ; pos != size ; ++pos) {
+            first[pos] = std::move(*ptr);
+            ++ptr;
+        }
+        return true;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Algorithm selection
+
+    enum {
+        // Elements bigger than that are moved in place: moving them
+        // twice and touching the memory of a big buffer costs more
+        // than the cache misses of walking the cycles
+        max_buffered_permutation_element_size = 64
+    };
+
+    template<typename RandomAccessIterator, typename Source>
+    auto apply_permutation(RandomAccessIterator first,
+                           difference_type_t<RandomAccessIterator> size,
+                           Source* sources)
+        -> void
+    {
+        using rvalue_type = remove_cvref_t<rvalue_reference_t<RandomAccessIterator>>;
+        if (sizeof(rvalue_type) <= max_buffered_permutation_element_size &&
+            apply_permutation_buffered(first, size, sources)) {
+            return;
+        }
+        apply_permutation_cycles(first, size, sources);
+    }
+
+    // Same as apply_permutation, except that the buffer is only used
+    // when moving the elements is equivalent to copying their bytes:
+    // other elements are moved along the cycles, which performs the
+    // fewest move operations, up to (3/2)n
+    template<typename RandomAccessIterator, typename Source>
+    auto apply_permutation_fewest_moves(RandomAccessIterator first,
+                                        difference_type_t<RandomAccessIterator> size,
+                                        Source* sources)
+        -> void
+    {
+        using rvalue_type = remove_cvref_t<rvalue_reference_t<RandomAccessIterator>>;
+        if (std::is_trivially_copyable<rvalue_type>::value) {
+            apply_permutation(first, size, sources);
+        } else {
+            apply_permutation_cycles(first, size, sources);
+        }
+    }
+}}
+
+#endif // CPPSORT_DETAIL_APPLY_PERMUTATION_H_
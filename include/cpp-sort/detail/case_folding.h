@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_CASE_FOLDING_H_
+#define CPPSORT_DETAIL_CASE_FOLDING_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <locale>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "type_traits.h"
+#if defined(__SSE2__) || defined(__AVX2__)
+#   include <immintrin.h>
+#endif
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // ASCII case folding
+
+    constexpr auto ascii_tolower(char value) noexcept
+        -> char
+    {
+        return (value >= 'A' && value <= 'Z') ? static_cast<char>(value - 'A' + 'a') : value;
+    }
+
+    // Compares folded characters the same way std::basic_string does
+    template<typename CharT>
+    auto folded_char_less(CharT lhs, CharT rhs) noexcept
+        -> bool
+    {
+        return std::char_traits<CharT>::lt(lhs, rhs);
+    }
+
+#if defined(__AVX2__)
+    inline auto ascii_tolower(__m256i values) noexcept
+        -> __m256i
+    {
+        // Signed comparisons: the bytes >= 0x80 are never uppercase letters
+        auto is_upper = _mm256_and_si256(
+            _mm256_cmpgt_epi8(values, _mm256_set1_epi8('A' - 1)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), values)
+        );
+        return _mm256_add_epi8(values, _mm256_and_si256(is_upper, _mm256_set1_epi8('a' - 'A')));
+    }
+#endif
+
+#if defined(__SSE2__)
+    inline auto ascii_tolower(__m128i values) noexcept
+        -> __m128i
+    {
+        // Signed comparisons: the bytes >= 0x80 are never uppercase letters
+        auto is_upper = _mm_and_si128(
+            _mm_cmpgt_epi8(values, _mm_set1_epi8('A' - 1)),
+            _mm_cmplt_epi8(values, _mm_set1_epi8('Z' + 1))
+        );
+        return _mm_add_epi8(values, _mm_and_si128(is_upper, _mm_set1_epi8('a' - 'A')));
+    }
+#endif
+
+    // Case-insensitive comparison of contiguous sequences of chars with
+    // the folding of the classic locale, the common prefix of both
+    // sequences is skipped several chars at a time when possible
+    inline auto ascii_case_insensitive_less(const char* lhs, std::size_t lhs_size,
+                                            const char* rhs, std::size_t rhs_size) noexcept
+        -> bool
+    {
+        std::size_t size = std::min(lhs_size, rhs_size);
+        std::size_t pos = 0;
+
+#if defined(__AVX2__)
+        while (pos + 32 <= size) {
+            auto lhs_block = ascii_tolower(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + pos)));
+            auto rhs_block = ascii_tolower(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + pos)));
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(lhs_block, rhs_block)) != -1) {
+                // The mismatch is found by the scalar loop below
+                break;
+            }
+            pos += 32;
+        }
+#endif
+
+#if defined(__SSE2__)
+        while (pos + 16 <= size) {
+            auto lhs_block = ascii_tolower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + pos)));
+            auto rhs_block = ascii_tolower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + pos)));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(lhs_block, rhs_block)) != 0xFFFF) {
+                break;
+            }
+            pos += 16;
+        }
+#endif
+
+        for (; pos < size ; ++pos) {
+            char lhs_char = ascii_tolower(lhs[pos]);
+            char rhs_char = ascii_tolower(rhs[pos]);
+            if (lhs_char != rhs_char) {
+                return folded_char_less(lhs_char, rhs_char);
+            }
+        }
+        return lhs_size < rhs_size;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Locale-aware case folding
+
+    // Contiguous sequences of chars, such as std::string, can be
+    // compared with the vectorized algorithm above
+    template<typename T>
+    using contiguous_chars_t = std::enable_if_t<
+        std::is_same<decltype(std::declval<const T&>().data()), const char*>::value,
+        decltype(std::declval<const T&>().size())
+    >;
+
+    template<typename T>
+    using is_contiguous_chars = is_detected<contiguous_chars_t, T>;
+
+    template<typename CharT, typename Folder, typename T>
+    auto folded_lexicographical_less(const Folder& folder, const T& lhs, const T& rhs)
+        -> bool
+    {
+        return std::lexicographical_compare(
+            std::begin(lhs), std::end(lhs),
+            std::begin(rhs), std::end(rhs),
+            [&folder](CharT lhs_char, CharT rhs_char) {
+                return folded_char_less(folder.fold(lhs_char), folder.fold(rhs_char));
+            }
+        );
+    }
+
+    // Lowers the case of characters with the std::ctype facet of a
+    // given locale, the facet has to outlive the case_folder
+    template<typename CharT>
+    class case_folder
+    {
+        public:
+
+            explicit case_folder(const std::locale& loc):
+                ct(&std::use_facet<std::ctype<CharT>>(loc))
+            {}
+
+            auto fold(CharT value) const
+                -> CharT
+            {
+                return ct->tolower(value);
+            }
+
+            template<typename T>
+            auto less(const T& lhs, const T& rhs) const
+                -> bool
+            {
+                return folded_lexicographical_less<CharT>(*this, lhs, rhs);
+            }
+
+        private:
+
+            const std::ctype<CharT>* ct;
+    };
+
+    // The folding of a char only depends on its value, so it is read
+    // once for every possible char when the case_folder is created and
+    // subsequent foldings don't call the facet anymore
+    template<>
+    class case_folder<char>
+    {
+        public:
+
+            explicit case_folder(const std::locale& loc)
+            {
+                for (int i = 0 ; i < table_size ; ++i) {
+                    table[i] = static_cast<char>(i);
+                }
+                std::use_facet<std::ctype<char>>(loc).tolower(table, table + table_size);
+
+                is_ascii = true;
+                for (int i = 0 ; i < table_size ; ++i) {
+                    if (table[i] != ascii_tolower(static_cast<char>(i))) {
+                        is_ascii = false;
+                        break;
+                    }
+                }
+            }
+
+            auto fold(char value) const
+                -> char
+            {
+                return table[static_cast<unsigned char>(value)];
+            }
+
+            template<typename T>
+            auto less(const T& lhs, const T& rhs) const
+                -> bool
+            {
+                return less(lhs, rhs, is_contiguous_chars<T>{});
+            }
+
+        private:
+
+            template<typename T>
+            auto less(const T& lhs, const T& rhs, std::true_type) const
+                -> bool
+            {
+                if (is_ascii) {
+                    return ascii_case_insensitive_less(lhs.data(), lhs.size(),
+                                                       rhs.data(), rhs.size());
+                }
+                return folded_lexicographical_less<char>(*this, lhs, rhs);
+            }
+
+            template<typename T>
+            auto less(const T& lhs, const T& rhs, std::false_type) const
+                -> bool
+            {
+                return folded_lexicographical_less<char>(*this, lhs, rhs);
+            }
+
+            static constexpr int table_size = 1 << std::numeric_limits<unsigned char>::digits;
+            char table[table_size];
+            // Whether the locale folds chars like the classic one
+            bool is_ascii;
+    };
+
+    // Case folder for the last locale used by the current thread, it
+    // avoids looking for the facet again whenever the same locale is
+    // used for several comparisons in a row
+    template<typename CharT>
+    auto cached_case_folder(const std::locale& loc)
+        -> const case_folder<CharT>&
+    {
+        struct cache_type
+        {
+            std::locale loc;
+            case_folder<CharT> folder;
+        };
+        thread_local cache_type cache = { loc, case_folder<CharT>(loc) };
+
+        if (not (cache.loc == loc)) {
+            cache.folder = case_folder<CharT>(loc);
+            cache.loc = loc;
+        }
+        return cache.folder;
+    }
+
+    // Copy of a sequence of characters whose case was lowered, two
+    // folded strings compare like case_insensitive_less compares the
+    // original sequences
+    template<typename T>
+    auto case_fold(const T& value, const std::locale& loc)
+        -> std::basic_string<remove_cvref_t<decltype(*std::begin(value))>>
+    {
+        using char_type = remove_cvref_t<decltype(*std::begin(value))>;
+        const auto& folder = cached_case_folder<char_type>(loc);
+
+        std::basic_string<char_type> res(std::begin(value), std::end(value));
+        for (auto& character: res) {
+            character = folder.fold(character);
+        }
+        return res;
+    }
+}}
+
+#endif // CPPSORT_DETAIL_CASE_FOLDING_H_
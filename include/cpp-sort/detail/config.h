@@ -61,6 +61,18 @@
 #   define CPPSORT_UNREACHABLE
 #endif
 
+////////////////////////////////////////////////////////////
+// CPPSORT_PREFETCH
+
+// Hints that the memory at the given address will be read soon,
+// which allows to start loading it while doing something else
+
+#if defined(__GNUC__) || defined(__clang__)
+#   define CPPSORT_PREFETCH(address) __builtin_prefetch(address)
+#else
+#   define CPPSORT_PREFETCH(address) ((void) (address))
+#endif
+
 ////////////////////////////////////////////////////////////
 // CPPSORT_ASSERT
 
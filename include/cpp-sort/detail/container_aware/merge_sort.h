@@ -8,41 +8,478 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
 #include <forward_list>
 #include <functional>
 #include <iterator>
 #include <list>
+#include <memory>
 #include <type_traits>
 #include <utility>
 #include <cpp-sort/fwd.h>
 #include <cpp-sort/sorter_facade.h>
 #include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/as_function.h>
 #include <cpp-sort/utility/functional.h>
 #include <cpp-sort/utility/size.h>
+#include "../memory.h"
+#include "../merge_sort.h"
 #include "../projection_compare.h"
+#include "../type_traits.h"
 
 namespace cppsort
 {
     namespace detail
     {
+        //
+        // Both algorithms below are bottom-up natural merge sorts: the
+        // list is scanned once from left to right, non-decreasing runs
+        // are kept as is while strictly decreasing runs are reversed by
+        // splicing, and the pending runs are merged with the policy of
+        // TimSort, which keeps their sizes balanced. The runs are merged
+        // in place by splicing nodes within the list, so that neither
+        // midpoints nor allocations are ever needed. Big lists without
+        // long runs are sorted through an array instead, see below
+        //
+
+        enum {
+            // The merge policy guarantees that the sizes of the pending
+            // runs grow at least as fast as the Fibonacci sequence, which
+            // is enough for any size that fits in 64 bits
+            max_pending_list_runs = 96,
+            // Shorter runs are extended with insertion sort
+            min_list_run_size = 16,
+            // Bigger lists are sorted through an array of their nodes
+            min_list_gather_size = 1024,
+            // Lists whose average run is longer than this are not
+            // worth sorting through an array
+            max_list_gather_runs_ratio = 32
+        };
+
+        template<typename Iterator, typename Difference>
+        struct list_run
+        {
+            // First element of the run for std::list, element before
+            // the first one for std::forward_list
+            Iterator it;
+            Difference size;
+        };
+
+        template<typename Run, typename MergeAt>
+        auto list_merge_collapse(Run* runs, int& nb_runs, MergeAt merge_at)
+            -> void
+        {
+            while (nb_runs > 1) {
+                int n = nb_runs - 2;
+                if ((n > 0 && runs[n - 1].size <= runs[n].size + runs[n + 1].size) ||
+                    (n > 1 && runs[n - 2].size <= runs[n - 1].size + runs[n].size)) {
+                    if (runs[n - 1].size < runs[n + 1].size) {
+                        --n;
+                    }
+                } else if (runs[n].size > runs[n + 1].size) {
+                    break;
+                }
+                merge_at(n);
+            }
+        }
+
+        template<typename Run, typename MergeAt>
+        auto list_merge_force_collapse(Run* runs, int& nb_runs, MergeAt merge_at)
+            -> void
+        {
+            while (nb_runs > 1) {
+                int n = nb_runs - 2;
+                if (n > 0 && runs[n - 1].size < runs[n + 1].size) {
+                    --n;
+                }
+                merge_at(n);
+            }
+        }
+
+        template<typename Run>
+        auto list_remove_run(Run* runs, int& nb_runs, int pos)
+            -> void
+        {
+            std::move(runs + pos + 1, runs + nb_runs, runs + pos);
+            --nb_runs;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Sorting big lists through an array
+        //
+        // Comparing the elements of a list means chasing pointers to
+        // nodes scattered in memory: big lists are faster to sort by
+        // gathering the positions of their nodes in an array, sorting
+        // that array, then relinking the nodes in one pass. Small keys
+        // are copied next to the positions so that the sort itself
+        // does not touch the nodes at all
+
+        template<typename Key>
+        using is_cached_list_key = std::integral_constant<bool,
+            std::is_trivially_copyable<Key>::value &&
+            std::is_copy_constructible<Key>::value &&
+            sizeof(Key) <= 2 * sizeof(void*)
+        >;
+
+        template<typename Key>
+        struct cached_list_key
+        {
+            Key key;
+            std::ptrdiff_t index;
+        };
+
+        // Sorts the indices of the nodes in [0, size) and calls relink
+        // with the sorted array, the indices are stored with a copy of
+        // the keys when those are cheap to copy
+        template<typename Iterator, typename Compare, typename Projection, typename Relink>
+        auto list_sort_indices(const Iterator* nodes, std::ptrdiff_t size,
+                               Compare compare, Projection projection, Relink relink,
+                               std::true_type /* cached keys */)
+            -> bool
+        {
+            auto&& proj = utility::as_function(projection);
+            using key_type = remove_cvref_t<decltype(proj(*nodes[0]))>;
+            using record = cached_list_key<key_type>;
+
+            temporary_buffer<record> records(size);
+            if (records.size() < size) {
+                return false;
+            }
+            for (std::ptrdiff_t i = 0 ; i < size ; ++i) {
+                ::new(records.data() + i) record{ proj(*nodes[i]), i };
+            }
+            merge_sort(records.data(), records.data() + size, size,
+                       std::move(compare), &record::key);
+            relink(records.data(), &record::index);
+            return true;
+        }
+
+        template<typename Iterator, typename Compare, typename Projection, typename Relink>
+        auto list_sort_indices(const Iterator* nodes, std::ptrdiff_t size,
+                               Compare compare, Projection projection, Relink relink,
+                               std::false_type /* cached keys */)
+            -> bool
+        {
+            auto&& proj = utility::as_function(projection);
+
+            temporary_buffer<std::ptrdiff_t> indices(size);
+            if (indices.size() < size) {
+                return false;
+            }
+            for (std::ptrdiff_t i = 0 ; i < size ; ++i) {
+                indices.data()[i] = i;
+            }
+            merge_sort(indices.data(), indices.data() + size, size, std::move(compare),
+                       [&proj, nodes](std::ptrdiff_t index) -> decltype(auto) {
+                           return proj(*nodes[index]);
+                       });
+            relink(indices.data(), utility::identity{});
+            return true;
+        }
+
+        template<typename Iterator, typename Compare, typename Projection, typename Relink>
+        auto list_sort_indices(const Iterator* nodes, std::ptrdiff_t size,
+                               Compare compare, Projection projection, Relink relink)
+            -> bool
+        {
+            using key_type = remove_cvref_t<decltype(utility::as_function(projection)(*nodes[0]))>;
+            return list_sort_indices(nodes, size, std::move(compare), std::move(projection),
+                                     std::move(relink), is_cached_list_key<key_type>{});
+        }
+
+        // Number of runs found by the natural merge sort, without
+        // extending the short ones
+        template<typename Iterator, typename Compare>
+        auto list_count_runs(Iterator first, std::ptrdiff_t size, Compare compare)
+            -> std::ptrdiff_t
+        {
+            enum { new_run, ascending_run, descending_run } run = new_run;
+            std::ptrdiff_t nb_runs = 1;
+            for (std::ptrdiff_t i = 1 ; i < size ; ++i) {
+                auto prev = first;
+                ++first;
+                switch (run) {
+                    case new_run:
+                        run = compare(*first, *prev) ? descending_run : ascending_run;
+                        break;
+                    case ascending_run:
+                        if (compare(*first, *prev)) {
+                            ++nb_runs;
+                            run = new_run;
+                        }
+                        break;
+                    case descending_run:
+                        if (not compare(*first, *prev)) {
+                            ++nb_runs;
+                            run = new_run;
+                        }
+                        break;
+                }
+            }
+            return nb_runs;
+        }
+
+        // Gathers the iterators to the nodes of a list, returns an
+        // empty buffer when the memory could not be allocated
+        template<typename Iterator>
+        auto list_gather_nodes(Iterator first, std::ptrdiff_t size)
+            -> temporary_buffer<Iterator>
+        {
+            temporary_buffer<Iterator> nodes(size);
+            if (nodes.size() < size) {
+                return nullptr;
+            }
+            for (std::ptrdiff_t i = 0 ; i < size ; ++i) {
+                ::new(nodes.data() + i) Iterator(first);
+                ++first;
+            }
+            return nodes;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // std::list
+
+        // Merges the adjacent runs [first1, first2) and [first2, last),
+        // returns the new first element of the merged run
+        template<typename List, typename Compare>
+        auto list_merge_runs(List& collection, typename List::iterator first1,
+                             typename List::iterator first2, typename List::iterator last,
+                             Compare compare)
+            -> typename List::iterator
+        {
+            if (not compare(*first2, *std::prev(first2))) {
+                return first1;
+            }
+
+            auto res = first1;
+            while (first1 != first2 && first2 != last) {
+                if (compare(*first2, *first1)) {
+                    // Move the whole sequence of right elements that
+                    // are smaller than the current left element
+                    auto run_end = std::next(first2);
+                    while (run_end != last && compare(*run_end, *first1)) {
+                        ++run_end;
+                    }
+                    if (first1 == res) {
+                        res = first2;
+                    }
+                    collection.splice(first1, collection, first2, run_end);
+                    first2 = run_end;
+                }
+                // When right elements were moved, the current left element
+                // is known to go before the one that stopped the search
+                ++first1;
+            }
+            return res;
+        }
+
+        template<typename Compare, typename Projection, typename... Args>
+        auto list_gather_sort(std::list<Args...>& collection,
+                              Compare compare, Projection projection)
+            -> bool
+        {
+            using iterator = typename std::list<Args...>::iterator;
+
+            auto size = static_cast<std::ptrdiff_t>(collection.size());
+            // Lists with long runs are faster to sort in place
+            auto nb_runs = list_count_runs(collection.begin(), size,
+                                           make_projection_compare(compare, projection));
+            if (nb_runs <= size / max_list_gather_runs_ratio) {
+                return false;
+            }
+            auto nodes = list_gather_nodes(collection.begin(), size);
+            if (nodes.size() < size) {
+                return false;
+            }
+            destruct_n<iterator> d(size);
+            std::unique_ptr<iterator, destruct_n<iterator>&> h2(nodes.data(), d);
+
+            // Splicing every node to the end of the list in sorted
+            // order leaves the list sorted
+            auto relink = [&collection, &nodes, size](auto* sorted, auto index_of) {
+                auto&& index = utility::as_function(index_of);
+                for (std::ptrdiff_t i = 0 ; i < size ; ++i) {
+                    collection.splice(collection.end(), collection,
+                                      nodes.data()[index(sorted[i])]);
+                }
+            };
+            return list_sort_indices<iterator>(nodes.data(), size,
+                                               std::move(compare), std::move(projection),
+                                               relink);
+        }
+
         template<typename Compare, typename Projection, typename... Args>
         auto list_merge_sort(std::list<Args...>& collection,
                              Compare compare, Projection projection)
             -> void
         {
+            using list_type = std::list<Args...>;
+            using iterator = typename list_type::iterator;
+            using difference_type = typename list_type::difference_type;
+            using run_type = list_run<iterator, difference_type>;
+
             if (collection.size() < 2) return;
+            if (collection.size() >= min_list_gather_size &&
+                list_gather_sort(collection, compare, projection)) {
+                return;
+            }
+            auto comp = make_projection_compare(std::move(compare), std::move(projection));
 
-            // Extract left part
-            auto first = collection.begin();
-            auto middle = std::next(first, collection.size() / 2);
-            std::list<Args...> left(collection.get_allocator());
-            left.splice(left.begin(), collection, first, middle);
+            run_type runs[max_pending_list_runs];
+            int nb_runs = 0;
+            auto last = collection.end();
 
-            // Recursively sort, then merge
-            list_merge_sort(left, compare, projection);
-            list_merge_sort(collection, compare, projection);
-            collection.merge(std::move(left), make_projection_compare(std::move(compare),
-                                                                      std::move(projection)));
+            // Beginning of the part of the list not scanned yet
+            auto current = collection.begin();
+
+            auto merge_at = [&](int n) {
+                auto end = n + 2 < nb_runs ? runs[n + 2].it : current;
+                runs[n].it = list_merge_runs(collection, runs[n].it, runs[n + 1].it, end, comp);
+                runs[n].size += runs[n + 1].size;
+                list_remove_run(runs, nb_runs, n + 1);
+            };
+
+            while (current != last) {
+                // Find the next run
+                auto head = current;
+                auto next = std::next(current);
+                difference_type size = 1;
+                if (next != last && comp(*next, *head)) {
+                    // Reverse a strictly decreasing run on the fly
+                    do {
+                        auto after = std::next(next);
+                        collection.splice(head, collection, next);
+                        head = next;
+                        next = after;
+                        ++size;
+                    } while (next != last && comp(*next, *head));
+                } else {
+                    auto prev = current;
+                    while (next != last && not comp(*next, *prev)) {
+                        prev = next;
+                        ++next;
+                        ++size;
+                    }
+                }
+                while (size < min_list_run_size && next != last) {
+                    auto after = std::next(next);
+                    auto pos = next;
+                    while (pos != head && comp(*next, *std::prev(pos))) {
+                        --pos;
+                    }
+                    if (pos != next) {
+                        collection.splice(pos, collection, next);
+                        if (pos == head) {
+                            head = next;
+                        }
+                    }
+                    next = after;
+                    ++size;
+                }
+                current = next;
+
+                runs[nb_runs++] = { head, size };
+                list_merge_collapse(runs, nb_runs, merge_at);
+            }
+            list_merge_force_collapse(runs, nb_runs, merge_at);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // std::forward_list
+
+        // Merges the size1 elements after before1 with the size2 elements
+        // after before2, which is the last element of the first run, and
+        // returns the last element of the merged run; last2 is the last
+        // element of the second run
+        template<typename ForwardList, typename Compare, typename Difference>
+        auto flist_merge_runs(ForwardList& collection,
+                              typename ForwardList::iterator before1, Difference size1,
+                              typename ForwardList::iterator before2, Difference size2,
+                              typename ForwardList::iterator last2, Compare compare)
+            -> typename ForwardList::iterator
+        {
+            if (not compare(*std::next(before2), *before2)) {
+                return last2;
+            }
+
+            auto prev = before1;
+            while (size1 > 0 && size2 > 0) {
+                auto right = std::next(before2);
+                if (compare(*right, *std::next(prev))) {
+                    collection.splice_after(prev, collection, before2);
+                    prev = right;
+                    --size2;
+                } else {
+                    ++prev;
+                    --size1;
+                }
+            }
+            // The remaining left elements end with before2
+            return size2 == 0 ? before2 : last2;
+        }
+
+        template<typename Compare, typename Projection, typename... Args>
+        auto flist_gather_sort(std::forward_list<Args...>& collection, std::ptrdiff_t size,
+                               Compare compare, Projection projection)
+            -> bool
+        {
+            using iterator = typename std::forward_list<Args...>::iterator;
+
+            // Lists with long runs are faster to sort in place
+            auto nb_runs = list_count_runs(collection.begin(), size,
+                                           make_projection_compare(compare, projection));
+            if (nb_runs <= size / max_list_gather_runs_ratio) {
+                return false;
+            }
+            auto nodes = list_gather_nodes(collection.begin(), size);
+            if (nodes.size() < size) {
+                return false;
+            }
+            destruct_n<iterator> d(size);
+            std::unique_ptr<iterator, destruct_n<iterator>&> h2(nodes.data(), d);
+
+            // The nodes that were not relinked yet form a doubly linked
+            // list of indices, which gives the node before every one of
+            // them in the forward_list
+            struct links_type
+            {
+                std::ptrdiff_t prev;
+                std::ptrdiff_t next;
+            };
+            temporary_buffer<links_type> links(size);
+            if (links.size() < size) {
+                return false;
+            }
+            for (std::ptrdiff_t i = 0 ; i < size ; ++i) {
+                ::new(links.data() + i) links_type{ i - 1, i + 1 < size ? i + 1 : -1 };
+            }
+
+            // The sorted nodes are moved one after the other right after
+            // the last sorted node, the first node that was not moved yet
+            // is always right after it
+            auto relink = [&collection, &nodes, &links, size](auto* sorted, auto index_of) {
+                auto&& index = utility::as_function(index_of);
+                auto node = nodes.data();
+                auto link = links.data();
+                auto tail = collection.before_begin();
+                for (std::ptrdiff_t i = 0 ; i < size ; ++i) {
+                    auto pos = index(sorted[i]);
+                    auto prev = link[pos].prev;
+                    auto next = link[pos].next;
+                    if (prev != -1) {
+                        collection.splice_after(tail, collection, node[prev]);
+                        link[prev].next = next;
+                    }
+                    if (next != -1) {
+                        link[next].prev = prev;
+                    }
+                    tail = node[pos];
+                }
+            };
+            return list_sort_indices<iterator>(nodes.data(), size,
+                                               std::move(compare), std::move(projection),
+                                               relink);
         }
 
         template<typename Compare, typename Projection,
@@ -51,19 +488,74 @@ namespace cppsort
                               Compare compare, Projection projection)
             -> void
         {
+            using list_type = std::forward_list<Args...>;
+            using iterator = typename list_type::iterator;
+            using difference_type = typename list_type::difference_type;
+            using run_type = list_run<iterator, difference_type>;
+
             if (size < 2) return;
+            if (size >= min_list_gather_size &&
+                flist_gather_sort(collection, size, compare, projection)) {
+                return;
+            }
+            auto comp = make_projection_compare(std::move(compare), std::move(projection));
+
+            run_type runs[max_pending_list_runs];
+            int nb_runs = 0;
+            auto last = collection.end();
+
+            // Last element of the part of the list already scanned
+            auto current = collection.before_begin();
+
+            auto merge_at = [&](int n) {
+                auto& last2 = n + 2 < nb_runs ? runs[n + 2].it : current;
+                last2 = flist_merge_runs(collection, runs[n].it, runs[n].size,
+                                         runs[n + 1].it, runs[n + 1].size,
+                                         last2, comp);
+                runs[n].size += runs[n + 1].size;
+                list_remove_run(runs, nb_runs, n + 1);
+            };
+
+            while (std::next(current) != last) {
+                // Find the next run
+                auto before = current;
+                auto tail = std::next(before);
+                auto next = std::next(tail);
+                difference_type run_size = 1;
+                if (next != last && comp(*next, *tail)) {
+                    // Reverse a strictly decreasing run on the fly by
+                    // moving every element to its front
+                    do {
+                        collection.splice_after(before, collection, tail);
+                        next = std::next(tail);
+                        ++run_size;
+                    } while (next != last && comp(*next, *std::next(before)));
+                } else {
+                    while (next != last && not comp(*next, *tail)) {
+                        tail = next;
+                        ++next;
+                        ++run_size;
+                    }
+                }
+                while (run_size < min_list_run_size && next != last) {
+                    auto pos = before;
+                    while (pos != tail && not comp(*next, *std::next(pos))) {
+                        ++pos;
+                    }
+                    if (pos == tail) {
+                        tail = next;
+                    } else {
+                        collection.splice_after(pos, collection, tail);
+                    }
+                    next = std::next(tail);
+                    ++run_size;
+                }
+                current = tail;
 
-            // Extract left part
-            auto first = collection.before_begin();
-            auto middle = std::next(first, size / 2 + 1);
-            std::forward_list<Args...> left(collection.get_allocator());
-            left.splice_after(left.before_begin(), collection, first, middle);
-
-            // Recursively sort, then merge
-            flist_merge_sort(left, size / 2, compare, projection);
-            flist_merge_sort(collection, size - size / 2, compare, projection);
-            collection.merge(std::move(left), make_projection_compare(std::move(compare),
-                                                                      std::move(projection)));
+                runs[nb_runs++] = { before, run_size };
+                list_merge_collapse(runs, nb_runs, merge_at);
+            }
+            list_merge_force_collapse(runs, nb_runs, merge_at);
         }
     }
 
@@ -8,10 +8,19 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <type_traits>
 #include <utility>
+#include <vector>
 #include <cpp-sort/utility/as_function.h>
 #include <cpp-sort/utility/iter_move.h>
 #include "iterator_traits.h"
+#include "memory.h"
 #include "move.h"
 
 namespace cppsort
@@ -90,6 +99,208 @@ namespace detail
                                                          std::move(compare));
         return inversions;
     }
+
+    ////////////////////////////////////////////////////////////
+    // Inversions in contiguous keys
+
+    // When the projected elements are arithmetic types compared with
+    // std::less<> or std::greater<>, the probes copy them to an array
+    // and count the inversions directly on the keys instead of going
+    // through the iterators: the functions below count the inversions
+    // of such keys in ascending order, keys to compare with
+    // std::greater<> are copied in reverse order beforehand, which
+    // gives the same number of inversions
+
+    // Merges [first1, last1) and [first2, last2) into result and returns
+    // the number of pairs (a, b) where a belongs to the first run, b to
+    // the second one and b < a; it's written so that the compiler can
+    // avoid branches when comparing scalars
+    template<
+        typename ResultType,
+        typename RandomAccessIterator,
+        typename OutputIterator,
+        typename Compare
+    >
+    auto count_inversions_merge_move(RandomAccessIterator first1, RandomAccessIterator last1,
+                                     RandomAccessIterator first2, RandomAccessIterator last2,
+                                     OutputIterator result, Compare compare)
+        -> ResultType
+    {
+        auto&& comp = utility::as_function(compare);
+
+        ResultType inversions = 0;
+        if (first1 != last1 && first2 != last2) {
+            while (true) {
+                auto lhs = *first1;
+                auto rhs = *first2;
+                auto take_rhs = static_cast<ResultType>(comp(rhs, lhs));
+                *result = take_rhs ? std::move(rhs) : std::move(lhs);
+                ++result;
+                inversions += -take_rhs & static_cast<ResultType>(last1 - first1);
+                first1 += 1 - take_rhs;
+                first2 += take_rhs;
+                if (first1 == last1 || first2 == last2) {
+                    break;
+                }
+            }
+        }
+        result = std::move(first1, last1, result);
+        std::move(first2, last2, result);
+        return inversions;
+    }
+
+    template<typename ResultType, typename T>
+    auto count_inversions_keys(T* keys, T* buffer, std::ptrdiff_t size)
+        -> ResultType
+    {
+        // Blocks sorted with insertion sort before the merges
+        constexpr std::ptrdiff_t block_size = 32;
+
+        ResultType inversions = 0;
+        for (std::ptrdiff_t begin = 0 ; begin < size ; begin += block_size) {
+            std::ptrdiff_t end = std::min(begin + block_size, size);
+            for (std::ptrdiff_t i = begin + 1 ; i < end ; ++i) {
+                T tmp = keys[i];
+                std::ptrdiff_t j = i;
+                for (; j > begin && tmp < keys[j - 1] ; --j) {
+                    keys[j] = keys[j - 1];
+                }
+                keys[j] = tmp;
+                inversions += i - j;
+            }
+        }
+
+        // Bottom-up merges, alternating between keys and buffer
+        T* source = keys;
+        T* destination = buffer;
+        for (std::ptrdiff_t width = block_size ; width < size ; width *= 2) {
+            for (std::ptrdiff_t begin = 0 ; begin < size ; begin += 2 * width) {
+                std::ptrdiff_t middle = std::min(begin + width, size);
+                std::ptrdiff_t end = std::min(begin + 2 * width, size);
+                inversions += count_inversions_merge_move<ResultType>(
+                    source + begin, source + middle,
+                    source + middle, source + end,
+                    destination + begin, std::less<>{}
+                );
+            }
+            std::swap(source, destination);
+        }
+
+        // Leave the keys sorted in the original array
+        if (source != keys) {
+            std::copy(source, source + size, keys);
+        }
+        return inversions;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Inversions in integer keys with a small range
+
+    // When the integer keys only span a small range of values, a Fenwick
+    // tree indexed by value counts for every key how many of the previous
+    // keys are greater, with far fewer cache misses than the merges as
+    // long as the tree is small
+
+    template<typename T>
+    using inversions_rank_t = std::make_unsigned_t<T>;
+
+    template<typename T>
+    auto inversions_key_rank(T key, T min)
+        -> std::uint64_t
+    {
+        using rank_type = inversions_rank_t<T>;
+        return static_cast<rank_type>(static_cast<rank_type>(key) - static_cast<rank_type>(min));
+    }
+
+    // Whether a Fenwick tree is preferred to merges for the given size
+    // and difference between the greatest and the smallest key
+    inline auto use_inversions_fenwick_tree(std::ptrdiff_t size, std::uint64_t max_rank)
+        -> bool
+    {
+        return max_rank < static_cast<std::uint64_t>(size) / 2;
+    }
+
+    template<typename ResultType, typename Counter, typename T>
+    auto count_inversions_fenwick(const T* keys, std::ptrdiff_t size,
+                                  T min, std::uint64_t range, Counter* tree)
+        -> ResultType
+    {
+        // range is the number of distinct ranks, and tree an array
+        // of range + 1 zero-initialized counters
+        ResultType inversions = 0;
+        for (std::ptrdiff_t i = 0 ; i < size ; ++i) {
+            std::uint64_t rank = inversions_key_rank(keys[i], min) + 1;
+
+            // Number of previous keys smaller than or equal to the current one
+            std::uint64_t not_greater = 0;
+            for (std::uint64_t pos = rank ; pos > 0 ; pos &= pos - 1) {
+                not_greater += tree[pos];
+            }
+            inversions += static_cast<ResultType>(static_cast<std::uint64_t>(i) - not_greater);
+
+            for (std::uint64_t pos = rank ; pos <= range ; pos += pos & (0 - pos)) {
+                ++tree[pos];
+            }
+        }
+        return inversions;
+    }
+
+    template<typename ResultType, typename T>
+    auto count_inversions_fenwick(const T* keys, std::ptrdiff_t size,
+                                  T min, std::uint64_t range)
+        -> ResultType
+    {
+        if (static_cast<std::uint64_t>(size) <= std::numeric_limits<std::uint32_t>::max()) {
+            std::vector<std::uint32_t, resource_allocator<std::uint32_t>> tree(range + 1);
+            return count_inversions_fenwick<ResultType>(keys, size, min, range, tree.data());
+        }
+        std::vector<std::uint64_t, resource_allocator<std::uint64_t>> tree(range + 1);
+        return count_inversions_fenwick<ResultType>(keys, size, min, range, tree.data());
+    }
+
+    // Uninitialized array of arithmetic keys taken from the current
+    // memory resource
+    template<typename T>
+    auto make_inversions_keys_buffer(std::ptrdiff_t size)
+        -> std::unique_ptr<T, operator_deleter>
+    {
+        return std::unique_ptr<T, operator_deleter>(
+            static_cast<T*>(detail::allocate(size * sizeof(T))),
+            operator_deleter(size * sizeof(T))
+        );
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Sequential algorithms
+
+    // Set of algorithms used by probe::inv, the parallel probe
+    // provides the same functions backed by a thread pool
+
+    struct sequential_inversions_counter
+    {
+        template<typename ResultType, typename T>
+        auto keys(T* keys, T* buffer, std::ptrdiff_t size) const
+            -> ResultType
+        {
+            return count_inversions_keys<ResultType>(keys, buffer, size);
+        }
+
+        template<typename ResultType, typename T>
+        auto bounded_keys(const T* keys, std::ptrdiff_t size, T min, std::uint64_t range) const
+            -> ResultType
+        {
+            return count_inversions_fenwick<ResultType>(keys, size, min, range);
+        }
+
+        template<typename ResultType, typename Iterator, typename Compare>
+        auto iterators(Iterator* iterators, Iterator* buffer,
+                       std::ptrdiff_t size, Compare compare) const
+            -> ResultType
+        {
+            return count_inversions<ResultType>(iterators, iterators + size,
+                                                buffer, std::move(compare));
+        }
+    };
 }}
 
 #endif // CPPSORT_DETAIL_COUNT_INVERSIONS_H_
@@ -9,36 +9,361 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/iter_move.h>
 #include "iterator_traits.h"
+#include "memory.h"
+#include "merge_sort.h"
 #include "minmax_element_and_is_sorted.h"
+#include "ska_sort.h"
+#include "type_traits.h"
 
 namespace cppsort
 {
 namespace detail
 {
-    template<typename ForwardIterator>
-    auto counting_sort(ForwardIterator first, ForwardIterator last)
-        -> void
+    // Keys that a counting sort can handle: integers and enumerations,
+    // which are counted by their underlying type
+    template<typename T>
+    using is_counting_key = disjunction<is_integral<T>, std::is_enum<T>>;
+
+    namespace counting_sort_detail
     {
-        auto info = minmax_element_and_is_sorted(first, last);
-        if (info.is_sorted) return;
+        enum {
+            // The occurrences of the values are counted in an array
+            // indexed by the values as long as the range of values
+            // is smaller than the biggest of these limits, otherwise
+            // they are counted in a hash table, or radix sorted
+            min_dense_range = 1 << 16,
+            max_dense_range_ratio = 4
+        };
 
-        using difference_type = difference_type_t<ForwardIterator>;
-        auto min = *info.min;
-        auto max = *info.max;
-        std::vector<difference_type> counts(max - min + 1, 0);
+        // Unsigned type able to hold the distance between any two
+        // values of type Integer
+        template<typename Integer>
+        using unsigned_value_t = make_unsigned_t<std::conditional_t<
+            std::is_same<Integer, bool>::value, unsigned char, Integer
+        >>;
 
-        for (auto it = first ; it != last ; ++it)
+        template<typename Integer>
+        constexpr auto to_unsigned(Integer value) noexcept
+            -> unsigned_value_t<Integer>
         {
-            ++counts[*it - min];
+            return static_cast<unsigned_value_t<Integer>>(value);
         }
 
-        for (auto count: counts)
+        // Distance between the two values, it doesn't overflow
+        // even when the values have opposite signs
+        template<typename Integer>
+        constexpr auto value_range(Integer min, Integer max) noexcept
+            -> unsigned_value_t<Integer>
         {
-            first = std::fill_n(first, count, min++);
+            return static_cast<unsigned_value_t<Integer>>(to_unsigned(max) - to_unsigned(min));
         }
+
+        template<typename Key, bool = std::is_enum<Key>::value>
+        struct counting_key
+        {
+            using type = Key;
+        };
+
+        template<typename Key>
+        struct counting_key<Key, true>
+        {
+            using type = std::underlying_type_t<Key>;
+        };
+
+        template<typename Key>
+        using counting_key_t = typename counting_key<Key>::type;
+
+        template<typename Key>
+        constexpr auto to_counting_key(Key key, std::false_type) noexcept
+            -> Key
+        {
+            return key;
+        }
+
+        template<typename Key>
+        constexpr auto to_counting_key(Key key, std::true_type) noexcept
+            -> std::underlying_type_t<Key>
+        {
+            return static_cast<std::underlying_type_t<Key>>(key);
+        }
+
+        template<typename Key>
+        constexpr auto to_counting_key(Key key) noexcept
+            -> counting_key_t<Key>
+        {
+            return to_counting_key(key, std::is_enum<Key>{});
+        }
+
+        template<typename Unsigned, typename Difference>
+        auto is_dense_range(Unsigned range, Difference size) noexcept
+            -> bool
+        {
+            auto limit = std::max<std::uintmax_t>(
+                min_dense_range,
+                static_cast<std::uintmax_t>(size) * max_dense_range_ratio
+            );
+            return range < limit;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Hash table of the occurrences of sparse values
+
+        template<typename Unsigned>
+        constexpr auto fold_to_64(Unsigned value) noexcept
+            -> std::uint64_t
+        {
+            return static_cast<std::uint64_t>(value);
+        }
+
+#ifdef __SIZEOF_INT128__
+        constexpr auto fold_to_64(__uint128_t value) noexcept
+            -> std::uint64_t
+        {
+            return static_cast<std::uint64_t>(value) ^ static_cast<std::uint64_t>(value >> 64);
+        }
+#endif
+
+        // Open addressing table with linear probing mapping the offsets
+        // of the values from the smallest one to their number of
+        // occurrences, a slot whose count is 0 is empty
+        template<typename Unsigned, typename Count>
+        class sparse_histogram
+        {
+            public:
+
+                using entry_type = std::pair<Unsigned, Count>;
+
+                explicit sparse_histogram(std::size_t expected_keys)
+                {
+                    std::size_t capacity = 16;
+                    while (capacity / 2 < expected_keys) {
+                        capacity *= 2;
+                    }
+                    reset(capacity);
+                }
+
+                auto add(Unsigned key, Count count=1)
+                    -> void
+                {
+                    std::size_t mask = entries.size() - 1;
+                    for (std::size_t pos = hash(key) ;; pos = (pos + 1) & mask) {
+                        auto& entry = entries[pos];
+                        if (entry.second == 0) {
+                            entry.first = key;
+                            entry.second = count;
+                            if (++nb_keys > entries.size() / 2) {
+                                grow();
+                            }
+                            return;
+                        }
+                        if (entry.first == key) {
+                            entry.second += count;
+                            return;
+                        }
+                    }
+                }
+
+                // Distinct keys and their number of occurrences sorted
+                // by key, the histogram is left empty
+                auto sorted_entries()
+                    -> std::vector<entry_type, resource_allocator<entry_type>>
+                {
+                    auto res = std::move(entries);
+                    res.erase(
+                        std::remove_if(res.begin(), res.end(), [](const entry_type& entry) {
+                            return entry.second == 0;
+                        }),
+                        res.end()
+                    );
+                    ska_sort(res.begin(), res.end(), [](const entry_type& entry) {
+                        return entry.first;
+                    });
+                    reset(16);
+                    return res;
+                }
+
+            private:
+
+                auto hash(Unsigned key) const noexcept
+                    -> std::uint64_t
+                {
+                    // Fibonacci hashing, the most significant bits of
+                    // the product are the best mixed ones
+                    std::uint64_t mixed = fold_to_64(key) * UINT64_C(0x9E3779B97F4A7C15);
+                    return mixed >> shift;
+                }
+
+                auto reset(std::size_t capacity)
+                    -> void
+                {
+                    entries.assign(capacity, entry_type(Unsigned(0), Count(0)));
+                    nb_keys = 0;
+                    shift = 64;
+                    for (; capacity > 1 ; capacity /= 2) {
+                        --shift;
+                    }
+                }
+
+                auto grow()
+                    -> void
+                {
+                    auto old_entries = std::move(entries);
+                    reset(old_entries.size() * 2);
+                    for (const auto& entry: old_entries) {
+                        if (entry.second != 0) {
+                            add(entry.first, entry.second);
+                        }
+                    }
+                }
+
+                std::vector<entry_type, resource_allocator<entry_type>> entries;
+                std::size_t nb_keys = 0;
+                int shift = 64;
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Sequential algorithms
+
+        // Counts the values in an array covering [min, min + range]
+        template<bool Reverse, typename ForwardIterator, typename T>
+        auto dense_counting_sort(ForwardIterator first, ForwardIterator last,
+                                 T min, unsigned_value_t<T> range)
+            -> void
+        {
+            using difference_type = difference_type_t<ForwardIterator>;
+            std::vector<difference_type, resource_allocator<difference_type>> counts(
+                static_cast<std::size_t>(range) + 1, 0
+            );
+
+            for (auto it = first ; it != last ; ++it) {
+                ++counts[static_cast<std::size_t>(value_range(min, *it))];
+            }
+
+            if (Reverse) {
+                for (std::size_t offset = counts.size() ; offset > 0 ; --offset) {
+                    first = std::fill_n(first, counts[offset - 1],
+                                        static_cast<T>(to_unsigned(min) + (offset - 1)));
+                }
+            } else {
+                for (std::size_t offset = 0 ; offset < counts.size() ; ++offset) {
+                    first = std::fill_n(first, counts[offset],
+                                        static_cast<T>(to_unsigned(min) + offset));
+                }
+            }
+        }
+
+        // Rewrites the collection from the sorted distinct values
+        // and their numbers of occurrences
+        template<bool Reverse, typename ForwardIterator, typename T, typename Entries>
+        auto fill_sparse_values(ForwardIterator first, T min, const Entries& entries)
+            -> ForwardIterator
+        {
+            if (Reverse) {
+                for (auto it = entries.rbegin() ; it != entries.rend() ; ++it) {
+                    first = std::fill_n(first, it->second, static_cast<T>(to_unsigned(min) + it->first));
+                }
+            } else {
+                for (const auto& entry: entries) {
+                    first = std::fill_n(first, entry.second, static_cast<T>(to_unsigned(min) + entry.first));
+                }
+            }
+            return first;
+        }
+
+        // Counts the distinct values in a hash table, then sorts
+        // them before writing them back
+        template<bool Reverse, typename ForwardIterator, typename T>
+        auto sparse_counting_sort(ForwardIterator first, ForwardIterator last,
+                                  T min, difference_type_t<ForwardIterator> size,
+                                  std::forward_iterator_tag)
+            -> void
+        {
+            using difference_type = difference_type_t<ForwardIterator>;
+            sparse_histogram<unsigned_value_t<T>, difference_type> histogram(
+                std::min<std::size_t>(size, 1024)
+            );
+
+            for (auto it = first ; it != last ; ++it) {
+                histogram.add(value_range(min, *it));
+            }
+            fill_sparse_values<Reverse>(first, min, histogram.sorted_entries());
+        }
+
+        // An in-place radix sort is faster than the hash table and
+        // doesn't need any memory when the elements can be swapped
+        template<bool Reverse, typename RandomAccessIterator, typename T>
+        auto sparse_counting_sort(RandomAccessIterator first, RandomAccessIterator last,
+                                  T, difference_type_t<RandomAccessIterator>,
+                                  std::random_access_iterator_tag)
+            -> void
+        {
+            ska_sort(first, last, utility::identity{});
+            if (Reverse) {
+                std::reverse(first, last);
+            }
+        }
+
+        // Turns the number of occurrences of every key into the position
+        // of the first element with that key in the sorted collection
+        template<bool Reverse, typename Counts>
+        auto counts_to_positions(Counts& counts)
+            -> void
+        {
+            typename Counts::value_type position = 0;
+            auto update = [&position](auto& count) {
+                auto tmp = count;
+                count = position;
+                position += tmp;
+            };
+            if (Reverse) {
+                std::for_each(counts.rbegin(), counts.rend(), update);
+            } else {
+                std::for_each(counts.begin(), counts.end(), update);
+            }
+        }
+
+        template<bool Reverse, typename ForwardIterator, typename T>
+        auto counting_sort_impl(ForwardIterator first, ForwardIterator last, T min, T max)
+            -> void
+        {
+            auto range = value_range(min, max);
+            if (is_dense_range(range, 0)) {
+                // Don't compute the size of the collection when the
+                // counts array is small anyway
+                dense_counting_sort<Reverse>(first, last, min, range);
+                return;
+            }
+
+            auto size = std::distance(first, last);
+            if (is_dense_range(range, size)) {
+                dense_counting_sort<Reverse>(first, last, min, range);
+            } else {
+                sparse_counting_sort<Reverse>(first, last, min, size,
+                                              iterator_category_t<ForwardIterator>{});
+            }
+        }
+    }
+
+    template<typename ForwardIterator>
+    auto counting_sort(ForwardIterator first, ForwardIterator last)
+        -> void
+    {
+        auto info = minmax_element_and_is_sorted(first, last);
+        if (info.is_sorted) return;
+
+        counting_sort_detail::counting_sort_impl<false>(first, last, *info.min, *info.max);
     }
 
     template<typename ForwardIterator>
@@ -48,20 +373,76 @@ namespace detail
         auto info = minmax_element_and_is_sorted(first, last, std::greater<>{});
         if (info.is_sorted) return;
 
+        counting_sort_detail::counting_sort_impl<true>(first, last, *info.max, *info.min);
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Key-indexed counting sort
+
+    // Stable counting sort of elements by an integer key: the elements
+    // are scattered to a buffer at the positions computed from the
+    // number of occurrences of every key, then moved back
+    template<bool Reverse, typename ForwardIterator, typename Projection>
+    auto key_indexed_counting_sort(ForwardIterator first, ForwardIterator last,
+                                   Projection projection)
+        -> void
+    {
+        using namespace counting_sort_detail;
+        using utility::iter_move;
         using difference_type = difference_type_t<ForwardIterator>;
-        auto min = *info.max;
-        auto max = *info.min;
-        std::vector<difference_type> counts(max - min + 1, 0);
+        using value_type = remove_cvref_t<rvalue_reference_t<ForwardIterator>>;
+        using key_type = counting_key_t<projected_t<ForwardIterator, Projection>>;
+        using offset_type = unsigned_value_t<key_type>;
+        using compare_type = std::conditional_t<Reverse, std::greater<>, std::less<>>;
+        auto&& proj = utility::as_function(projection);
 
-        for (auto it = first ; it != last ; ++it)
-        {
-            ++counts[*it - min];
+        auto info = minmax_element_and_is_sorted(first, last, compare_type{}, projection);
+        if (info.is_sorted) return;
+
+        auto min = to_counting_key(proj(Reverse ? *info.max : *info.min));
+        auto max = to_counting_key(proj(Reverse ? *info.min : *info.max));
+        auto range = value_range(min, max);
+        auto size = std::distance(first, last);
+
+        // The scatter pass must not throw halfway through
+        constexpr bool can_scatter =
+            std::is_nothrow_move_constructible<value_type>::value &&
+            std::is_nothrow_move_assignable<value_type>::value;
+
+        // Fall back to a stable comparison sort when the keys are too
+        // sparse, or when the elements can't be scattered to a buffer
+        temporary_buffer<value_type> buffer(nullptr);
+        temporary_buffer<offset_type> offsets(nullptr);
+        if (can_scatter && is_dense_range(range, size)) {
+            buffer = temporary_buffer<value_type>(size);
+            offsets = temporary_buffer<offset_type>(size);
+        }
+        if (buffer.size() < size || offsets.size() < size) {
+            merge_sort(std::move(first), std::move(last), size,
+                       compare_type{}, std::move(projection));
+            return;
         }
 
-        for (auto rit = counts.rbegin() ; rit != counts.rend() ; ++rit)
-        {
-            auto count = *rit;
-            first = std::fill_n(first, count, max--);
+        // Count the keys, their offsets from the smallest key are cached
+        // so that every element is projected only once
+        std::vector<difference_type, resource_allocator<difference_type>> counts(
+            static_cast<std::size_t>(range) + 1, 0
+        );
+        offset_type* offset = offsets.data();
+        for (auto it = first ; it != last ; ++it, ++offset) {
+            *offset = value_range(min, to_counting_key(proj(*it)));
+            ++counts[static_cast<std::size_t>(*offset)];
+        }
+        counts_to_positions<Reverse>(counts);
+
+        offset = offsets.data();
+        for (auto it = first ; it != last ; ++it, ++offset) {
+            ::new(buffer.data() + counts[static_cast<std::size_t>(*offset)]++) value_type(iter_move(it));
+        }
+        value_type* ptr = buffer.data();
+        for (auto it = first ; it != last ; ++it, ++ptr) {
+            *it = std::move(*ptr);
+            ptr->~value_type();
         }
     }
 }}
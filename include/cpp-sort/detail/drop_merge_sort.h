@@ -27,6 +27,8 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <type_traits>
 #include <utility>
@@ -34,6 +36,8 @@
 #include <cpp-sort/utility/as_function.h>
 #include <cpp-sort/utility/iter_move.h>
 #include "iterator_traits.h"
+#include "memory.h"
+#include "move.h"
 #include "pdqsort.h"
 #include "type_traits.h"
 
@@ -43,6 +47,164 @@ namespace detail
 {
     constexpr static bool double_comparison = true;
 
+    namespace drop_merge_detail
+    {
+        enum: std::ptrdiff_t
+        {
+            // Number of elements merged one by one before galloping,
+            // a linear scan is faster through short blocks when the
+            // comparisons are cheap
+            min_gallop = 128
+        };
+
+        // Number of elements at the end of [last - size, last) that
+        // satisfy pred, knowing that they form a suffix of that range:
+        // the galloping search starts from the end and takes O(log k)
+        // comparisons and O(k) iterator increments to find k elements
+        template<typename BidirectionalIterator, typename Predicate>
+        auto gallop_suffix(BidirectionalIterator last,
+                           difference_type_t<BidirectionalIterator> size,
+                           Predicate& pred)
+            -> difference_type_t<BidirectionalIterator>
+        {
+            using difference_type = difference_type_t<BidirectionalIterator>;
+
+            // The last found elements satisfy pred
+            difference_type found = 0;
+            auto found_it = last;
+
+            // Exponential search
+            difference_type bound = size + 1;
+            difference_type step = 1;
+            while (found + step <= size) {
+                auto it = std::prev(found_it, step);
+                if (not pred(*it)) {
+                    bound = found + step;
+                    break;
+                }
+                found += step;
+                found_it = it;
+                step *= 2;
+            }
+
+            // Binary search between the last element known to satisfy
+            // pred and the first one known not to
+            while (bound - found > 1) {
+                difference_type half = (bound - found) / 2;
+                auto it = std::prev(found_it, half);
+                if (pred(*it)) {
+                    found += half;
+                    found_it = it;
+                } else {
+                    bound = found + half;
+                }
+            }
+            return found;
+        }
+
+        // Moves the elements at the end of [last - size, last) that
+        // satisfy pred, which form a suffix of that range, right before
+        // result, and updates last, size and result accordingly
+        template<typename BidirectionalIterator, typename OutputIterator, typename Predicate>
+        auto move_suffix_backward(BidirectionalIterator& last,
+                                  difference_type_t<BidirectionalIterator>& size,
+                                  OutputIterator& result, Predicate pred)
+            -> void
+        {
+            using utility::iter_move;
+
+            // Short suffixes are the most common ones, comparing their
+            // elements one by one keeps the branches predictable
+            for (int i = 0 ; i < min_gallop ; ++i) {
+                if (size == 0 || not pred(*std::prev(last))) return;
+                --last;
+                --size;
+                *--result = iter_move(last);
+            }
+
+            // Gallop through long suffixes and move them at once
+            auto count = gallop_suffix(last, size, pred);
+            auto first = std::prev(last, count);
+            result = detail::move_backward(first, last, result);
+            last = first;
+            size -= count;
+        }
+
+        // Merges the sorted dropped elements back into the collection
+        // from the end, write is the end of the sorted kept elements;
+        // long blocks of kept and dropped elements are found with
+        // galloping searches and moved at once. Galloping only pays off
+        // when the blocks can be moved cheaply: it made the sort of
+        // std::string slower, so other types are merged one element at
+        // a time. This function is kept apart from the main loop so
+        // that the code generated for the latter stays tight
+        template<typename BidirectionalIterator, typename Vector,
+                 typename Compare, typename Projection>
+        auto merge_dropped(BidirectionalIterator write,
+                           difference_type_t<BidirectionalIterator> num_kept,
+                           BidirectionalIterator end, Vector& dropped,
+                           Compare& comp, Projection& proj,
+                           std::true_type /* trivially copyable */)
+            -> void
+        {
+            auto back = end;
+            auto dropped_end = dropped.end();
+            auto num_dropped = dropped_end - dropped.begin();
+
+            while (true) {
+                // Kept elements greater than the greatest dropped one
+                auto&& last_dropped = proj(*std::prev(dropped_end));
+                move_suffix_backward(write, num_kept, back, [&](auto&& value) {
+                    return comp(last_dropped, proj(value));
+                });
+
+                if (num_kept == 0) {
+                    detail::move_backward(dropped.begin(), dropped_end, back);
+                    return;
+                }
+
+                // Dropped elements not smaller than the greatest kept one,
+                // there is at least the greatest dropped element
+                auto&& last_kept = proj(*std::prev(write));
+                move_suffix_backward(dropped_end, num_dropped, back, [&](auto&& value) {
+                    return not comp(proj(value), last_kept);
+                });
+
+                if (num_dropped == 0) {
+                    // The remaining kept elements are already in place
+                    return;
+                }
+            }
+        }
+
+        template<typename BidirectionalIterator, typename Vector,
+                 typename Compare, typename Projection>
+        auto merge_dropped(BidirectionalIterator write,
+                           difference_type_t<BidirectionalIterator> num_kept,
+                           BidirectionalIterator end, Vector& dropped,
+                           Compare& comp, Projection& proj,
+                           std::false_type /* trivially copyable */)
+            -> void
+        {
+            using utility::iter_move;
+
+            auto back = end;
+            do {
+                auto& last_dropped = dropped.back();
+
+                while (num_kept > 0 && comp(proj(last_dropped), proj(*std::prev(write)))) {
+                    --back;
+                    --write;
+                    --num_kept;
+                    *back = iter_move(write);
+                }
+                --back;
+                *back = std::move(last_dropped);
+                dropped.pop_back();
+            } while (not dropped.empty());
+        }
+    }
+
     // move-only version
     template<typename BidirectionalIterator, typename Compare, typename Projection>
     auto drop_merge_sort(BidirectionalIterator begin, BidirectionalIterator end,
@@ -59,7 +221,7 @@ namespace detail
 
         using difference_type = difference_type_t<BidirectionalIterator>;
         using rvalue_reference = remove_cvref_t<rvalue_reference_t<BidirectionalIterator>>;
-        std::vector<rvalue_reference> dropped;
+        std::vector<rvalue_reference, resource_allocator<rvalue_reference>> dropped;
 
         difference_type num_dropped_in_row = 0;
         auto write = begin;
@@ -123,20 +285,9 @@ namespace detail
         // Sort the dropped elements
         pdqsort(dropped.begin(), dropped.end(), compare, projection);
 
-        auto back = end;
-
-        do {
-            auto& last_dropped = dropped.back();
-
-            while (begin != write && comp(proj(last_dropped), proj(*std::prev(write)))) {
-                --back;
-                --write;
-                *back = iter_move(write);
-            }
-            --back;
-            *back = std::move(last_dropped);
-            dropped.pop_back();
-        } while (not dropped.empty());
+        drop_merge_detail::merge_dropped(write, size - static_cast<difference_type>(dropped.size()),
+                                         end, dropped, comp, proj,
+                                         std::is_trivially_copyable<rvalue_reference>{});
     }
 }}
 
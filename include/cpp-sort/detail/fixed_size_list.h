@@ -226,7 +226,7 @@ namespace detail
             explicit fixed_size_list(std::ptrdiff_t capacity):
                 // Allocate enough space to store N nodes plus a
                 // sentinel node (where N = capacity)
-                buffer_(static_cast<node_type*>(::operator new((capacity + 1) * sizeof(node_type))),
+                buffer_(static_cast<node_type*>(detail::allocate((capacity + 1) * sizeof(node_type))),
                        operator_deleter((capacity + 1) * sizeof(node_type))),
                 sentinel_node_(buffer_.get() + capacity),
                 first_free_(buffer_.get())
@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_KEY_INDEX_ITERATOR_H_
+#define CPPSORT_DETAIL_KEY_INDEX_ITERATOR_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace cppsort
+{
+namespace detail
+{
+    //
+    // This header contains a proxy iterator over two parallel arrays,
+    // one of keys and one of indices: comparisons only need the keys,
+    // which are stored contiguously, while every move of a key also
+    // moves the matching index in the other array. It allows to sort
+    // keys alongside the original positions of the elements without
+    // interleaving them in memory
+    //
+    // The class key_index_value is the value type of the iterator and
+    // key_index_reference is the proxy returned by operator*; both
+    // expose the key through a data member named key
+    //
+
+    template<typename Key, typename Index>
+    struct key_index_reference;
+
+    template<typename Key, typename Index>
+    struct key_index_value
+    {
+        // Public members
+        Key key;
+        Index index;
+
+        key_index_value(Key&& key, Index index):
+            key(std::move(key)),
+            index(index)
+        {}
+
+        key_index_value(key_index_reference<Key, Index>&& other):
+            key(std::move(other.key)),
+            index(other.index)
+        {}
+
+        key_index_value(const key_index_reference<Key, Index>& other):
+            key(other.key),
+            index(other.index)
+        {}
+
+        key_index_value(const key_index_value&) = default;
+        key_index_value(key_index_value&&) = default;
+        key_index_value& operator=(const key_index_value&) = default;
+        key_index_value& operator=(key_index_value&&) = default;
+
+        // Silence GCC -Winline warning
+        ~key_index_value() noexcept {}
+    };
+
+    template<typename Key, typename Index>
+    struct key_index_reference
+    {
+        // Public members
+        Key& key;
+        Index& index;
+
+        key_index_reference(Key& key, Index& index) noexcept:
+            key(key),
+            index(index)
+        {}
+
+        key_index_reference(const key_index_reference&) = default;
+
+        // Assignments write through to the underlying arrays
+
+        auto operator=(key_index_reference&& other)
+            -> key_index_reference&
+        {
+            key = std::move(other.key);
+            index = other.index;
+            return *this;
+        }
+
+        auto operator=(const key_index_reference& other)
+            -> key_index_reference&
+        {
+            key = other.key;
+            index = other.index;
+            return *this;
+        }
+
+        auto operator=(key_index_value<Key, Index>&& other)
+            -> key_index_reference&
+        {
+            key = std::move(other.key);
+            index = other.index;
+            return *this;
+        }
+
+        auto operator=(const key_index_value<Key, Index>& other)
+            -> key_index_reference&
+        {
+            key = other.key;
+            index = other.index;
+            return *this;
+        }
+    };
+
+    template<typename Key, typename Index>
+    auto swap(key_index_reference<Key, Index> lhs, key_index_reference<Key, Index> rhs)
+        -> void
+    {
+        using std::swap;
+        swap(lhs.key, rhs.key);
+        swap(lhs.index, rhs.index);
+    }
+
+    struct key_getter
+    {
+        template<typename T>
+        constexpr auto operator()(T&& value) const noexcept
+            -> decltype(auto)
+        {
+            // Braces matter here
+            return (std::forward<T>(value).key);
+        }
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Iterator over the parallel arrays
+
+    template<typename Key, typename Index>
+    class key_index_iterator
+    {
+        public:
+
+            ////////////////////////////////////////////////////////////
+            // Public types
+
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type        = key_index_value<Key, Index>;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+            using reference         = key_index_reference<Key, Index>;
+
+            ////////////////////////////////////////////////////////////
+            // Constructors
+
+            key_index_iterator() = default;
+
+            key_index_iterator(Key* keys, Index* indices) noexcept:
+                _keys(keys),
+                _indices(indices)
+            {}
+
+            ////////////////////////////////////////////////////////////
+            // Members access
+
+            auto keys() const noexcept
+                -> Key*
+            {
+                return _keys;
+            }
+
+            auto indices() const noexcept
+                -> Index*
+            {
+                return _indices;
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Element access
+
+            auto operator*() const noexcept
+                -> reference
+            {
+                return { *_keys, *_indices };
+            }
+
+            auto operator[](difference_type pos) const noexcept
+                -> reference
+            {
+                return { _keys[pos], _indices[pos] };
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Increment/decrement operators
+
+            auto operator++() noexcept
+                -> key_index_iterator&
+            {
+                ++_keys;
+                ++_indices;
+                return *this;
+            }
+
+            auto operator++(int) noexcept
+                -> key_index_iterator
+            {
+                auto tmp = *this;
+                operator++();
+                return tmp;
+            }
+
+            auto operator--() noexcept
+                -> key_index_iterator&
+            {
+                --_keys;
+                --_indices;
+                return *this;
+            }
+
+            auto operator--(int) noexcept
+                -> key_index_iterator
+            {
+                auto tmp = *this;
+                operator--();
+                return tmp;
+            }
+
+            auto operator+=(difference_type increment) noexcept
+                -> key_index_iterator&
+            {
+                _keys += increment;
+                _indices += increment;
+                return *this;
+            }
+
+            auto operator-=(difference_type increment) noexcept
+                -> key_index_iterator&
+            {
+                _keys -= increment;
+                _indices -= increment;
+                return *this;
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Comparison operators
+
+            friend auto operator==(const key_index_iterator& lhs, const key_index_iterator& rhs) noexcept
+                -> bool
+            {
+                return lhs._keys == rhs._keys;
+            }
+
+            friend auto operator!=(const key_index_iterator& lhs, const key_index_iterator& rhs) noexcept
+                -> bool
+            {
+                return lhs._keys != rhs._keys;
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Relational operators
+
+            friend auto operator<(const key_index_iterator& lhs, const key_index_iterator& rhs) noexcept
+                -> bool
+            {
+                return lhs._keys < rhs._keys;
+            }
+
+            friend auto operator<=(const key_index_iterator& lhs, const key_index_iterator& rhs) noexcept
+                -> bool
+            {
+                return lhs._keys <= rhs._keys;
+            }
+
+            friend auto operator>(const key_index_iterator& lhs, const key_index_iterator& rhs) noexcept
+                -> bool
+            {
+                return lhs._keys > rhs._keys;
+            }
+
+            friend auto operator>=(const key_index_iterator& lhs, const key_index_iterator& rhs) noexcept
+                -> bool
+            {
+                return lhs._keys >= rhs._keys;
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Arithmetic operators
+
+            friend auto operator+(key_index_iterator it, difference_type size) noexcept
+                -> key_index_iterator
+            {
+                return it += size;
+            }
+
+            friend auto operator+(difference_type size, key_index_iterator it) noexcept
+                -> key_index_iterator
+            {
+                return it += size;
+            }
+
+            friend auto operator-(key_index_iterator it, difference_type size) noexcept
+                -> key_index_iterator
+            {
+                return it -= size;
+            }
+
+            friend auto operator-(const key_index_iterator& lhs, const key_index_iterator& rhs) noexcept
+                -> difference_type
+            {
+                return lhs._keys - rhs._keys;
+            }
+
+            ////////////////////////////////////////////////////////////
+            // iter_move and iter_swap
+
+            friend auto iter_move(const key_index_iterator& it)
+                -> value_type
+            {
+                return { std::move(*it._keys), *it._indices };
+            }
+
+            friend auto iter_swap(key_index_iterator lhs, key_index_iterator rhs)
+                -> void
+            {
+                using std::swap;
+                swap(*lhs._keys, *rhs._keys);
+                swap(*lhs._indices, *rhs._indices);
+            }
+
+        private:
+
+            Key* _keys = nullptr;
+            Index* _indices = nullptr;
+    };
+}}
+
+#endif // CPPSORT_DETAIL_KEY_INDEX_ITERATOR_H_
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2019 Morwenn
+ * Copyright (c) 2016-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
 
@@ -21,6 +21,8 @@
 #include <limits>
 #include <new>
 #include <type_traits>
+#include <utility>
+#include <cpp-sort/utility/memory_resource.h>
 #include "type_traits.h"
 
 namespace cppsort
@@ -28,35 +30,133 @@ namespace cppsort
 namespace detail
 {
     ////////////////////////////////////////////////////////////
-    // Deleter for ::operator new(std::size_t)
+    // Raw memory allocation
 
-    struct operator_deleter
+    // Scratch memory is taken from the memory resource installed for
+    // the current thread with utility::scoped_memory_resource, or from
+    // the global ::operator new when there is none; the resource is
+    // remembered so that memory is given back to the right place even
+    // when the installed resource changes in between
+
+    inline auto allocate_nothrow(utility::memory_resource* resource, std::size_t size) noexcept
+        -> void*
     {
-        operator_deleter() = default;
+        if (resource) {
+            return resource->allocate(size);
+        }
+        return ::operator new(size, std::nothrow);
+    }
 
+    inline auto deallocate(utility::memory_resource* resource, void* pointer, std::size_t size) noexcept
+        -> void
+    {
+        if (resource) {
+            resource->deallocate(pointer, size);
+            return;
+        }
 #ifdef __cpp_sized_deallocation
-        std::size_t size = 0;
+        ::operator delete(pointer, size);
+#else
+        (void)size;
+        ::operator delete(pointer);
+#endif
+    }
+
+    // Throws std::bad_alloc on failure, the allocated memory should
+    // be handed to an operator_deleter constructed with the same size
+    inline auto allocate(std::size_t size)
+        -> void*
+    {
+        auto resource = utility::detail::current_memory_resource();
+        if (not resource) {
+            return ::operator new(size);
+        }
+        void* res = resource->allocate(size);
+        if (not res) {
+            throw std::bad_alloc();
+        }
+        return res;
+    }
 
-        constexpr explicit operator_deleter(std::size_t size) noexcept:
-            size(size)
+    ////////////////////////////////////////////////////////////
+    // Deleter for memory obtained with allocate(std::size_t)
+
+    struct operator_deleter
+    {
+        operator_deleter() = default;
+
+        explicit operator_deleter(std::size_t size) noexcept:
+            size(size),
+            resource(utility::detail::current_memory_resource())
         {}
 
         inline auto operator()(void* pointer) const noexcept
             -> void
         {
-            ::operator delete(pointer, size);
+            deallocate(resource, pointer, size);
         }
-#else
-        constexpr explicit operator_deleter(std::size_t) noexcept {}
 
-        inline auto operator()(void* pointer) const noexcept
+        std::size_t size = 0;
+        utility::memory_resource* resource = nullptr;
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Standard allocator over the current memory resource
+
+    template<typename T>
+    struct resource_allocator
+    {
+        using value_type = T;
+
+        resource_allocator() noexcept:
+            resource(utility::detail::current_memory_resource())
+        {}
+
+        template<typename U>
+        resource_allocator(const resource_allocator<U>& other) noexcept:
+            resource(other.resource)
+        {}
+
+        auto allocate(std::size_t n)
+            -> T*
+        {
+            if (not resource) {
+                return static_cast<T*>(::operator new(n * sizeof(T)));
+            }
+            void* res = resource->allocate(n * sizeof(T), alignof(T));
+            if (not res) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(res);
+        }
+
+        auto deallocate(T* pointer, std::size_t n) noexcept
             -> void
         {
-            ::operator delete(pointer);
+            if (resource) {
+                resource->deallocate(pointer, n * sizeof(T), alignof(T));
+            } else {
+                detail::deallocate(nullptr, pointer, n * sizeof(T));
+            }
         }
-#endif
+
+        utility::memory_resource* resource;
     };
 
+    template<typename T, typename U>
+    auto operator==(const resource_allocator<T>& lhs, const resource_allocator<U>& rhs) noexcept
+        -> bool
+    {
+        return lhs.resource == rhs.resource;
+    }
+
+    template<typename T, typename U>
+    auto operator!=(const resource_allocator<T>& lhs, const resource_allocator<U>& rhs) noexcept
+        -> bool
+    {
+        return lhs.resource != rhs.resource;
+    }
+
     ////////////////////////////////////////////////////////////
     // Deleter for placement new-allocated memory
 
@@ -121,7 +221,8 @@ namespace detail
      * than \a min_size objects.
      */
     template<typename T>
-    auto get_temporary_buffer(std::ptrdiff_t count, std::ptrdiff_t min_count) noexcept
+    auto get_temporary_buffer(std::ptrdiff_t count, std::ptrdiff_t min_count,
+                              utility::memory_resource* resource) noexcept
         -> std::pair<T*, std::ptrdiff_t>
     {
         std::pair<T*, std::ptrdiff_t> res(nullptr, 0);
@@ -135,7 +236,7 @@ namespace detail
         // Try to gradually allocate less memory until we get a valid buffer
         // or until the amount of memory to allocate reaches 0
         while (count > min_count) {
-            res.first = static_cast<T*>(::operator new(count * sizeof(T), std::nothrow));
+            res.first = static_cast<T*>(allocate_nothrow(resource, count * sizeof(T)));
             if (res.first) {
                 res.second = count;
                 break;
@@ -145,16 +246,26 @@ namespace detail
         return res;
     }
 
+    template<typename T>
+    auto get_temporary_buffer(std::ptrdiff_t count, std::ptrdiff_t min_count) noexcept
+        -> std::pair<T*, std::ptrdiff_t>
+    {
+        return get_temporary_buffer<T>(count, min_count, utility::detail::current_memory_resource());
+    }
+
+    template<typename T>
+    auto return_temporary_buffer(T* ptr, std::size_t count,
+                                 utility::memory_resource* resource) noexcept
+        -> void
+    {
+        deallocate(resource, ptr, count * sizeof(T));
+    }
+
     template<typename T>
     auto return_temporary_buffer(T* ptr, std::size_t count) noexcept
         -> void
     {
-#ifdef __cpp_sized_deallocation
-        ::operator delete(ptr, count * sizeof(T));
-#else
-        (void)count;
-        ::operator delete(ptr);
-#endif
+        return_temporary_buffer(ptr, count, utility::detail::current_memory_resource());
     }
 
     ////////////////////////////////////////////////////////////
@@ -179,24 +290,30 @@ namespace detail
 
             temporary_buffer(temporary_buffer&& other) noexcept:
                 buffer(other.buffer),
-                buffer_size(other.buffer_size)
+                buffer_size(other.buffer_size),
+                resource(other.resource)
             {
                 other.buffer = nullptr;
                 other.buffer_size = 0;
             }
 
-            constexpr temporary_buffer(std::nullptr_t) noexcept {}
+            temporary_buffer(std::nullptr_t) noexcept:
+                resource(utility::detail::current_memory_resource())
+            {}
 
-            explicit temporary_buffer(std::ptrdiff_t count) noexcept
+            explicit temporary_buffer(std::ptrdiff_t count) noexcept:
+                resource(utility::detail::current_memory_resource())
             {
-                auto tmp = get_temporary_buffer<T>(count, 0);
+                auto tmp = get_temporary_buffer<T>(count, 0, resource);
                 buffer = tmp.first;
                 buffer_size = tmp.second;
             }
 
             ~temporary_buffer() noexcept
             {
-                return_temporary_buffer<T>(buffer, buffer_size);
+                if (buffer) {
+                    return_temporary_buffer<T>(buffer, buffer_size, resource);
+                }
             }
 
             ////////////////////////////////////////////////////////////
@@ -210,6 +327,7 @@ namespace detail
                 using std::swap;
                 swap(buffer, other.buffer);
                 swap(buffer_size, other.buffer_size);
+                swap(resource, other.resource);
                 return *this;
             }
 
@@ -234,13 +352,15 @@ namespace detail
             auto try_grow(std::ptrdiff_t count) noexcept
                 -> bool
             {
-                auto tmp = get_temporary_buffer<T>(count, buffer_size);
+                auto tmp = get_temporary_buffer<T>(count, buffer_size, resource);
                 if (not tmp.first) {
                     // If it failed to allocate a bigger buffer, keep the old one
                     return false;
                 }
                 // If the allocated buffer is big enough, replace the previous one
-                return_temporary_buffer(buffer, buffer_size);
+                if (buffer) {
+                    return_temporary_buffer(buffer, buffer_size, resource);
+                }
                 buffer = tmp.first;
                 buffer_size = tmp.second;
                 return true;
@@ -250,6 +370,7 @@ namespace detail
 
             T* buffer = nullptr;
             std::ptrdiff_t buffer_size = 0;
+            utility::memory_resource* resource = nullptr;
     };
 }}
 
@@ -321,7 +321,7 @@ namespace detail
         chain.push_back(std::next(first));
 
         // Upper bounds for the insertion of pend elements
-        std::vector<typename list_t::iterator> pend;
+        std::vector<typename list_t::iterator, resource_allocator<typename list_t::iterator>> pend;
         pend.reserve((size + 1) / 2 - 1);
 
         for (auto it = first + 2 ; it != end ; it += 2) {
@@ -399,7 +399,7 @@ namespace detail
 
         using rvalue_reference = remove_cvref_t<rvalue_reference_t<RandomAccessIterator>>;
         std::unique_ptr<rvalue_reference, operator_deleter> cache(
-            static_cast<rvalue_reference*>(::operator new(full_size * sizeof(rvalue_reference))),
+            static_cast<rvalue_reference*>(detail::allocate(full_size * sizeof(rvalue_reference))),
             operator_deleter(full_size * sizeof(rvalue_reference))
         );
         destruct_n<rvalue_reference> d(0);
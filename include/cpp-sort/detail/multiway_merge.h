@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_MULTIWAY_MERGE_H_
+#define CPPSORT_DETAIL_MULTIWAY_MERGE_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/iter_move.h>
+#include "iterator_traits.h"
+#include "lower_bound.h"
+#include "move.h"
+#include "thread_pool.h"
+#include "upper_bound.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    template<typename Iterator>
+    struct merge_run
+    {
+        Iterator current;
+        Iterator end;
+    };
+
+    // Collects the [begin, end) iterators of a collection of iterables
+    template<typename ForwardIterator>
+    auto make_merge_runs(ForwardIterator first, ForwardIterator last)
+    {
+        using iterator = decltype(std::begin(*first));
+        std::vector<merge_run<iterator>> runs;
+        for (; first != last ; ++first) {
+            auto&& range = *first;
+            runs.push_back({ std::begin(range), std::end(range) });
+        }
+        return runs;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Sequential merge
+
+    // Merges the runs with a tournament tree whose internal nodes store
+    // the loser of the match played there: once the winner is written
+    // to the output, only the matches on the path from its leaf to the
+    // root have to be replayed, which takes at most log2(k) comparisons
+    // with k runs. On ties the run that comes first wins, which makes
+    // the merge stable. The elements are moved to the output
+
+    template<typename Iterator, typename OutputIterator,
+             typename Compare, typename Projection>
+    auto loser_tree_merge(std::vector<merge_run<Iterator>>& runs, OutputIterator result,
+                          Compare compare, Projection projection)
+        -> OutputIterator
+    {
+        using utility::iter_move;
+        auto&& comp = utility::as_function(compare);
+        auto&& proj = utility::as_function(projection);
+
+        std::size_t nb_runs = runs.size();
+        if (nb_runs == 0) {
+            return result;
+        }
+        if (nb_runs == 1) {
+            return detail::move(runs[0].current, runs[0].end, result);
+        }
+
+        // Leaves past the last run and exhausted runs lose every match
+        auto beats = [&](std::size_t lhs, std::size_t rhs) {
+            if (rhs >= nb_runs || runs[rhs].current == runs[rhs].end) return true;
+            if (lhs >= nb_runs || runs[lhs].current == runs[lhs].end) return false;
+            if (lhs < rhs) {
+                return not comp(proj(*runs[rhs].current), proj(*runs[lhs].current));
+            }
+            return bool(comp(proj(*runs[lhs].current), proj(*runs[rhs].current)));
+        };
+
+        std::size_t nb_leaves = 1;
+        while (nb_leaves < nb_runs) {
+            nb_leaves *= 2;
+        }
+
+        // Play the initial tournament bottom-up
+        std::vector<std::size_t> losers(nb_leaves);
+        std::size_t winner;
+        {
+            std::vector<std::size_t> winners(2 * nb_leaves);
+            for (std::size_t leaf = 0 ; leaf < nb_leaves ; ++leaf) {
+                winners[nb_leaves + leaf] = leaf;
+            }
+            for (std::size_t node = nb_leaves - 1 ; node > 0 ; --node) {
+                std::size_t lhs = winners[2 * node];
+                std::size_t rhs = winners[2 * node + 1];
+                if (beats(lhs, rhs)) {
+                    winners[node] = lhs;
+                    losers[node] = rhs;
+                } else {
+                    winners[node] = rhs;
+                    losers[node] = lhs;
+                }
+            }
+            winner = winners[1];
+        }
+
+        // Once every run is exhausted, the winner can be any of them or
+        // even one of the leaves past the last run
+        while (winner < nb_runs && runs[winner].current != runs[winner].end) {
+            *result = iter_move(runs[winner].current);
+            ++result;
+            ++runs[winner].current;
+
+            for (std::size_t node = (nb_leaves + winner) / 2 ; node > 0 ; node /= 2) {
+                if (beats(losers[node], winner)) {
+                    std::swap(losers[node], winner);
+                }
+            }
+        }
+        return result;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Multi-sequence selection
+
+    // Finds in every run the number of elements among the first rank
+    // elements of the stable merge of the runs: a pivot is taken in the
+    // middle of the widest interval of candidate split positions, then
+    // the position of every run relative to the pivot narrows down the
+    // intervals of every run according to the rank of the pivot
+
+    template<typename RandomAccessIterator, typename Compare, typename Projection>
+    auto multiway_select(const std::vector<merge_run<RandomAccessIterator>>& runs,
+                         difference_type_t<RandomAccessIterator> rank,
+                         Compare compare, Projection projection)
+        -> std::vector<difference_type_t<RandomAccessIterator>>
+    {
+        using difference_type = difference_type_t<RandomAccessIterator>;
+        auto&& proj = utility::as_function(projection);
+
+        std::size_t nb_runs = runs.size();
+        std::vector<difference_type> lo(nb_runs, 0);
+        std::vector<difference_type> hi(nb_runs);
+        std::vector<difference_type> counts(nb_runs);
+        for (std::size_t run = 0 ; run < nb_runs ; ++run) {
+            hi[run] = runs[run].end - runs[run].current;
+        }
+
+        while (true) {
+            std::size_t widest = 0;
+            for (std::size_t run = 1 ; run < nb_runs ; ++run) {
+                if (hi[run] - lo[run] > hi[widest] - lo[widest]) {
+                    widest = run;
+                }
+            }
+            if (hi[widest] == lo[widest]) {
+                return lo;
+            }
+
+            // Count the elements of every run that come before the pivot
+            // in the stable merge: elements equivalent to the pivot come
+            // before it when they belong to a previous run
+            difference_type pivot_pos = lo[widest] + (hi[widest] - lo[widest]) / 2;
+            auto&& pivot = proj(runs[widest].current[pivot_pos]);
+            difference_type pivot_rank = 0;
+            for (std::size_t run = 0 ; run < nb_runs ; ++run) {
+                if (run < widest) {
+                    counts[run] = upper_bound(runs[run].current, runs[run].end,
+                                              pivot, compare, projection) - runs[run].current;
+                } else if (run == widest) {
+                    counts[run] = pivot_pos;
+                } else {
+                    counts[run] = lower_bound(runs[run].current, runs[run].end,
+                                              pivot, compare, projection) - runs[run].current;
+                }
+                pivot_rank += counts[run];
+            }
+
+            if (pivot_rank < rank) {
+                // The pivot and everything before it is part of the selection
+                for (std::size_t run = 0 ; run < nb_runs ; ++run) {
+                    lo[run] = std::max(lo[run], counts[run]);
+                }
+                lo[widest] = pivot_pos + 1;
+            } else {
+                // The pivot and everything after it is left out
+                for (std::size_t run = 0 ; run < nb_runs ; ++run) {
+                    hi[run] = std::min(hi[run], counts[run]);
+                }
+                hi[widest] = pivot_pos;
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Parallel merge
+
+    enum {
+        // Minimal number of elements merged by a single task
+        min_multiway_merge_segment_size = 1 << 14
+    };
+
+    // Splits the output of the merge in independent segments thanks to
+    // multi-sequence selection, and merges every segment in its own task
+    template<typename Iterator, typename RandomAccessIterator,
+             typename Compare, typename Projection>
+    auto parallel_loser_tree_merge(const std::vector<merge_run<Iterator>>& runs,
+                                   RandomAccessIterator result,
+                                   Compare compare, Projection projection,
+                                   thread_pool& pool)
+        -> RandomAccessIterator
+    {
+        using difference_type = difference_type_t<RandomAccessIterator>;
+
+        difference_type total = 0;
+        for (auto& run: runs) {
+            total += run.end - run.current;
+        }
+
+        difference_type nb_segments = std::min<difference_type>(
+            pool.concurrency(), total / min_multiway_merge_segment_size
+        );
+        if (nb_segments < 2) {
+            auto runs_copy = runs;
+            return loser_tree_merge(runs_copy, std::move(result),
+                                    std::move(compare), std::move(projection));
+        }
+
+        std::vector<std::vector<difference_type_t<Iterator>>> splits;
+        splits.reserve(nb_segments + 1);
+        for (difference_type segment = 0 ; segment <= nb_segments ; ++segment) {
+            splits.push_back(multiway_select(runs, total * segment / nb_segments,
+                                             compare, projection));
+        }
+
+        task_group group(pool);
+        for (difference_type segment = 0 ; segment < nb_segments ; ++segment) {
+            group.spawn([&, segment] {
+                std::vector<merge_run<Iterator>> segment_runs;
+                segment_runs.reserve(runs.size());
+                for (std::size_t run = 0 ; run < runs.size() ; ++run) {
+                    segment_runs.push_back({
+                        runs[run].current + splits[segment][run],
+                        runs[run].current + splits[segment + 1][run]
+                    });
+                }
+                loser_tree_merge(segment_runs, result + total * segment / nb_segments,
+                                 compare, projection);
+            });
+        }
+        group.wait();
+        return result + total;
+    }
+}}
+
+#endif // CPPSORT_DETAIL_MULTIWAY_MERGE_H_
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_PARALLEL_COUNT_INVERSIONS_H_
+#define CPPSORT_DETAIL_PARALLEL_COUNT_INVERSIONS_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/functional.h>
+#include "count_inversions.h"
+#include "memory.h"
+#include "parallel_merge_sort.h"
+#include "thread_pool.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    namespace parallel_count_inversions_detail
+    {
+        enum {
+            // Minimal number of elements handled by a single task
+            min_chunk_size = 1 << 14
+        };
+
+        inline auto nb_chunks(std::ptrdiff_t size, const task_group& group)
+            -> std::ptrdiff_t
+        {
+            return std::min(static_cast<std::ptrdiff_t>(group.concurrency()),
+                            size / min_chunk_size);
+        }
+
+        inline auto chunk_bounds(std::ptrdiff_t size, std::ptrdiff_t nb_chunks)
+            -> std::vector<std::ptrdiff_t>
+        {
+            std::vector<std::ptrdiff_t> bounds;
+            bounds.reserve(nb_chunks + 1);
+            for (std::ptrdiff_t chunk = 0 ; chunk <= nb_chunks ; ++chunk) {
+                bounds.push_back(size * chunk / nb_chunks);
+            }
+            return bounds;
+        }
+
+        // Counts the inversions of data: nb_chunks chunks are counted
+        // and sorted concurrently by count_chunk, then the sorted
+        // chunks are merged pairwise level by level, every merge counting
+        // the inversions between its two runs; merges are split in
+        // independent segments thanks to merge path co-ranking so that all
+        // the threads take part in every level
+        template<typename ResultType, typename T, typename Compare, typename ChunkCounter>
+        auto count_inversions_chunks(T* data, T* buffer, std::ptrdiff_t size,
+                                     Compare compare, ChunkCounter count_chunk,
+                                     std::ptrdiff_t nb_chunks, task_group& group)
+            -> ResultType
+        {
+            auto bounds = chunk_bounds(size, nb_chunks);
+            std::vector<ResultType> counts(nb_chunks, 0);
+
+            try {
+                for (std::ptrdiff_t chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                    group.spawn([&, chunk] {
+                        std::ptrdiff_t begin = bounds[chunk];
+                        counts[chunk] = count_chunk(data + begin, buffer + begin,
+                                                    bounds[chunk + 1] - begin);
+                    });
+                }
+                group.wait();
+
+                ResultType inversions = 0;
+                for (ResultType count: counts) {
+                    inversions += count;
+                }
+
+                std::ptrdiff_t concurrency = group.concurrency();
+                T* source = data;
+                T* destination = buffer;
+                while (bounds.size() > 2) {
+                    // Compute every split point of the level before the
+                    // merges start to move elements around
+                    struct segment_t
+                    {
+                        std::ptrdiff_t begin1, end1, begin2, end2, output;
+                        // Left elements after the segment, which are
+                        // greater than all the right elements in it
+                        ResultType remaining;
+                    };
+                    std::vector<segment_t> segments;
+                    std::vector<std::ptrdiff_t> new_bounds;
+                    new_bounds.reserve(bounds.size() / 2 + 1);
+                    new_bounds.push_back(0);
+
+                    std::size_t run = 0;
+                    for (; run + 2 < bounds.size() ; run += 2) {
+                        std::ptrdiff_t begin = bounds[run];
+                        std::ptrdiff_t middle = bounds[run + 1];
+                        std::ptrdiff_t end = bounds[run + 2];
+                        std::ptrdiff_t size1 = middle - begin;
+                        std::ptrdiff_t size2 = end - middle;
+                        std::ptrdiff_t nb_segments = std::max<std::ptrdiff_t>(1, std::min<std::ptrdiff_t>(
+                            (end - begin) * concurrency / size + 1,
+                            (end - begin) / min_chunk_size
+                        ));
+
+                        std::ptrdiff_t prev_rank = 0;
+                        std::ptrdiff_t prev_k = 0;
+                        for (std::ptrdiff_t segment = 1 ; segment <= nb_segments ; ++segment) {
+                            std::ptrdiff_t k = (size1 + size2) * segment / nb_segments;
+                            std::ptrdiff_t rank = parallel_merge_sort_detail::co_rank(
+                                k, source + begin, size1, source + middle, size2,
+                                compare, utility::identity{}
+                            );
+                            segments.push_back({
+                                begin + prev_rank, begin + rank,
+                                middle + (prev_k - prev_rank), middle + (k - rank),
+                                begin + prev_k, static_cast<ResultType>(size1 - rank)
+                            });
+                            prev_rank = rank;
+                            prev_k = k;
+                        }
+                        new_bounds.push_back(end);
+                    }
+                    if (run + 1 < bounds.size()) {
+                        // Odd run out, move it as is
+                        std::ptrdiff_t begin = bounds[run];
+                        segments.push_back({ begin, size, size, size, begin, 0 });
+                        new_bounds.push_back(size);
+                    }
+
+                    std::vector<ResultType> segment_counts(segments.size(), 0);
+                    for (std::size_t idx = 0 ; idx < segments.size() ; ++idx) {
+                        group.spawn([&, idx] {
+                            const segment_t& seg = segments[idx];
+                            ResultType count = count_inversions_merge_move<ResultType>(
+                                source + seg.begin1, source + seg.end1,
+                                source + seg.begin2, source + seg.end2,
+                                destination + seg.output, compare
+                            );
+                            count += seg.remaining * static_cast<ResultType>(seg.end2 - seg.begin2);
+                            segment_counts[idx] = count;
+                        });
+                    }
+                    group.wait();
+
+                    for (ResultType count: segment_counts) {
+                        inversions += count;
+                    }
+                    bounds = std::move(new_bounds);
+                    std::swap(source, destination);
+                }
+                return inversions;
+            } catch (...) {
+                group.wait_no_throw();
+                throw;
+            }
+        }
+
+        // Counts the inversions of integer keys with a small range: every
+        // chunk counts its own inversions with a Fenwick tree, which is then
+        // turned into a histogram of the chunk; the inversions between
+        // different chunks are derived from the histograms
+        template<typename ResultType, typename Counter, typename T>
+        auto count_inversions_histograms(const T* keys, std::ptrdiff_t size,
+                                         T min, std::uint64_t range,
+                                         std::ptrdiff_t nb_chunks, task_group& group)
+            -> ResultType
+        {
+            auto bounds = chunk_bounds(size, nb_chunks);
+            std::vector<ResultType> counts(nb_chunks, 0);
+            std::vector<Counter, resource_allocator<Counter>> trees(nb_chunks * (range + 1));
+
+            try {
+                for (std::ptrdiff_t chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                    group.spawn([&, chunk] {
+                        std::ptrdiff_t begin = bounds[chunk];
+                        Counter* tree = trees.data() + chunk * (range + 1);
+                        counts[chunk] = detail::count_inversions_fenwick<ResultType>(
+                            keys + begin, bounds[chunk + 1] - begin, min, range, tree
+                        );
+
+                        // Undo the Fenwick tree construction, which leaves
+                        // the number of occurrences of every rank
+                        for (std::uint64_t pos = range ; pos > 0 ; --pos) {
+                            std::uint64_t parent = pos + (pos & (0 - pos));
+                            if (parent <= range) {
+                                tree[parent] -= tree[pos];
+                            }
+                        }
+                    });
+                }
+                group.wait();
+            } catch (...) {
+                group.wait_no_throw();
+                throw;
+            }
+
+            ResultType inversions = 0;
+            for (ResultType count: counts) {
+                inversions += count;
+            }
+
+            // The first histogram accumulates the occurrences of the
+            // ranks in the chunks processed so far
+            Counter* seen = trees.data();
+            for (std::ptrdiff_t chunk = 1 ; chunk < nb_chunks ; ++chunk) {
+                Counter* histogram = trees.data() + chunk * (range + 1);
+                std::uint64_t greater = 0;
+                for (std::uint64_t pos = range ; pos > 0 ; --pos) {
+                    inversions += static_cast<ResultType>(histogram[pos] * greater);
+                    greater += seen[pos];
+                    seen[pos] += histogram[pos];
+                }
+            }
+            return inversions;
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Parallel algorithms
+
+    // Set of algorithms used by probe::parallel_inv, collections too
+    // small to be split are handled by the sequential algorithms
+
+    struct parallel_inversions_counter
+    {
+        task_group* group;
+
+        template<typename ResultType, typename T>
+        auto keys(T* keys, T* buffer, std::ptrdiff_t size) const
+            -> ResultType
+        {
+            auto nb_chunks = parallel_count_inversions_detail::nb_chunks(size, *group);
+            if (nb_chunks < 2) {
+                return count_inversions_keys<ResultType>(keys, buffer, size);
+            }
+            return parallel_count_inversions_detail::count_inversions_chunks<ResultType>(
+                keys, buffer, size, std::less<>{},
+                [](T* first, T* cache, std::ptrdiff_t length) {
+                    return count_inversions_keys<ResultType>(first, cache, length);
+                },
+                nb_chunks, *group
+            );
+        }
+
+        template<typename ResultType, typename T>
+        auto bounded_keys(const T* keys, std::ptrdiff_t size, T min, std::uint64_t range) const
+            -> ResultType
+        {
+            auto nb_chunks = parallel_count_inversions_detail::nb_chunks(size, *group);
+            if (nb_chunks < 2) {
+                return count_inversions_fenwick<ResultType>(keys, size, min, range);
+            }
+
+            // Every chunk needs its own histogram, merge the keys when
+            // the histograms would take too much memory
+            if (range * static_cast<std::uint64_t>(nb_chunks) > static_cast<std::uint64_t>(size) / 2) {
+                auto copy = make_inversions_keys_buffer<T>(size);
+                auto buffer = make_inversions_keys_buffer<T>(size);
+                std::copy(keys, keys + size, copy.get());
+                return this->keys<ResultType>(copy.get(), buffer.get(), size);
+            }
+
+            if (static_cast<std::uint64_t>(size) <= std::numeric_limits<std::uint32_t>::max()) {
+                return parallel_count_inversions_detail::count_inversions_histograms<ResultType, std::uint32_t>(
+                    keys, size, min, range, nb_chunks, *group
+                );
+            }
+            return parallel_count_inversions_detail::count_inversions_histograms<ResultType, std::uint64_t>(
+                keys, size, min, range, nb_chunks, *group
+            );
+        }
+
+        template<typename ResultType, typename Iterator, typename Compare>
+        auto iterators(Iterator* iterators, Iterator* buffer,
+                       std::ptrdiff_t size, Compare compare) const
+            -> ResultType
+        {
+            auto nb_chunks = parallel_count_inversions_detail::nb_chunks(size, *group);
+            if (nb_chunks < 2) {
+                return count_inversions<ResultType>(iterators, iterators + size,
+                                                    buffer, std::move(compare));
+            }
+            return parallel_count_inversions_detail::count_inversions_chunks<ResultType>(
+                iterators, buffer, size, compare,
+                [&compare](Iterator* first, Iterator* cache, std::ptrdiff_t length) {
+                    return detail::count_inversions<ResultType>(first, first + length,
+                                                                cache, compare);
+                },
+                nb_chunks, *group
+            );
+        }
+    };
+}}
+
+#endif // CPPSORT_DETAIL_PARALLEL_COUNT_INVERSIONS_H_
@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_PARALLEL_COUNTING_SORT_H_
+#define CPPSORT_DETAIL_PARALLEL_COUNTING_SORT_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/iter_move.h>
+#include "counting_sort.h"
+#include "iterator_traits.h"
+#include "memory.h"
+#include "minmax_element_and_is_sorted.h"
+#include "parallel_merge_sort.h"
+#include "parallel_ska_sort.h"
+#include "thread_pool.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    namespace parallel_counting_sort_detail
+    {
+        using namespace counting_sort_detail;
+
+        enum {
+            // Minimal number of elements handled by a single task
+            min_chunk_size = 1 << 14
+        };
+
+        // Position where every slice starts in the sorted collection,
+        // the slices are written in reverse order when sorting with
+        // std::greater<>
+        template<bool Reverse, typename Difference>
+        auto slice_positions(const std::vector<Difference>& slice_sizes)
+            -> std::vector<Difference>
+        {
+            std::vector<Difference> positions(slice_sizes.size());
+            Difference total = 0;
+            if (Reverse) {
+                for (std::size_t slice = slice_sizes.size() ; slice > 0 ; --slice) {
+                    positions[slice - 1] = total;
+                    total += slice_sizes[slice - 1];
+                }
+            } else {
+                for (std::size_t slice = 0 ; slice < slice_sizes.size() ; ++slice) {
+                    positions[slice] = total;
+                    total += slice_sizes[slice];
+                }
+            }
+            return positions;
+        }
+
+        // Every chunk counts its values in its own array: the number of
+        // chunks is reduced so that all the arrays together are never
+        // bigger than the one of the sequential algorithm, returns 1
+        // when the range of values is too big to be split at all
+        template<typename Unsigned, typename Difference>
+        auto nb_counting_chunks(Unsigned range, Difference size, std::ptrdiff_t nb_chunks) noexcept
+            -> std::ptrdiff_t
+        {
+            auto limit = std::max<std::uintmax_t>(
+                min_dense_range,
+                static_cast<std::uintmax_t>(size) * max_dense_range_ratio
+            );
+            if (range >= limit / 2) {
+                return 1;
+            }
+            auto nb_values = static_cast<std::uintmax_t>(range) + 1;
+            return static_cast<std::ptrdiff_t>(
+                std::min<std::uintmax_t>(nb_chunks, limit / nb_values)
+            );
+        }
+
+        // Extremes of the keys of a collection and whether it is sorted,
+        // the smallest key is the one that comes first in the order
+        // given by Compare
+        template<typename Key>
+        struct keys_info
+        {
+            Key smallest;
+            Key biggest;
+            bool is_sorted;
+        };
+
+        template<typename Compare, typename RandomAccessIterator, typename Projection>
+        auto parallel_keys_info(RandomAccessIterator first, difference_type_t<RandomAccessIterator> size,
+                                std::ptrdiff_t nb_chunks, Projection projection,
+                                thread_pool& pool)
+            -> keys_info<projected_t<RandomAccessIterator, Projection>>
+        {
+            using key_type = projected_t<RandomAccessIterator, Projection>;
+            auto&& proj = utility::as_function(projection);
+            auto chunk_begin = [=](std::ptrdiff_t chunk) {
+                return first + size * chunk / nb_chunks;
+            };
+
+            std::vector<keys_info<key_type>> infos(nb_chunks);
+            {
+                task_group group(pool);
+                for (std::ptrdiff_t chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                    group.spawn([&, chunk] {
+                        auto info = minmax_element_and_is_sorted(chunk_begin(chunk), chunk_begin(chunk + 1),
+                                                                 Compare{}, projection);
+                        infos[chunk] = { proj(*info.min), proj(*info.max), info.is_sorted };
+                    });
+                }
+                group.wait();
+            }
+
+            Compare compare;
+            auto res = infos[0];
+            for (std::ptrdiff_t chunk = 1 ; chunk < nb_chunks ; ++chunk) {
+                const auto& info = infos[chunk];
+                auto boundary = chunk_begin(chunk);
+                res.is_sorted = res.is_sorted && info.is_sorted &&
+                                not compare(proj(*boundary), proj(*std::prev(boundary)));
+                res.smallest = std::min(res.smallest, info.smallest, compare);
+                res.biggest = std::max(res.biggest, info.biggest, compare);
+            }
+            return res;
+        }
+
+        // Every chunk of the collection counts its values in its own
+        // array, then every slice of the range of values sums the counts
+        // of all the chunks and writes its values back concurrently
+        template<bool Reverse, typename RandomAccessIterator, typename T>
+        auto dense_counting_sort(RandomAccessIterator first, difference_type_t<RandomAccessIterator> size,
+                                 T min, unsigned_value_t<T> range,
+                                 std::ptrdiff_t nb_chunks, thread_pool& pool)
+            -> void
+        {
+            using difference_type = difference_type_t<RandomAccessIterator>;
+            using counts_type = std::vector<difference_type, resource_allocator<difference_type>>;
+            auto nb_values = static_cast<std::size_t>(range) + 1;
+            auto chunk_begin = [=](std::ptrdiff_t chunk) {
+                return first + size * chunk / nb_chunks;
+            };
+            auto slice_begin = [=](std::ptrdiff_t slice) {
+                return nb_values * slice / nb_chunks;
+            };
+
+            resource_allocator<difference_type> allocator;
+            std::vector<counts_type> counts(nb_chunks, counts_type(allocator));
+            std::vector<difference_type> slice_sizes(nb_chunks, 0);
+            task_group group(pool);
+            for (std::ptrdiff_t chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                group.spawn([&, chunk] {
+                    auto& chunk_counts = counts[chunk];
+                    chunk_counts.assign(nb_values, 0);
+                    for (auto it = chunk_begin(chunk) ; it != chunk_begin(chunk + 1) ; ++it) {
+                        ++chunk_counts[static_cast<std::size_t>(value_range(min, *it))];
+                    }
+                });
+            }
+            group.wait();
+
+            // Sum the counts of every chunk in the ones of the first chunk
+            for (std::ptrdiff_t slice = 0 ; slice < nb_chunks ; ++slice) {
+                spawn_or_run(group, [&, slice] {
+                    difference_type slice_size = 0;
+                    for (std::size_t offset = slice_begin(slice) ; offset < slice_begin(slice + 1) ; ++offset) {
+                        for (std::ptrdiff_t chunk = 1 ; chunk < nb_chunks ; ++chunk) {
+                            counts[0][offset] += counts[chunk][offset];
+                        }
+                        slice_size += counts[0][offset];
+                    }
+                    slice_sizes[slice] = slice_size;
+                });
+            }
+            group.wait_no_throw();
+
+            auto positions = slice_positions<Reverse>(slice_sizes);
+            for (std::ptrdiff_t slice = 0 ; slice < nb_chunks ; ++slice) {
+                spawn_or_run(group, [&, slice] {
+                    auto out = first + positions[slice];
+                    if (Reverse) {
+                        for (std::size_t offset = slice_begin(slice + 1) ; offset > slice_begin(slice) ; --offset) {
+                            out = std::fill_n(out, counts[0][offset - 1],
+                                              static_cast<T>(to_unsigned(min) + (offset - 1)));
+                        }
+                    } else {
+                        for (std::size_t offset = slice_begin(slice) ; offset < slice_begin(slice + 1) ; ++offset) {
+                            out = std::fill_n(out, counts[0][offset],
+                                              static_cast<T>(to_unsigned(min) + offset));
+                        }
+                    }
+                });
+            }
+            group.wait_no_throw();
+        }
+
+        template<bool Reverse, typename RandomAccessIterator>
+        auto parallel_counting_sort(RandomAccessIterator first, RandomAccessIterator last,
+                                    difference_type_t<RandomAccessIterator> cutoff,
+                                    thread_pool& pool)
+            -> void
+        {
+            using difference_type = difference_type_t<RandomAccessIterator>;
+            using value_type = value_type_t<RandomAccessIterator>;
+            using compare_type = std::conditional_t<Reverse, std::greater<>, std::less<>>;
+
+            difference_type size = last - first;
+            if (size <= cutoff || pool.concurrency() < 2) {
+                if (Reverse) {
+                    reverse_counting_sort(std::move(first), std::move(last));
+                } else {
+                    counting_sort(std::move(first), std::move(last));
+                }
+                return;
+            }
+
+            std::ptrdiff_t nb_chunks = std::max<std::ptrdiff_t>(1, std::min<std::ptrdiff_t>(
+                pool.concurrency(), size / min_chunk_size
+            ));
+            auto info = parallel_keys_info<compare_type>(first, size, nb_chunks, utility::identity{}, pool);
+            if (info.is_sorted) return;
+
+            value_type min = Reverse ? info.biggest : info.smallest;
+            value_type max = Reverse ? info.smallest : info.biggest;
+            auto range = value_range(min, max);
+            std::ptrdiff_t nb_count_chunks = nb_counting_chunks(range, size, nb_chunks);
+            if (nb_count_chunks > 1) {
+                dense_counting_sort<Reverse>(first, size, min, range, nb_count_chunks, pool);
+            } else {
+                // Radix sort the values like the sequential algorithm
+                parallel_ska_sort(first, last, utility::identity{}, cutoff, pool);
+                if (Reverse) {
+                    std::reverse(first, last);
+                }
+            }
+        }
+
+        // Every chunk of the collection counts its keys in its own array,
+        // then the counts are turned into the positions where every chunk
+        // scatters the elements with a given key, which preserves the
+        // relative order of elements with equivalent keys
+        template<bool Reverse, typename RandomAccessIterator, typename Projection>
+        auto parallel_key_indexed_counting_sort(RandomAccessIterator first, RandomAccessIterator last,
+                                                Projection projection,
+                                                difference_type_t<RandomAccessIterator> cutoff,
+                                                thread_pool& pool)
+            -> void
+        {
+            using utility::iter_move;
+            using difference_type = difference_type_t<RandomAccessIterator>;
+            using value_type = remove_cvref_t<rvalue_reference_t<RandomAccessIterator>>;
+            using key_type = counting_key_t<projected_t<RandomAccessIterator, Projection>>;
+            using offset_type = unsigned_value_t<key_type>;
+            using compare_type = std::conditional_t<Reverse, std::greater<>, std::less<>>;
+            using counts_type = std::vector<difference_type, resource_allocator<difference_type>>;
+
+            // The scatter passes must not throw halfway through
+            constexpr bool can_scatter =
+                std::is_nothrow_move_constructible<value_type>::value &&
+                std::is_nothrow_move_assignable<value_type>::value;
+
+            difference_type size = last - first;
+            if (not can_scatter || size <= cutoff || pool.concurrency() < 2) {
+                key_indexed_counting_sort<Reverse>(std::move(first), std::move(last),
+                                                   std::move(projection));
+                return;
+            }
+
+            std::ptrdiff_t nb_chunks = std::max<std::ptrdiff_t>(1, std::min<std::ptrdiff_t>(
+                pool.concurrency(), size / min_chunk_size
+            ));
+            auto info = parallel_keys_info<compare_type>(first, size, nb_chunks, projection, pool);
+            if (info.is_sorted) return;
+
+            auto min = to_counting_key(Reverse ? info.biggest : info.smallest);
+            auto max = to_counting_key(Reverse ? info.smallest : info.biggest);
+            auto range = value_range(min, max);
+            nb_chunks = nb_counting_chunks(range, size, nb_chunks);
+
+            // Fall back to a stable comparison sort when the keys are too
+            // sparse or when the buffers can't be allocated
+            temporary_buffer<value_type> buffer(nullptr);
+            temporary_buffer<offset_type> offsets(nullptr);
+            if (nb_chunks > 1) {
+                buffer = temporary_buffer<value_type>(size);
+                offsets = temporary_buffer<offset_type>(size);
+            }
+            if (buffer.size() < size || offsets.size() < size) {
+                parallel_merge_sort(std::move(first), std::move(last), compare_type{},
+                                    std::move(projection), cutoff, pool);
+                return;
+            }
+
+            auto&& proj = utility::as_function(projection);
+            auto nb_values = static_cast<std::size_t>(range) + 1;
+            auto chunk_begin = [=](std::ptrdiff_t chunk) {
+                return size * chunk / nb_chunks;
+            };
+            auto slice_begin = [=](std::ptrdiff_t slice) {
+                return nb_values * slice / nb_chunks;
+            };
+
+            resource_allocator<difference_type> allocator;
+            std::vector<counts_type> counts(nb_chunks, counts_type(allocator));
+            std::vector<difference_type> slice_sizes(nb_chunks, 0);
+            task_group group(pool);
+
+            // Count the keys of every chunk, their offsets from the smallest
+            // key are cached so that every element is projected only once
+            for (std::ptrdiff_t chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                group.spawn([&, chunk] {
+                    auto& chunk_counts = counts[chunk];
+                    chunk_counts.assign(nb_values, 0);
+                    for (difference_type i = chunk_begin(chunk) ; i < chunk_begin(chunk + 1) ; ++i) {
+                        offsets.data()[i] = value_range(min, to_counting_key(proj(first[i])));
+                        ++chunk_counts[static_cast<std::size_t>(offsets.data()[i])];
+                    }
+                });
+            }
+            group.wait();
+
+            for (std::ptrdiff_t slice = 0 ; slice < nb_chunks ; ++slice) {
+                spawn_or_run(group, [&, slice] {
+                    difference_type slice_size = 0;
+                    for (std::size_t offset = slice_begin(slice) ; offset < slice_begin(slice + 1) ; ++offset) {
+                        for (const auto& chunk_counts: counts) {
+                            slice_size += chunk_counts[offset];
+                        }
+                    }
+                    slice_sizes[slice] = slice_size;
+                });
+            }
+            group.wait_no_throw();
+
+            // Elements with the same key are written chunk after chunk
+            auto positions = slice_positions<Reverse>(slice_sizes);
+            for (std::ptrdiff_t slice = 0 ; slice < nb_chunks ; ++slice) {
+                spawn_or_run(group, [&, slice] {
+                    difference_type position = positions[slice];
+                    auto update = [&](std::size_t offset) {
+                        for (auto& chunk_counts: counts) {
+                            auto count = chunk_counts[offset];
+                            chunk_counts[offset] = position;
+                            position += count;
+                        }
+                    };
+                    if (Reverse) {
+                        for (std::size_t offset = slice_begin(slice + 1) ; offset > slice_begin(slice) ; --offset) {
+                            update(offset - 1);
+                        }
+                    } else {
+                        for (std::size_t offset = slice_begin(slice) ; offset < slice_begin(slice + 1) ; ++offset) {
+                            update(offset);
+                        }
+                    }
+                });
+            }
+            group.wait_no_throw();
+
+            // Scatter the elements to the buffer then move them back
+            for (std::ptrdiff_t chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                spawn_or_run(group, [&, chunk] {
+                    auto& chunk_counts = counts[chunk];
+                    for (difference_type i = chunk_begin(chunk) ; i < chunk_begin(chunk + 1) ; ++i) {
+                        auto& position = chunk_counts[static_cast<std::size_t>(offsets.data()[i])];
+                        ::new(buffer.data() + position) value_type(iter_move(first + i));
+                        ++position;
+                    }
+                });
+            }
+            group.wait_no_throw();
+            for (std::ptrdiff_t chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                spawn_or_run(group, [&, chunk] {
+                    for (difference_type i = chunk_begin(chunk) ; i < chunk_begin(chunk + 1) ; ++i) {
+                        first[i] = std::move(buffer.data()[i]);
+                        buffer.data()[i].~value_type();
+                    }
+                });
+            }
+            group.wait_no_throw();
+        }
+    }
+
+    template<typename RandomAccessIterator>
+    auto parallel_counting_sort(RandomAccessIterator first, RandomAccessIterator last,
+                                difference_type_t<RandomAccessIterator> cutoff,
+                                thread_pool& pool)
+        -> void
+    {
+        parallel_counting_sort_detail::parallel_counting_sort<false>(
+            std::move(first), std::move(last), cutoff, pool
+        );
+    }
+
+    template<typename RandomAccessIterator>
+    auto parallel_reverse_counting_sort(RandomAccessIterator first, RandomAccessIterator last,
+                                        difference_type_t<RandomAccessIterator> cutoff,
+                                        thread_pool& pool)
+        -> void
+    {
+        parallel_counting_sort_detail::parallel_counting_sort<true>(
+            std::move(first), std::move(last), cutoff, pool
+        );
+    }
+
+    template<typename RandomAccessIterator, typename Projection>
+    auto parallel_key_indexed_counting_sort(RandomAccessIterator first, RandomAccessIterator last,
+                                            Projection projection,
+                                            difference_type_t<RandomAccessIterator> cutoff,
+                                            thread_pool& pool)
+        -> void
+    {
+        parallel_counting_sort_detail::parallel_key_indexed_counting_sort<false>(
+            std::move(first), std::move(last), std::move(projection), cutoff, pool
+        );
+    }
+
+    template<typename RandomAccessIterator, typename Projection>
+    auto parallel_reverse_key_indexed_counting_sort(RandomAccessIterator first, RandomAccessIterator last,
+                                                    Projection projection,
+                                                    difference_type_t<RandomAccessIterator> cutoff,
+                                                    thread_pool& pool)
+        -> void
+    {
+        parallel_counting_sort_detail::parallel_key_indexed_counting_sort<true>(
+            std::move(first), std::move(last), std::move(projection), cutoff, pool
+        );
+    }
+}}
+
+#endif // CPPSORT_DETAIL_PARALLEL_COUNTING_SORT_H_
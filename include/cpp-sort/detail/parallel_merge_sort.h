@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_PARALLEL_MERGE_SORT_H_
+#define CPPSORT_DETAIL_PARALLEL_MERGE_SORT_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/as_function.h>
+#include "iterator_traits.h"
+#include "memory.h"
+#include "merge_move.h"
+#include "merge_sort.h"
+#include "move.h"
+#include "thread_pool.h"
+#include "type_traits.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    namespace parallel_merge_sort_detail
+    {
+        enum {
+            // Minimal number of elements merged by a single task
+            min_merge_segment_size = 1 << 13
+        };
+
+        // Merge path co-ranking: returns the number of elements of the first
+        // sequence among the first k elements of the stable merge of both
+        // sequences, elements of the first sequence coming first on ties
+        template<typename RandomAccessIterator1, typename RandomAccessIterator2,
+                 typename Compare, typename Projection>
+        auto co_rank(difference_type_t<RandomAccessIterator1> k,
+                     RandomAccessIterator1 first1, difference_type_t<RandomAccessIterator1> size1,
+                     RandomAccessIterator2 first2, difference_type_t<RandomAccessIterator1> size2,
+                     Compare compare, Projection projection)
+            -> difference_type_t<RandomAccessIterator1>
+        {
+            using difference_type = difference_type_t<RandomAccessIterator1>;
+            auto&& comp = utility::as_function(compare);
+            auto&& proj = utility::as_function(projection);
+
+            difference_type lo = std::max<difference_type>(0, k - size2);
+            difference_type hi = std::min(k, size1);
+            while (lo < hi) {
+                difference_type i = lo + (hi - lo) / 2;
+                if (comp(proj(first2[k - i - 1]), proj(first1[i]))) {
+                    hi = i;
+                } else {
+                    lo = i + 1;
+                }
+            }
+            return lo;
+        }
+
+        // Stable merge of [first1, first1 + size1) and [first2, first2 + size2)
+        // into result, the output being split in nb_segments independent
+        // merges scheduled as different tasks
+        template<typename RandomAccessIterator1, typename RandomAccessIterator2,
+                 typename OutputIterator, typename Compare, typename Projection>
+        auto parallel_merge_move(RandomAccessIterator1 first1, difference_type_t<RandomAccessIterator1> size1,
+                                 RandomAccessIterator2 first2, difference_type_t<RandomAccessIterator1> size2,
+                                 OutputIterator result, Compare compare, Projection projection,
+                                 difference_type_t<RandomAccessIterator1> nb_segments,
+                                 task_group& group)
+            -> void
+        {
+            using difference_type = difference_type_t<RandomAccessIterator1>;
+            difference_type total = size1 + size2;
+
+            // All the split points have to be computed before any merge starts
+            // since the binary searches read elements that belong to other
+            // segments, which are left in a moved-from state by their merge
+            std::vector<difference_type> ranks;
+            ranks.reserve(nb_segments + 1);
+            for (difference_type segment = 0 ; segment <= nb_segments ; ++segment) {
+                ranks.push_back(co_rank(total * segment / nb_segments,
+                                        first1, size1, first2, size2,
+                                        compare, projection));
+            }
+
+            for (difference_type segment = 0 ; segment < nb_segments ; ++segment) {
+                difference_type i1 = ranks[segment];
+                difference_type i2 = ranks[segment + 1];
+                group.spawn([=] {
+                    difference_type k1 = total * segment / nb_segments;
+                    difference_type k2 = total * (segment + 1) / nb_segments;
+                    merge_move(first1 + i1, first1 + i2,
+                               first2 + (k1 - i1), first2 + (k2 - i2),
+                               result + k1, compare, projection, projection);
+                });
+            }
+        }
+
+        // Moves [first, first + size) to result with up to nb_tasks tasks
+        template<typename RandomAccessIterator, typename OutputIterator>
+        auto parallel_move(RandomAccessIterator first, difference_type_t<RandomAccessIterator> size,
+                           OutputIterator result,
+                           difference_type_t<RandomAccessIterator> nb_tasks,
+                           task_group& group)
+            -> void
+        {
+            using difference_type = difference_type_t<RandomAccessIterator>;
+            for (difference_type task = 0 ; task < nb_tasks ; ++task) {
+                difference_type begin = size * task / nb_tasks;
+                difference_type end = size * (task + 1) / nb_tasks;
+                group.spawn([=] {
+                    detail::move(first + begin, first + end, result + begin);
+                });
+            }
+        }
+    }
+
+    template<typename RandomAccessIterator, typename Compare, typename Projection>
+    auto parallel_merge_sort(RandomAccessIterator first, RandomAccessIterator last,
+                             Compare compare, Projection projection,
+                             difference_type_t<RandomAccessIterator> threshold,
+                             task_group& group)
+        -> void
+    {
+        using namespace parallel_merge_sort_detail;
+        using difference_type = difference_type_t<RandomAccessIterator>;
+        using rvalue_reference = remove_cvref_t<rvalue_reference_t<RandomAccessIterator>>;
+
+        difference_type size = last - first;
+        difference_type concurrency = group.concurrency();
+        difference_type nb_chunks = std::min(concurrency, size / std::max<difference_type>(threshold, 1));
+        if (nb_chunks < 2) {
+            merge_sort(std::move(first), std::move(last), size,
+                       std::move(compare), std::move(projection));
+            return;
+        }
+
+        // The ping-pong merges need a buffer as big as the collection,
+        // fall back to the sequential algorithm otherwise
+        temporary_buffer<rvalue_reference> buffer(size);
+        if (buffer.size() < size) {
+            merge_sort(std::move(first), std::move(last), size,
+                       std::move(compare), std::move(projection));
+            return;
+        }
+
+        // Sort the chunks concurrently
+        std::vector<difference_type> bounds;
+        bounds.reserve(nb_chunks + 1);
+        for (difference_type chunk = 0 ; chunk <= nb_chunks ; ++chunk) {
+            bounds.push_back(size * chunk / nb_chunks);
+        }
+        // The tasks refer to the locals of this function: when spawning
+        // a task fails, the tasks already spawned must be complete before
+        // the exception leaves the function
+        try {
+            for (difference_type chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                group.spawn([&, chunk] {
+                    auto begin = first + bounds[chunk];
+                    auto end = first + bounds[chunk + 1];
+                    merge_sort(begin, end, end - begin, compare, projection);
+                });
+            }
+            group.wait();
+        } catch (...) {
+            group.wait_no_throw();
+            throw;
+        }
+
+        // Move the sorted chunks to the buffer, every chunk remembers how
+        // many elements were constructed in case a move constructor throws
+        std::vector<difference_type> constructed(nb_chunks, 0);
+        const std::vector<difference_type> chunk_bounds = bounds;
+        auto destroy_buffer = [&] {
+            for (difference_type chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                destruct_n<rvalue_reference> destroyer(constructed[chunk]);
+                destroyer(buffer.data() + chunk_bounds[chunk]);
+            }
+        };
+        try {
+            for (difference_type chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                group.spawn([&, chunk] {
+                    destruct_n<rvalue_reference> destroyer(0);
+                    std::unique_ptr<rvalue_reference, destruct_n<rvalue_reference>&> guard(
+                        buffer.data() + bounds[chunk], destroyer
+                    );
+                    uninitialized_move(first + bounds[chunk], first + bounds[chunk + 1],
+                                       buffer.data() + bounds[chunk], destroyer);
+                    guard.release();
+                    constructed[chunk] = bounds[chunk + 1] - bounds[chunk];
+                });
+            }
+            group.wait();
+        } catch (...) {
+            group.wait_no_throw();
+            destroy_buffer();
+            throw;
+        }
+
+        try {
+            // Merge pairs of runs level by level, alternating between the buffer
+            // and the original collection; every merge is split in a number of
+            // segments proportional to its size so that the threads are evenly
+            // loaded at every level
+            auto merge_level = [&](auto source, auto destination) {
+                std::vector<difference_type> new_bounds;
+                new_bounds.reserve(bounds.size() / 2 + 1);
+                new_bounds.push_back(0);
+
+                std::size_t run = 0;
+                for (; run + 2 < bounds.size() ; run += 2) {
+                    difference_type begin = bounds[run];
+                    difference_type middle = bounds[run + 1];
+                    difference_type end = bounds[run + 2];
+                    difference_type nb_segments = std::max<difference_type>(1, std::min(
+                        (end - begin) * concurrency / size + 1,
+                        (end - begin) / min_merge_segment_size
+                    ));
+                    parallel_merge_move(source + begin, middle - begin,
+                                        source + middle, end - middle,
+                                        destination + begin, compare, projection,
+                                        nb_segments, group);
+                    new_bounds.push_back(end);
+                }
+                if (run + 1 < bounds.size()) {
+                    // Odd run out, move it as is
+                    difference_type begin = bounds[run];
+                    parallel_move(source + begin, size - begin, destination + begin, 1, group);
+                    new_bounds.push_back(size);
+                }
+                group.wait();
+                bounds = std::move(new_bounds);
+            };
+
+            bool data_in_buffer = true;
+            while (bounds.size() > 2) {
+                if (data_in_buffer) {
+                    merge_level(buffer.data(), first);
+                } else {
+                    merge_level(first, buffer.data());
+                }
+                data_in_buffer = not data_in_buffer;
+            }
+
+            if (data_in_buffer) {
+                parallel_move(buffer.data(), size, first, concurrency, group);
+                group.wait();
+            }
+        } catch (...) {
+            group.wait_no_throw();
+            destroy_buffer();
+            throw;
+        }
+        destroy_buffer();
+    }
+
+    template<typename RandomAccessIterator, typename Compare, typename Projection>
+    auto parallel_merge_sort(RandomAccessIterator first, RandomAccessIterator last,
+                             Compare compare, Projection projection,
+                             difference_type_t<RandomAccessIterator> threshold,
+                             thread_pool& pool)
+        -> void
+    {
+        task_group group(pool);
+        parallel_merge_sort(std::move(first), std::move(last),
+                            std::move(compare), std::move(projection),
+                            threshold, group);
+    }
+}}
+
+#endif // CPPSORT_DETAIL_PARALLEL_MERGE_SORT_H_
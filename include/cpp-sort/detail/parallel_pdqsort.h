@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_PARALLEL_PDQSORT_H_
+#define CPPSORT_DETAIL_PARALLEL_PDQSORT_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/branchless_traits.h>
+#include <cpp-sort/utility/iter_move.h>
+#include "bitops.h"
+#include "heapsort.h"
+#include "iterator_traits.h"
+#include "iter_sort3.h"
+#include "pdqsort.h"
+#include "thread_pool.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    namespace parallel_pdqsort_detail
+    {
+        enum {
+            // Partitions at least this big are partitioned in parallel
+            // when the thread pool has more than one thread
+            parallel_partition_threshold = 1 << 17,
+
+            // Minimal number of elements handled by a single thread
+            // during a parallel partition
+            min_partition_chunk_size = 1 << 14
+        };
+
+        // Partitions [first, last) so that the elements satisfying pred come
+        // first, returns the partition point and whether the sequence was
+        // already partitioned before the call
+        template<typename RandomAccessIterator, typename Predicate>
+        auto partition_chunk(RandomAccessIterator first, RandomAccessIterator last,
+                             Predicate pred)
+            -> std::pair<RandomAccessIterator, bool>
+        {
+            using utility::iter_swap;
+
+            bool already_partitioned = true;
+            while (true) {
+                while (first != last && pred(*first)) {
+                    ++first;
+                }
+                do {
+                    if (first == last) {
+                        return { first, already_partitioned };
+                    }
+                    --last;
+                } while (not pred(*last));
+                iter_swap(first, last);
+                already_partitioned = false;
+                ++first;
+            }
+        }
+
+        // Half-open range of positions, relative to the beginning of the
+        // partitioned sequence, that hold elements on the wrong side of
+        // the partition point
+        using misplaced_range = std::pair<std::ptrdiff_t, std::ptrdiff_t>;
+
+        // Returns the position of the index-th misplaced element
+        inline auto misplaced_position(const std::vector<misplaced_range>& ranges,
+                                       std::ptrdiff_t index)
+            -> std::pair<std::size_t, std::ptrdiff_t>
+        {
+            std::size_t range_idx = 0;
+            while (index >= ranges[range_idx].second - ranges[range_idx].first) {
+                index -= ranges[range_idx].second - ranges[range_idx].first;
+                ++range_idx;
+            }
+            return { range_idx, ranges[range_idx].first + index };
+        }
+
+        // Same contract as pdqsort_detail::partition_right, but the range is
+        // split in chunks that are partitioned independently by different
+        // threads, then the elements that end up on the wrong side of the
+        // global partition point are swapped in parallel too
+        template<typename RandomAccessIterator, typename Compare, typename Projection>
+        auto parallel_partition_right(RandomAccessIterator begin, RandomAccessIterator end,
+                                      Compare compare, Projection projection,
+                                      thread_pool& pool)
+            -> std::pair<RandomAccessIterator, bool>
+        {
+            using utility::iter_move;
+            using utility::iter_swap;
+            using difference_type = difference_type_t<RandomAccessIterator>;
+            auto&& comp = utility::as_function(compare);
+            auto&& proj = utility::as_function(projection);
+
+            // Move pivot into local for speed, it is only read by the threads
+            auto pivot = iter_move(begin);
+            auto&& pivot_proj = proj(pivot);
+            auto is_less = [&](auto&& value) {
+                return comp(proj(value), pivot_proj);
+            };
+
+            RandomAccessIterator first = std::next(begin);
+            difference_type size = end - first;
+            difference_type nb_chunks = std::min<difference_type>(
+                pool.concurrency(),
+                std::max<difference_type>(size / min_partition_chunk_size, 1)
+            );
+            difference_type chunk_size = size / nb_chunks;
+
+            std::vector<difference_type> nb_less(nb_chunks);
+            std::vector<char> chunk_already_partitioned(nb_chunks);
+            std::vector<misplaced_range> misplaced_left, misplaced_right;
+            difference_type partition_point = 0;
+            difference_type nb_misplaced = 0;
+
+            // The tasks refer to the locals above: the group is declared
+            // after them so that it waits for the tasks before they are
+            // destroyed, even when an exception is thrown
+            task_group group(pool);
+            try {
+                // Partition every chunk independently
+                for (difference_type i = 0 ; i < nb_chunks ; ++i) {
+                    group.spawn([&, i] {
+                        auto chunk_first = first + i * chunk_size;
+                        auto chunk_last = (i == nb_chunks - 1) ? end : chunk_first + chunk_size;
+                        auto res = partition_chunk(chunk_first, chunk_last, is_less);
+                        nb_less[i] = res.first - chunk_first;
+                        chunk_already_partitioned[i] = res.second;
+                    });
+                }
+                group.wait();
+
+                // Find the ranges of elements on the wrong side of the final
+                // partition point: they come in pairs of equal total size
+                for (auto n: nb_less) {
+                    partition_point += n;
+                }
+
+                for (difference_type i = 0 ; i < nb_chunks ; ++i) {
+                    difference_type chunk_first = i * chunk_size;
+                    difference_type chunk_last = (i == nb_chunks - 1) ? size : chunk_first + chunk_size;
+                    difference_type chunk_mid = chunk_first + nb_less[i];
+
+                    // Elements not less than the pivot left of the partition point
+                    difference_type left_last = std::min(chunk_last, partition_point);
+                    if (chunk_mid < left_last) {
+                        misplaced_left.emplace_back(chunk_mid, left_last);
+                        nb_misplaced += left_last - chunk_mid;
+                    }
+                    // Elements less than the pivot right of the partition point
+                    difference_type right_first = std::max(chunk_first, partition_point);
+                    if (right_first < chunk_mid) {
+                        misplaced_right.emplace_back(right_first, chunk_mid);
+                    }
+                }
+
+                // Swap the misplaced elements pairwise, in parallel
+                if (nb_misplaced > 0) {
+                    difference_type nb_swappers = std::min<difference_type>(
+                        pool.concurrency(),
+                        std::max<difference_type>(nb_misplaced / min_partition_chunk_size, 1)
+                    );
+                    difference_type swap_size = nb_misplaced / nb_swappers;
+                    for (difference_type i = 0 ; i < nb_swappers ; ++i) {
+                        group.spawn([&, i] {
+                            difference_type start = i * swap_size;
+                            difference_type count = (i == nb_swappers - 1) ? nb_misplaced - start : swap_size;
+
+                            auto left = misplaced_position(misplaced_left, start);
+                            auto right = misplaced_position(misplaced_right, start);
+                            while (true) {
+                                iter_swap(first + left.second, first + right.second);
+                                if (--count == 0) break;
+                                if (++left.second == misplaced_left[left.first].second) {
+                                    ++left.first;
+                                    left.second = misplaced_left[left.first].first;
+                                }
+                                if (++right.second == misplaced_right[right.first].second) {
+                                    ++right.first;
+                                    right.second = misplaced_right[right.first].first;
+                                }
+                            }
+                        });
+                    }
+                    group.wait();
+                }
+            } catch (...) {
+                // The tasks only ever swap elements of [first, end), so
+                // putting the pivot back leaves a permutation of the
+                // original collection
+                group.wait_no_throw();
+                *begin = std::move(pivot);
+                throw;
+            }
+
+            bool already_partitioned = nb_misplaced == 0 && std::all_of(
+                chunk_already_partitioned.begin(), chunk_already_partitioned.end(),
+                [](char value) { return value != 0; }
+            );
+
+            // Put the pivot in the right place.
+            RandomAccessIterator pivot_pos = first + (partition_point - 1);
+            *begin = iter_move(pivot_pos);
+            *pivot_pos = std::move(pivot);
+
+            return std::make_pair(pivot_pos, already_partitioned);
+        }
+
+        // Mirrors pdqsort_detail::pdqsort_loop, except that the left partition
+        // is spawned as a new task instead of being sorted recursively, and
+        // that partitions smaller than the cutoff are sorted sequentially
+        template<typename RandomAccessIterator, typename Compare, typename Projection,
+                 bool Branchless>
+        auto parallel_pdqsort_loop(RandomAccessIterator begin, RandomAccessIterator end,
+                                   Compare compare, Projection projection,
+                                   int bad_allowed, bool leftmost,
+                                   difference_type_t<RandomAccessIterator> cutoff,
+                                   task_group& group)
+            -> void
+        {
+            using utility::iter_swap;
+            using difference_type = difference_type_t<RandomAccessIterator>;
+            using namespace pdqsort_detail;
+            auto&& comp = utility::as_function(compare);
+            auto&& proj = utility::as_function(projection);
+
+            while (true) {
+                difference_type size = end - begin;
+
+                // Sequential pdqsort is faster for small partitions
+                if (size <= cutoff) {
+                    pdqsort_loop<RandomAccessIterator, Compare, Projection, Branchless>(
+                        std::move(begin), std::move(end),
+                        std::move(compare), std::move(projection),
+                        bad_allowed, leftmost
+                    );
+                    return;
+                }
+
+                // Choose pivot as median of 3 or pseudomedian of 9.
+                difference_type s2 = size / 2;
+                iter_sort3(begin, begin + s2, end - 1, compare, projection);
+                iter_sort3(begin + 1, begin + (s2 - 1), end - 2, compare, projection);
+                iter_sort3(begin + 2, begin + (s2 + 1), end - 3, compare, projection);
+                iter_sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), compare, projection);
+                iter_swap(begin, begin + s2);
+
+                // *(begin - 1) is the pivot of a previous partition, which is
+                // never moved again, so reading it here is race-free
+                if (not leftmost && not comp(proj(*(begin - 1)), proj(*begin))) {
+                    begin = partition_left(begin, end, compare, projection) + 1;
+                    continue;
+                }
+
+                // Partition and get results.
+                std::pair<RandomAccessIterator, bool> part_result;
+                if (size >= parallel_partition_threshold && group.concurrency() > 1) {
+                    part_result = parallel_partition_right(begin, end, compare, projection,
+                                                           group.get_pool());
+                } else {
+                    part_result = Branchless ?
+                        partition_right_branchless(begin, end, compare, projection) :
+                        partition_right(begin, end, compare, projection);
+                }
+                RandomAccessIterator pivot_pos = part_result.first;
+                bool already_partitioned = part_result.second;
+
+                // Check for a highly unbalanced partition.
+                difference_type l_size = pivot_pos - begin;
+                difference_type r_size = end - (pivot_pos + 1);
+                bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+                // If we got a highly unbalanced partition we shuffle elements to break many patterns.
+                if (highly_unbalanced) {
+                    // If we had too many bad partitions, switch to heapsort to guarantee O(n log n).
+                    if (--bad_allowed == 0) {
+                        heapsort(std::move(begin), std::move(end),
+                                 std::move(compare), std::move(projection));
+                        return;
+                    }
+
+                    if (l_size >= insertion_sort_threshold) {
+                        iter_swap(begin,             begin + l_size / 4);
+                        iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+
+                        if (l_size > ninther_threshold) {
+                            iter_swap(begin + 1,         begin + (l_size / 4 + 1));
+                            iter_swap(begin + 2,         begin + (l_size / 4 + 2));
+                            iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                            iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                        }
+                    }
+
+                    if (r_size >= insertion_sort_threshold) {
+                        iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                        iter_swap(end - 1,                   end - r_size / 4);
+
+                        if (r_size > ninther_threshold) {
+                            iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                            iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                            iter_swap(end - 2,             end - (1 + r_size / 4));
+                            iter_swap(end - 3,             end - (2 + r_size / 4));
+                        }
+                    }
+                } else {
+                    // If we were decently balanced and we tried to sort an already partitioned
+                    // sequence try to use insertion sort.
+                    if (already_partitioned &&
+                        partial_insertion_sort(begin, pivot_pos, compare, projection) &&
+                        partial_insertion_sort(pivot_pos + 1, end, compare, projection)) {
+                        return;
+                    }
+                }
+
+                // Let another thread sort the left partition while we keep
+                // sorting the right one
+                group.spawn([=, &group] {
+                    parallel_pdqsort_loop<RandomAccessIterator, Compare, Projection, Branchless>(
+                        begin, pivot_pos, compare, projection,
+                        bad_allowed, leftmost, cutoff, group
+                    );
+                });
+                begin = pivot_pos + 1;
+                leftmost = false;
+            }
+        }
+    }
+
+    template<typename RandomAccessIterator, typename Compare, typename Projection>
+    auto parallel_pdqsort(RandomAccessIterator begin, RandomAccessIterator end,
+                          Compare compare, Projection projection,
+                          difference_type_t<RandomAccessIterator> cutoff,
+                          thread_pool& pool)
+        -> void
+    {
+        using value_type = value_type_t<RandomAccessIterator>;
+        using projected_type = projected_t<RandomAccessIterator, Projection>;
+        constexpr bool is_branchless =
+            utility::is_probably_branchless_comparison_v<Compare, projected_type> &&
+            utility::is_probably_branchless_projection_v<Projection, value_type>;
+
+        auto size = end - begin;
+        if (size < 2) return;
+
+        // The ninther pivot selection needs a few elements
+        cutoff = std::max<difference_type_t<RandomAccessIterator>>(
+            cutoff, pdqsort_detail::ninther_threshold
+        );
+
+        task_group group(pool);
+        parallel_pdqsort_detail::parallel_pdqsort_loop<
+            RandomAccessIterator, Compare, Projection, is_branchless
+        >(
+            std::move(begin), std::move(end),
+            std::move(compare), std::move(projection),
+            detail::log2(size), true, cutoff, group
+        );
+        group.wait();
+    }
+}}
+
+#endif // CPPSORT_DETAIL_PARALLEL_PDQSORT_H_
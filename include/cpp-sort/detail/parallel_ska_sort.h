@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_PARALLEL_SKA_SORT_H_
+#define CPPSORT_DETAIL_PARALLEL_SKA_SORT_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/iter_move.h>
+#include "iterator_traits.h"
+#include "memory.h"
+#include "ska_sort.h"
+#include "thread_pool.h"
+#include "type_traits.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    namespace parallel_ska_sort_detail
+    {
+        enum {
+            // Same thresholds as the sequential ska_sort
+            std_sort_threshold = 128,
+            american_flag_sort_threshold = 1024,
+
+            // Minimal number of elements handled by a single task
+            // during a parallel histogram or scatter pass
+            min_pass_chunk_size = 1 << 14
+        };
+
+        // State shared by all the tasks of a parallel ska_sort: every
+        // partition [begin, end) of the collection uses the matching
+        // regions of the scatter buffer and of the byte cache
+        template<typename RandomAccessIterator>
+        struct sort_data
+        {
+            using value_type = remove_cvref_t<rvalue_reference_t<RandomAccessIterator>>;
+
+            RandomAccessIterator first;
+            value_type* buffer;
+            std::uint8_t* bytes;
+            difference_type_t<RandomAccessIterator> cutoff;
+        };
+
+        // Function used by the sequential algorithm to sort by the next
+        // sub key once the current one is exhausted, if any
+        template<typename CurrentSubKey, typename RandomAccessIterator, typename Projection>
+        auto sequential_next_sort()
+            -> void (*)(RandomAccessIterator, RandomAccessIterator, std::ptrdiff_t, Projection, void*)
+        {
+            using SortType = void (*)(RandomAccessIterator, RandomAccessIterator, std::ptrdiff_t, Projection, void*);
+            using NextStarter = SortStarter<std_sort_threshold, american_flag_sort_threshold,
+                                            typename CurrentSubKey::next>;
+            using VoidStarter = SortStarter<std_sort_threshold, american_flag_sort_threshold, SubKey<void>>;
+
+            SortType next_sort = static_cast<SortType>(&NextStarter::template sort<RandomAccessIterator, Projection>);
+            if (next_sort == static_cast<SortType>(&VoidStarter::template sort<RandomAccessIterator, Projection>)) {
+                return nullptr;
+            }
+            return next_sort;
+        }
+
+        template<typename CurrentSubKey>
+        struct parallel_sort_starter;
+
+        // Sorts by the byte Offset of an unsigned sub key: the histogram and
+        // the scatter of big partitions are split between several tasks and
+        // the resulting buckets are sorted concurrently
+        template<typename CurrentSubKey, std::size_t NumBytes, std::size_t Offset=0>
+        struct parallel_unsigned_sorter
+        {
+            using sequential_sorter = UnsignedInplaceSorter<
+                std_sort_threshold, american_flag_sort_threshold,
+                CurrentSubKey, NumBytes, Offset
+            >;
+
+            template<typename RandomAccessIterator, typename Projection>
+            static auto sort(RandomAccessIterator begin, RandomAccessIterator end, Projection projection,
+                             const sort_data<RandomAccessIterator>& data, task_group& group)
+                -> void
+            {
+                using difference_type = difference_type_t<RandomAccessIterator>;
+                using value_type = typename sort_data<RandomAccessIterator>::value_type;
+                using utility::iter_move;
+
+                difference_type size = end - begin;
+                if (size <= data.cutoff) {
+                    if (not StdSortIfLessThanThreshold<std_sort_threshold>(begin, end, size, projection)) {
+                        sequential_sorter::sort(
+                            begin, end, size, projection,
+                            sequential_next_sort<CurrentSubKey, RandomAccessIterator, Projection>(),
+                            nullptr
+                        );
+                    }
+                    return;
+                }
+
+                difference_type offset = begin - data.first;
+                value_type* buffer = data.buffer + offset;
+                std::uint8_t* bytes = data.bytes + offset;
+
+                difference_type nb_chunks = std::max<difference_type>(1, std::min<difference_type>(
+                    group.concurrency(), size / min_pass_chunk_size
+                ));
+                auto chunk_begin = [=](difference_type chunk) {
+                    return size * chunk / nb_chunks;
+                };
+
+                // Compute the histogram of every chunk, caching the current
+                // byte of every element to avoid projecting it again later
+                using counts_type = std::array<std::size_t, 256>;
+                std::vector<counts_type, resource_allocator<counts_type>> counts(nb_chunks);
+                {
+                    task_group histogram_group(group.get_pool());
+                    for (difference_type chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                        histogram_group.spawn([&, chunk] {
+                            auto&& proj = utility::as_function(projection);
+                            auto& chunk_counts = counts[chunk];
+                            for (difference_type i = chunk_begin(chunk) ; i < chunk_begin(chunk + 1) ; ++i) {
+                                std::uint8_t byte = sequential_sorter::current_byte(proj(begin[i]), nullptr);
+                                bytes[i] = byte;
+                                ++chunk_counts[byte];
+                            }
+                        });
+                    }
+                    histogram_group.wait();
+                }
+
+                // Turn the counts into the positions where every chunk writes
+                // its elements of every bucket
+                std::array<std::size_t, 257> bucket_bounds;
+                std::size_t total = 0;
+                int nb_buckets = 0;
+                for (int bucket = 0 ; bucket < 256 ; ++bucket) {
+                    bucket_bounds[bucket] = total;
+                    for (auto& chunk_counts: counts) {
+                        std::size_t count = chunk_counts[bucket];
+                        chunk_counts[bucket] = total;
+                        total += count;
+                    }
+                    nb_buckets += (total != bucket_bounds[bucket]);
+                }
+                bucket_bounds[256] = total;
+
+                if (nb_buckets > 1) {
+                    // Scatter the elements to the buffer then move them back,
+                    // the moves can't throw so neither pass can be left
+                    // unfinished when another task throws
+                    task_group scatter_group(group.get_pool());
+                    for (difference_type chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                        spawn_or_run(scatter_group, [&, chunk] {
+                            auto& positions = counts[chunk];
+                            for (difference_type i = chunk_begin(chunk) ; i < chunk_begin(chunk + 1) ; ++i) {
+                                ::new(buffer + positions[bytes[i]]++) value_type(iter_move(begin + i));
+                            }
+                        });
+                    }
+                    scatter_group.wait_no_throw();
+                    for (difference_type chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                        spawn_or_run(scatter_group, [&, chunk] {
+                            for (difference_type i = chunk_begin(chunk) ; i < chunk_begin(chunk + 1) ; ++i) {
+                                begin[i] = std::move(buffer[i]);
+                                buffer[i].~value_type();
+                            }
+                        });
+                    }
+                    scatter_group.wait_no_throw();
+                }
+
+                if (Offset + 1 == NumBytes &&
+                    std::is_same<typename CurrentSubKey::next, SubKey<void>>::value) {
+                    return;
+                }
+
+                // Sort the buckets by the next byte concurrently
+                using next_sorter = parallel_unsigned_sorter<CurrentSubKey, NumBytes, Offset + 1>;
+                for (int bucket = 0 ; bucket < 256 ; ++bucket) {
+                    auto bucket_start = begin + bucket_bounds[bucket];
+                    auto bucket_end = begin + bucket_bounds[bucket + 1];
+                    if (bucket_end - bucket_start < 2) continue;
+                    if (nb_buckets == 1) {
+                        // No need to spawn a task for a single bucket
+                        next_sorter::sort(bucket_start, bucket_end, projection, data, group);
+                        return;
+                    }
+                    group.spawn([=, &data, &group] {
+                        next_sorter::sort(bucket_start, bucket_end, projection, data, group);
+                    });
+                }
+            }
+        };
+
+        template<typename CurrentSubKey, std::size_t NumBytes>
+        struct parallel_unsigned_sorter<CurrentSubKey, NumBytes, NumBytes>
+        {
+            template<typename RandomAccessIterator, typename Projection>
+            static auto sort(RandomAccessIterator begin, RandomAccessIterator end, Projection projection,
+                             const sort_data<RandomAccessIterator>& data, task_group& group)
+                -> void
+            {
+                parallel_sort_starter<typename CurrentSubKey::next>::sort(
+                    std::move(begin), std::move(end), std::move(projection), data, group
+                );
+            }
+        };
+
+        // Only unsigned sub keys are sorted in parallel, other kinds of
+        // sub keys are handed to the sequential algorithm
+        template<typename CurrentSubKey, typename SubKeyType=typename CurrentSubKey::sub_key_type>
+        struct parallel_inplace_sorter
+        {
+            template<typename RandomAccessIterator, typename Projection>
+            static auto sort(RandomAccessIterator begin, RandomAccessIterator end, Projection projection,
+                             const sort_data<RandomAccessIterator>&, task_group&)
+                -> void
+            {
+                SortStarter<std_sort_threshold, american_flag_sort_threshold, CurrentSubKey>::sort(
+                    begin, end, end - begin, std::move(projection)
+                );
+            }
+        };
+
+        template<typename CurrentSubKey>
+        struct parallel_inplace_sorter<CurrentSubKey, std::uint8_t>:
+            parallel_unsigned_sorter<CurrentSubKey, 1>
+        {};
+
+        template<typename CurrentSubKey>
+        struct parallel_inplace_sorter<CurrentSubKey, std::uint16_t>:
+            parallel_unsigned_sorter<CurrentSubKey, 2>
+        {};
+
+        template<typename CurrentSubKey>
+        struct parallel_inplace_sorter<CurrentSubKey, std::uint32_t>:
+            parallel_unsigned_sorter<CurrentSubKey, 4>
+        {};
+
+        template<typename CurrentSubKey>
+        struct parallel_inplace_sorter<CurrentSubKey, std::uint64_t>:
+            parallel_unsigned_sorter<CurrentSubKey, 8>
+        {};
+
+#ifdef __SIZEOF_INT128__
+        template<typename CurrentSubKey>
+        struct parallel_inplace_sorter<CurrentSubKey, __uint128_t>:
+            parallel_unsigned_sorter<CurrentSubKey, 16>
+        {};
+#endif
+
+        template<>
+        struct parallel_sort_starter<SubKey<void>>
+        {
+            template<typename RandomAccessIterator, typename Projection>
+            static auto sort(RandomAccessIterator, RandomAccessIterator, Projection,
+                             const sort_data<RandomAccessIterator>&, task_group&)
+                -> void
+            {}
+        };
+
+        template<typename CurrentSubKey>
+        struct parallel_sort_starter
+        {
+            template<typename RandomAccessIterator, typename Projection>
+            static auto sort(RandomAccessIterator begin, RandomAccessIterator end, Projection projection,
+                             const sort_data<RandomAccessIterator>& data, task_group& group)
+                -> void
+            {
+                if (end - begin < 2) return;
+                parallel_inplace_sorter<CurrentSubKey>::sort(
+                    std::move(begin), std::move(end), std::move(projection), data, group
+                );
+            }
+        };
+    }
+
+    template<typename RandomAccessIterator, typename Projection>
+    auto parallel_ska_sort(RandomAccessIterator first, RandomAccessIterator last,
+                           Projection projection,
+                           difference_type_t<RandomAccessIterator> cutoff,
+                           thread_pool& pool)
+        -> void
+    {
+        using namespace parallel_ska_sort_detail;
+        using difference_type = difference_type_t<RandomAccessIterator>;
+        using value_type = typename sort_data<RandomAccessIterator>::value_type;
+
+        // The scatter passes must not throw halfway through
+        constexpr bool can_scatter =
+            std::is_nothrow_move_constructible<value_type>::value &&
+            std::is_nothrow_move_assignable<value_type>::value;
+
+        difference_type size = last - first;
+        cutoff = std::max<difference_type>(cutoff, american_flag_sort_threshold);
+        if (not can_scatter || size <= cutoff || pool.concurrency() < 2) {
+            ska_sort(std::move(first), std::move(last), std::move(projection));
+            return;
+        }
+
+        // Fall back to the sequential algorithm when the memory needed
+        // for the scatter buffer and the byte cache can't be allocated
+        temporary_buffer<value_type> buffer(size);
+        temporary_buffer<std::uint8_t> bytes(size);
+        if (buffer.size() < size || bytes.size() < size) {
+            ska_sort(std::move(first), std::move(last), std::move(projection));
+            return;
+        }
+
+        sort_data<RandomAccessIterator> data = { first, buffer.data(), bytes.data(), cutoff };
+        task_group group(pool);
+        parallel_sort_starter<SubKey<projected_t<RandomAccessIterator, Projection>>>::sort(
+            std::move(first), std::move(last), std::move(projection), data, group
+        );
+        group.wait();
+    }
+}}
+
+#endif // CPPSORT_DETAIL_PARALLEL_SKA_SORT_H_
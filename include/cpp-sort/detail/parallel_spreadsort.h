@@ -0,0 +1,527 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_PARALLEL_SPREADSORT_H_
+#define CPPSORT_DETAIL_PARALLEL_SPREADSORT_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/iter_move.h>
+#include "iterator_traits.h"
+#include "memcpy_cast.h"
+#include "memory.h"
+#include "spreadsort/float_sort.h"
+#include "spreadsort/integer_sort.h"
+#include "spreadsort/string_sort.h"
+#include "thread_pool.h"
+#include "type_traits.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    namespace parallel_spreadsort_detail
+    {
+        enum {
+            // Minimal number of elements handled by a single task
+            // during a parallel histogram or scatter pass
+            min_pass_chunk_size = 1 << 14
+        };
+
+        // State shared by all the tasks of a parallel spreadsort: every
+        // bin [begin, end) of the collection uses the matching regions
+        // of the scatter buffer and of the bin index cache
+        template<typename RandomAccessIterator>
+        struct sort_data
+        {
+            using value_type = remove_cvref_t<rvalue_reference_t<RandomAccessIterator>>;
+
+            RandomAccessIterator first;
+            value_type* buffer;
+            std::uint32_t* bins;
+            difference_type_t<RandomAccessIterator> cutoff;
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Keys of the numeric sorts
+
+        // Map integers and floating point numbers to unsigned integers
+        // with the same order, so that the bins can be computed the same
+        // way for every type
+
+        template<typename Integer>
+        auto spread_key(Integer value)
+            -> std::enable_if_t<
+                std::is_integral<Integer>::value && std::is_signed<Integer>::value,
+                std::uintmax_t
+            >
+        {
+            std::intmax_t widened = value;
+            return static_cast<std::uintmax_t>(widened)
+                 ^ (std::uintmax_t(1) << (sizeof(std::uintmax_t) * CHAR_BIT - 1));
+        }
+
+        template<typename Integer>
+        auto spread_key(Integer value)
+            -> std::enable_if_t<
+                std::is_integral<Integer>::value && not std::is_signed<Integer>::value,
+                std::uintmax_t
+            >
+        {
+            std::uintmax_t widened = value;
+            return widened;
+        }
+
+        template<typename Float>
+        auto spread_key(Float value)
+            -> std::enable_if_t<std::is_floating_point<Float>::value, std::uintmax_t>
+        {
+            using unsigned_type = std::conditional_t<
+                sizeof(Float) == sizeof(std::uint32_t),
+                std::uint32_t,
+                std::uint64_t
+            >;
+            constexpr auto sign_bit = unsigned_type(1) << (sizeof(unsigned_type) * CHAR_BIT - 1);
+
+            // Flip every bit of negative numbers and only the sign
+            // bit of positive ones
+            auto bits = memcpy_cast<unsigned_type>(value);
+            std::uintmax_t res = bits ^ ((bits & sign_bit) ? std::numeric_limits<unsigned_type>::max() : sign_bit);
+            return res;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Sequential algorithms
+
+        struct integer_sort_fn
+        {
+            template<typename RandomAccessIterator, typename Projection>
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Projection projection) const
+                -> void
+            {
+                spreadsort::integer_sort(std::move(first), std::move(last), std::move(projection));
+            }
+        };
+
+        struct float_sort_fn
+        {
+            template<typename RandomAccessIterator, typename Projection>
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Projection projection) const
+                -> void
+            {
+                spreadsort::float_sort(std::move(first), std::move(last), std::move(projection));
+            }
+        };
+
+        template<typename Unsigned_char_type, bool Descending>
+        struct string_sort_fn
+        {
+            template<typename RandomAccessIterator, typename Projection>
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Projection projection) const
+                -> void
+            {
+                Unsigned_char_type unused = 0;
+                spreadsort::string_sort(std::move(first), std::move(last),
+                                        std::move(projection), unused);
+            }
+        };
+
+        template<typename Unsigned_char_type>
+        struct string_sort_fn<Unsigned_char_type, true>
+        {
+            template<typename RandomAccessIterator, typename Projection>
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Projection projection) const
+                -> void
+            {
+                Unsigned_char_type unused = 0;
+                spreadsort::reverse_string_sort(std::move(first), std::move(last),
+                                                std::greater<>{}, std::move(projection),
+                                                unused);
+            }
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Parallel passes
+
+        // Number of tasks between which a pass over a bin is split
+        template<typename RandomAccessIterator>
+        auto nb_pass_chunks(difference_type_t<RandomAccessIterator> size, const task_group& group)
+            -> difference_type_t<RandomAccessIterator>
+        {
+            using difference_type = difference_type_t<RandomAccessIterator>;
+            return std::max<difference_type>(1, std::min<difference_type>(
+                group.concurrency(), size / min_pass_chunk_size
+            ));
+        }
+
+        // Moves the elements of [begin, end) to the bins given by bin_index,
+        // which are stored in that order; the histogram and the scatter
+        // are split between several tasks, and the bounds of the bins
+        // are returned as offsets from begin
+        template<typename RandomAccessIterator, typename Projection, typename BinIndex>
+        auto distribute(RandomAccessIterator begin, RandomAccessIterator end,
+                        Projection& projection, BinIndex bin_index, std::size_t nb_bins,
+                        const sort_data<RandomAccessIterator>& data, task_group& group)
+            -> std::vector<std::size_t>
+        {
+            using difference_type = difference_type_t<RandomAccessIterator>;
+            using value_type = typename sort_data<RandomAccessIterator>::value_type;
+            using utility::iter_move;
+
+            difference_type size = end - begin;
+            difference_type offset = begin - data.first;
+            value_type* buffer = data.buffer + offset;
+            std::uint32_t* bins = data.bins + offset;
+
+            difference_type nb_chunks = nb_pass_chunks<RandomAccessIterator>(size, group);
+            auto chunk_begin = [=](difference_type chunk) {
+                return size * chunk / nb_chunks;
+            };
+
+            // Compute the histogram of every chunk, caching the bin
+            // of every element to avoid projecting it again later
+            using counts_type = std::vector<std::size_t, resource_allocator<std::size_t>>;
+            std::vector<counts_type> counts(nb_chunks, counts_type(nb_bins));
+            {
+                task_group histogram_group(group.get_pool());
+                for (difference_type chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                    histogram_group.spawn([&, chunk] {
+                        auto&& proj = utility::as_function(projection);
+                        auto& chunk_counts = counts[chunk];
+                        for (difference_type i = chunk_begin(chunk) ; i < chunk_begin(chunk + 1) ; ++i) {
+                            std::uint32_t bin = bin_index(proj(begin[i]));
+                            bins[i] = bin;
+                            ++chunk_counts[bin];
+                        }
+                    });
+                }
+                histogram_group.wait();
+            }
+
+            // Turn the counts into the positions where every chunk writes
+            // its elements of every bin
+            std::vector<std::size_t> bounds(nb_bins + 1);
+            std::size_t total = 0;
+            std::size_t nb_used_bins = 0;
+            for (std::size_t bin = 0 ; bin < nb_bins ; ++bin) {
+                bounds[bin] = total;
+                for (auto& chunk_counts: counts) {
+                    std::size_t count = chunk_counts[bin];
+                    chunk_counts[bin] = total;
+                    total += count;
+                }
+                nb_used_bins += (total != bounds[bin]);
+            }
+            bounds[nb_bins] = total;
+
+            if (nb_used_bins > 1) {
+                // Scatter the elements to the buffer then move them back,
+                // the moves can't throw so neither pass can be left
+                // unfinished when another task throws
+                task_group scatter_group(group.get_pool());
+                for (difference_type chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                    spawn_or_run(scatter_group, [&, chunk] {
+                        auto& positions = counts[chunk];
+                        for (difference_type i = chunk_begin(chunk) ; i < chunk_begin(chunk + 1) ; ++i) {
+                            ::new(buffer + positions[bins[i]]++) value_type(iter_move(begin + i));
+                        }
+                    });
+                }
+                scatter_group.wait_no_throw();
+                for (difference_type chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                    spawn_or_run(scatter_group, [&, chunk] {
+                        for (difference_type i = chunk_begin(chunk) ; i < chunk_begin(chunk + 1) ; ++i) {
+                            begin[i] = std::move(buffer[i]);
+                            buffer[i].~value_type();
+                        }
+                    });
+                }
+                scatter_group.wait_no_throw();
+            }
+            return bounds;
+        }
+
+        // Sorts the bins concurrently: consecutive small bins are grouped
+        // until they hold at least cutoff elements so that every task has
+        // enough work, while big bins get their own task and are sorted
+        // in parallel in turn
+        template<typename RandomAccessIterator, typename SortBin>
+        auto sort_bins(RandomAccessIterator begin, const std::vector<std::size_t>& bounds,
+                       difference_type_t<RandomAccessIterator> cutoff,
+                       task_group& group, const SortBin& sort_bin)
+            -> void
+        {
+            auto min_batch_size = static_cast<std::size_t>(cutoff);
+            std::size_t nb_bins = bounds.size() - 1;
+            std::size_t batch_start = 0;
+            for (std::size_t bin = 0 ; bin < nb_bins ; ++bin) {
+                if (bin + 1 < nb_bins && bounds[bin + 1] - bounds[batch_start] < min_batch_size) {
+                    continue;
+                }
+                if (bounds[bin + 1] - bounds[batch_start] > 1) {
+                    std::vector<std::size_t> batch(bounds.begin() + batch_start, bounds.begin() + bin + 2);
+                    group.spawn([=, batch=std::move(batch)] {
+                        for (std::size_t idx = 0 ; idx + 1 < batch.size() ; ++idx) {
+                            if (batch[idx + 1] - batch[idx] > 1) {
+                                sort_bin(begin + batch[idx], begin + batch[idx + 1], batch_start + idx);
+                            }
+                        }
+                    });
+                }
+                batch_start = bin + 1;
+            }
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Integers and floating point numbers
+
+        // Splits the range of the keys between the smallest and the
+        // greatest one in at most 2^max_splits bins like the sequential
+        // algorithm; since every bin holds a smaller range of keys than
+        // the whole collection, sorting big bins again with the parallel
+        // algorithm always ends
+        template<typename SequentialSort, typename RandomAccessIterator, typename Projection>
+        auto sort_numbers(RandomAccessIterator begin, RandomAccessIterator end, Projection projection,
+                          const sort_data<RandomAccessIterator>& data, task_group& group)
+            -> void
+        {
+            using difference_type = difference_type_t<RandomAccessIterator>;
+
+            difference_type size = end - begin;
+            if (size <= data.cutoff) {
+                SequentialSort{}(std::move(begin), std::move(end), std::move(projection));
+                return;
+            }
+
+            // Find the extremes of the keys concurrently
+            difference_type nb_chunks = nb_pass_chunks<RandomAccessIterator>(size, group);
+            std::vector<std::pair<std::uintmax_t, std::uintmax_t>> extremes(
+                nb_chunks, { std::numeric_limits<std::uintmax_t>::max(), 0 }
+            );
+            {
+                task_group extremes_group(group.get_pool());
+                for (difference_type chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                    extremes_group.spawn([&, chunk] {
+                        auto&& proj = utility::as_function(projection);
+                        auto& chunk_extremes = extremes[chunk];
+                        for (difference_type i = size * chunk / nb_chunks ;
+                             i < size * (chunk + 1) / nb_chunks ; ++i) {
+                            std::uintmax_t key = spread_key(proj(begin[i]));
+                            chunk_extremes.first = std::min(chunk_extremes.first, key);
+                            chunk_extremes.second = std::max(chunk_extremes.second, key);
+                        }
+                    });
+                }
+                extremes_group.wait();
+            }
+
+            std::uintmax_t min_key = extremes[0].first;
+            std::uintmax_t max_key = extremes[0].second;
+            for (auto& chunk_extremes: extremes) {
+                min_key = std::min(min_key, chunk_extremes.first);
+                max_key = std::max(max_key, chunk_extremes.second);
+            }
+            if (min_key == max_key) {
+                // Every key is the same
+                return;
+            }
+
+            int log_divisor = 0;
+            while (((max_key - min_key) >> log_divisor) >= (std::uintmax_t(1) << spreadsort::detail::max_splits)) {
+                ++log_divisor;
+            }
+            std::size_t nb_bins = ((max_key - min_key) >> log_divisor) + 1;
+
+            auto bounds = distribute(
+                begin, end, projection,
+                [=](const auto& value) {
+                    return static_cast<std::uint32_t>((spread_key(value) - min_key) >> log_divisor);
+                },
+                nb_bins, data, group
+            );
+
+            sort_bins(begin, bounds, data.cutoff, group,
+                      [=, &data, &group](RandomAccessIterator first, RandomAccessIterator last, std::size_t) {
+                          sort_numbers<SequentialSort>(first, last, projection, data, group);
+                      });
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Strings
+
+        // Distributes the strings according to their character at
+        // char_offset, strings that are too short going to a bin of
+        // their own since they are all equal
+        template<
+            typename Unsigned_char_type, bool Descending,
+            typename RandomAccessIterator, typename Projection
+        >
+        auto sort_strings(RandomAccessIterator begin, RandomAccessIterator end, Projection projection,
+                          std::size_t char_offset,
+                          const sort_data<RandomAccessIterator>& data, task_group& group)
+            -> void
+        {
+            constexpr std::size_t nb_bins = (std::size_t(1) << (sizeof(Unsigned_char_type) * CHAR_BIT)) + 1;
+            constexpr std::size_t ended_bin = Descending ? nb_bins - 1 : 0;
+
+            if (end - begin <= data.cutoff) {
+                string_sort_fn<Unsigned_char_type, Descending>{}(
+                    std::move(begin), std::move(end), std::move(projection)
+                );
+                return;
+            }
+
+            // Skip the characters shared by every string that doesn't end
+            // before char_offset like the sequential algorithm does, which
+            // avoids one distribution pass per character of a long common
+            // prefix; the strings that end before char_offset are all equal
+            // and still go to the ended bin
+            auto&& proj = utility::as_function(projection);
+            auto non_ended = std::find_if(begin, end, [&](const auto& value) {
+                return proj(value).size() > char_offset;
+            });
+            if (non_ended == end) {
+                // Every string is the same
+                return;
+            }
+            spreadsort::detail::update_offset<Unsigned_char_type>(non_ended, end, char_offset, projection);
+
+            auto bounds = distribute(
+                begin, end, projection,
+                [=](const auto& str) {
+                    std::size_t bin = 0;
+                    if (str.size() > char_offset) {
+                        bin = 1 + static_cast<Unsigned_char_type>(str[char_offset]);
+                    }
+                    return static_cast<std::uint32_t>(Descending ? nb_bins - 1 - bin : bin);
+                },
+                nb_bins, data, group
+            );
+
+            sort_bins(begin, bounds, data.cutoff, group,
+                      [=, &data, &group](RandomAccessIterator first, RandomAccessIterator last, std::size_t bin) {
+                          if (bin != ended_bin) {
+                              sort_strings<Unsigned_char_type, Descending>(
+                                  first, last, projection, char_offset + 1, data, group
+                              );
+                          }
+                      });
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Common entry point
+
+        template<
+            typename RandomAccessIterator, typename Projection,
+            typename SequentialSort, typename ParallelSort
+        >
+        auto parallel_spreadsort(RandomAccessIterator first, RandomAccessIterator last,
+                                 Projection projection,
+                                 difference_type_t<RandomAccessIterator> cutoff, thread_pool& pool,
+                                 SequentialSort sequential_sort, ParallelSort parallel_sort)
+            -> void
+        {
+            using difference_type = difference_type_t<RandomAccessIterator>;
+            using value_type = typename sort_data<RandomAccessIterator>::value_type;
+
+            // The scatter passes must not throw halfway through
+            constexpr bool can_scatter =
+                std::is_nothrow_move_constructible<value_type>::value &&
+                std::is_nothrow_move_assignable<value_type>::value;
+
+            difference_type size = last - first;
+            cutoff = std::max<difference_type>(cutoff, spreadsort::detail::min_sort_size);
+            if (not can_scatter || size <= cutoff || pool.concurrency() < 2) {
+                sequential_sort(std::move(first), std::move(last), std::move(projection));
+                return;
+            }
+
+            // Fall back to the sequential algorithm when the memory needed
+            // for the scatter buffer and the bin cache can't be allocated
+            temporary_buffer<value_type> buffer(size);
+            temporary_buffer<std::uint32_t> bins(size);
+            if (buffer.size() < size || bins.size() < size) {
+                sequential_sort(std::move(first), std::move(last), std::move(projection));
+                return;
+            }
+
+            sort_data<RandomAccessIterator> data = { first, buffer.data(), bins.data(), cutoff };
+            task_group group(pool);
+            parallel_sort(std::move(first), std::move(last), std::move(projection), data, group);
+            group.wait();
+        }
+    }
+
+    template<typename RandomAccessIterator, typename Projection>
+    auto parallel_integer_sort(RandomAccessIterator first, RandomAccessIterator last,
+                               Projection projection,
+                               difference_type_t<RandomAccessIterator> cutoff,
+                               thread_pool& pool)
+        -> void
+    {
+        using namespace parallel_spreadsort_detail;
+        parallel_spreadsort(
+            std::move(first), std::move(last), std::move(projection), cutoff, pool,
+            integer_sort_fn{},
+            [](auto begin, auto end, auto projection, const auto& data, task_group& group) {
+                sort_numbers<integer_sort_fn>(begin, end, projection, data, group);
+            }
+        );
+    }
+
+    template<typename RandomAccessIterator, typename Projection>
+    auto parallel_float_sort(RandomAccessIterator first, RandomAccessIterator last,
+                             Projection projection,
+                             difference_type_t<RandomAccessIterator> cutoff,
+                             thread_pool& pool)
+        -> void
+    {
+        using namespace parallel_spreadsort_detail;
+        parallel_spreadsort(
+            std::move(first), std::move(last), std::move(projection), cutoff, pool,
+            float_sort_fn{},
+            [](auto begin, auto end, auto projection, const auto& data, task_group& group) {
+                sort_numbers<float_sort_fn>(begin, end, projection, data, group);
+            }
+        );
+    }
+
+    template<
+        typename Unsigned_char_type, bool Descending,
+        typename RandomAccessIterator, typename Projection
+    >
+    auto parallel_string_sort(RandomAccessIterator first, RandomAccessIterator last,
+                              Projection projection,
+                              difference_type_t<RandomAccessIterator> cutoff,
+                             thread_pool& pool)
+        -> void
+    {
+        using namespace parallel_spreadsort_detail;
+        parallel_spreadsort(
+            std::move(first), std::move(last), std::move(projection), cutoff, pool,
+            string_sort_fn<Unsigned_char_type, Descending>{},
+            [](auto begin, auto end, auto projection, const auto& data, task_group& group) {
+                sort_strings<Unsigned_char_type, Descending>(begin, end, projection, 0, data, group);
+            }
+        );
+    }
+}}
+
+#endif // CPPSORT_DETAIL_PARALLEL_SPREADSORT_H_
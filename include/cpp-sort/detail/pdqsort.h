@@ -32,6 +32,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <iterator>
+#include <memory>
 #include <utility>
 #include <cpp-sort/utility/as_function.h>
 #include <cpp-sort/utility/branchless_traits.h>
@@ -41,6 +42,7 @@
 #include "insertion_sort.h"
 #include "iterator_traits.h"
 #include "iter_sort3.h"
+#include "simd_partition.h"
 
 #ifdef __MINGW32__
 #   include <cstdint> // std::uintptr_t
@@ -184,6 +186,85 @@ namespace detail
             }
         }
 
+        // Fills offsets_l with the offsets of the elements of [first, first + block_size) that
+        // don't compare less than the pivot and returns their number.
+        template<typename RandomAccessIterator, typename Compare, typename Projection, typename T>
+        auto fill_offsets_l(RandomAccessIterator first, unsigned char* offsets_l,
+                            Compare& comp, Projection& proj, T& pivot_proj,
+                            std::false_type /* use_simd */)
+            -> int
+        {
+            int num_l = 0;
+            RandomAccessIterator it = first;
+            for (unsigned char i = 0 ; i < block_size ;) {
+                offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
+                offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
+                offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
+                offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
+                offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
+                offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
+                offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
+                offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
+            }
+            return num_l;
+        }
+
+        // Fills offsets_r with the offsets from last of the elements of [last - block_size, last)
+        // that compare less than the pivot and returns their number.
+        template<typename RandomAccessIterator, typename Compare, typename Projection, typename T>
+        auto fill_offsets_r(RandomAccessIterator last, unsigned char* offsets_r,
+                            Compare& comp, Projection& proj, T& pivot_proj,
+                            std::false_type /* use_simd */)
+            -> int
+        {
+            int num_r = 0;
+            RandomAccessIterator it = last;
+            for (unsigned char i = 0 ; i < block_size ;) {
+                offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
+                offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
+                offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
+                offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
+                offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
+                offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
+                offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
+                offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
+            }
+            return num_r;
+        }
+
+        // When the elements are arithmetic values in contiguous memory compared with std::less
+        // or std::greater, a whole block is compared to the pivot with vector instructions and
+        // the resulting bit mask is turned into offsets with a lookup table.
+        template<typename RandomAccessIterator, typename Compare, typename Projection, typename T>
+        auto fill_offsets_l(RandomAccessIterator first, unsigned char* offsets_l,
+                            Compare&, Projection&, T& pivot_proj,
+                            std::true_type /* use_simd */)
+            -> int
+        {
+            static_assert(block_size == 64, "vector partitioning works on blocks of 64 elements");
+            using value_type = value_type_t<RandomAccessIterator>;
+            using block_compare = simd_block_compare<
+                value_type, is_simd_partition_greater<Compare, value_type>::value
+            >;
+            auto mask = block_compare::mask(std::addressof(*first), pivot_proj);
+            return simd_forward_offsets(~mask, offsets_l);
+        }
+
+        template<typename RandomAccessIterator, typename Compare, typename Projection, typename T>
+        auto fill_offsets_r(RandomAccessIterator last, unsigned char* offsets_r,
+                            Compare&, Projection&, T& pivot_proj,
+                            std::true_type /* use_simd */)
+            -> int
+        {
+            static_assert(block_size == 64, "vector partitioning works on blocks of 64 elements");
+            using value_type = value_type_t<RandomAccessIterator>;
+            using block_compare = simd_block_compare<
+                value_type, is_simd_partition_greater<Compare, value_type>::value
+            >;
+            auto mask = block_compare::mask(std::addressof(*(last - block_size)), pivot_proj);
+            return simd_backward_offsets(mask, offsets_r);
+        }
+
         // Partitions [begin, end) around pivot *begin using comparison function compare. Elements equal
         // to the pivot are put in the right-hand partition. Returns the position of the pivot after
         // partitioning and whether the passed sequence already was correctly partitioned. Assumes the
@@ -196,6 +277,7 @@ namespace detail
         {
             using utility::iter_move;
             using utility::iter_swap;
+            using use_simd = can_use_simd_partition<RandomAccessIterator, Compare, Projection>;
             auto&& comp = utility::as_function(compare);
             auto&& proj = utility::as_function(projection);
 
@@ -243,31 +325,11 @@ namespace detail
                 // Fill up offset blocks with elements that are on the wrong side.
                 if (num_l == 0) {
                     start_l = 0;
-                    RandomAccessIterator it = first;
-                    for (unsigned char i = 0 ; i < block_size ;) {
-                        offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
-                        offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
-                        offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
-                        offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
-                        offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
-                        offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
-                        offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
-                        offsets_l[num_l] = i++; num_l += !comp(proj(*it), pivot_proj); ++it;
-                    }
+                    num_l = fill_offsets_l(first, offsets_l, comp, proj, pivot_proj, use_simd{});
                 }
                 if (num_r == 0) {
                     start_r = 0;
-                    RandomAccessIterator it = last;
-                    for (unsigned char i = 0 ; i < block_size ;) {
-                        offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
-                        offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
-                        offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
-                        offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
-                        offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
-                        offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
-                        offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
-                        offsets_r[num_r] = ++i; num_r += comp(proj(*--it), pivot_proj);
-                    }
+                    num_r = fill_offsets_r(last, offsets_r, comp, proj, pivot_proj, use_simd{});
                 }
 
                 // Swap elements and update block sizes and first/last boundaries.
@@ -17,6 +17,7 @@
 #include "bitops.h"
 #include "insertion_sort.h"
 #include "iterator_traits.h"
+#include "memory.h"
 
 namespace cppsort
 {
@@ -36,6 +37,12 @@ namespace detail
         }
     };
 
+    template<typename RandomAccessIterator>
+    using poplars_t = std::vector<
+        poplar<RandomAccessIterator>,
+        resource_allocator<poplar<RandomAccessIterator>>
+    >;
+
     template<typename RandomAccessIterator, typename Size,
              typename Compare, typename Projection>
     auto sift(RandomAccessIterator first, Size size,
@@ -74,7 +81,7 @@ namespace detail
     }
 
     template<typename RandomAccessIterator, typename Compare, typename Projection>
-    auto relocate(const std::vector<poplar<RandomAccessIterator>>& poplars,
+    auto relocate(const poplars_t<RandomAccessIterator>& poplars,
                   Compare compare, Projection projection)
         -> void
     {
@@ -132,7 +139,7 @@ namespace detail
         poplar_size_t size = last - first;
         if (size < 2) return;
 
-        std::vector<poplar<RandomAccessIterator>> poplars;
+        poplars_t<RandomAccessIterator> poplars;
         poplars.reserve(log2(size));
 
         //
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_RADIX_KEY_H_
+#define CPPSORT_DETAIL_RADIX_KEY_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "ska_sort.h"
+#include "type_traits.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    //
+    // Encodes keys into 64-bit unsigned integers whose natural order
+    // matches the order of the keys under std::less<>: if a < b then
+    // encode(a) <= encode(b). Arithmetic types are made unsigned with
+    // the same functions as ska_sort, strings contribute their first
+    // characters, and the elements of pairs and tuples are appended
+    // one after the other until the 64 bits are used
+    //
+    // A key is exactly encoded when encode(a) == encode(b) implies that
+    // a and b are equivalent, otherwise equal encoded keys have to be
+    // compared again with the original keys
+    //
+
+    struct radix_key_writer
+    {
+        std::uint64_t value = 0;
+        int remaining = 64;
+
+        // Appends the highest bits of an unsigned integer of the given
+        // width, returns whether every bit could be written
+        auto write(std::uint64_t bits, int width) noexcept
+            -> bool
+        {
+            if (remaining == 0) {
+                return false;
+            }
+            if (width > remaining) {
+                value |= bits >> (width - remaining);
+                remaining = 0;
+                return false;
+            }
+            remaining -= width;
+            value |= bits << remaining;
+            return true;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Traits
+
+    template<typename T>
+    struct radix_key_traits
+    {
+        // Whether the type can be encoded at all
+        static constexpr bool encodable = false;
+        // Whether the type can be exactly encoded, and with how many bits
+        static constexpr bool exact = false;
+        static constexpr int bits = 0;
+    };
+
+    template<typename T>
+    struct radix_key_arithmetic_traits
+    {
+        static constexpr bool encodable = sizeof(T) <= sizeof(std::uint64_t) && (
+            std::is_integral<T>::value ||
+            (std::is_same<T, float>::value && is_ska_sortable<float>::value) ||
+            (std::is_same<T, double>::value && is_ska_sortable<double>::value)
+        );
+        static constexpr bool exact = encodable;
+        static constexpr int bits = std::is_same<T, bool>::value ? 1 : int(sizeof(T) * CHAR_BIT);
+    };
+
+    template<> struct radix_key_traits<bool>: radix_key_arithmetic_traits<bool> {};
+    template<> struct radix_key_traits<char>: radix_key_arithmetic_traits<char> {};
+    template<> struct radix_key_traits<signed char>: radix_key_arithmetic_traits<signed char> {};
+    template<> struct radix_key_traits<unsigned char>: radix_key_arithmetic_traits<unsigned char> {};
+    template<> struct radix_key_traits<short>: radix_key_arithmetic_traits<short> {};
+    template<> struct radix_key_traits<unsigned short>: radix_key_arithmetic_traits<unsigned short> {};
+    template<> struct radix_key_traits<int>: radix_key_arithmetic_traits<int> {};
+    template<> struct radix_key_traits<unsigned int>: radix_key_arithmetic_traits<unsigned int> {};
+    template<> struct radix_key_traits<long>: radix_key_arithmetic_traits<long> {};
+    template<> struct radix_key_traits<unsigned long>: radix_key_arithmetic_traits<unsigned long> {};
+    template<> struct radix_key_traits<long long>: radix_key_arithmetic_traits<long long> {};
+    template<> struct radix_key_traits<unsigned long long>: radix_key_arithmetic_traits<unsigned long long> {};
+    template<> struct radix_key_traits<float>: radix_key_arithmetic_traits<float> {};
+    template<> struct radix_key_traits<double>: radix_key_arithmetic_traits<double> {};
+
+    template<typename Traits, typename Allocator>
+    struct radix_key_traits<std::basic_string<char, Traits, Allocator>>
+    {
+        // Only a prefix of the string fits in the encoded key
+        static constexpr bool encodable = std::is_same<Traits, std::char_traits<char>>::value;
+        static constexpr bool exact = false;
+        static constexpr int bits = 64;
+    };
+
+    template<typename... Args>
+    struct radix_key_traits<std::tuple<Args...>>
+    {
+        static constexpr bool encodable = conjunction<
+            std::integral_constant<bool, radix_key_traits<Args>::encodable>...
+        >::value;
+
+        static constexpr int sum_bits(std::initializer_list<int> values)
+        {
+            int res = 0;
+            for (int value: values) {
+                res += value;
+            }
+            return res;
+        }
+
+        static constexpr bool exact = conjunction<
+            std::integral_constant<bool, radix_key_traits<Args>::exact>...
+        >::value && sum_bits({ radix_key_traits<Args>::bits... }) <= 64;
+        static constexpr int bits = sum_bits({ radix_key_traits<Args>::bits... });
+    };
+
+    template<typename T, typename U>
+    struct radix_key_traits<std::pair<T, U>>:
+        radix_key_traits<std::tuple<T, U>>
+    {};
+
+    ////////////////////////////////////////////////////////////
+    // Encoding functions
+
+    // Every function returns whether the value was entirely encoded
+
+    template<typename... Args>
+    auto encode_radix_key(radix_key_writer& writer, const std::tuple<Args...>& value)
+        -> bool;
+
+    template<typename T, typename U>
+    auto encode_radix_key(radix_key_writer& writer, const std::pair<T, U>& value)
+        -> bool;
+
+    template<typename T>
+    auto encode_radix_key(radix_key_writer& writer, T value)
+        -> std::enable_if_t<std::is_integral<T>::value, bool>
+    {
+        return writer.write(to_unsigned_or_bool(value), radix_key_traits<T>::bits);
+    }
+
+    inline auto encode_radix_key(radix_key_writer& writer, char value)
+        -> bool
+    {
+        // ska_sort orders char as unsigned char, which does not match
+        // operator< when char is signed
+        if (std::is_signed<char>::value) {
+            return writer.write(to_unsigned_or_bool(static_cast<signed char>(value)), CHAR_BIT);
+        }
+        return writer.write(static_cast<unsigned char>(value), CHAR_BIT);
+    }
+
+    inline auto encode_radix_key(radix_key_writer& writer, float value)
+        -> bool
+    {
+        // Equivalent zeros must get the same encoding
+        if (value == 0.0f) {
+            value = 0.0f;
+        }
+        return writer.write(to_unsigned_or_bool(value), 32);
+    }
+
+    inline auto encode_radix_key(radix_key_writer& writer, double value)
+        -> bool
+    {
+        // Equivalent zeros must get the same encoding
+        if (value == 0.0) {
+            value = 0.0;
+        }
+        return writer.write(to_unsigned_or_bool(value), 64);
+    }
+
+    template<typename Traits, typename Allocator>
+    auto encode_radix_key(radix_key_writer& writer,
+                          const std::basic_string<char, Traits, Allocator>& value)
+        -> bool
+    {
+        // Missing characters are encoded as zeros, which means that
+        // strings that only differ by trailing null characters get
+        // the same encoding, no element can be encoded after a string
+        std::size_t pos = 0;
+        while (writer.remaining >= CHAR_BIT) {
+            unsigned char c = pos < value.size() ? static_cast<unsigned char>(value[pos]) : 0;
+            writer.write(c, CHAR_BIT);
+            ++pos;
+        }
+        writer.remaining = 0;
+        return false;
+    }
+
+    template<typename Tuple, std::size_t... Indices>
+    auto encode_radix_key_elements(radix_key_writer& writer, const Tuple& value,
+                                   std::index_sequence<Indices...>)
+        -> bool
+    {
+        using std::get;
+        bool res = true;
+        // Stop appending elements once one of them didn't fit
+        (void) std::initializer_list<bool>{
+            (res = res && encode_radix_key(writer, get<Indices>(value)))...
+        };
+        return res;
+    }
+
+    template<typename... Args>
+    auto encode_radix_key(radix_key_writer& writer, const std::tuple<Args...>& value)
+        -> bool
+    {
+        return encode_radix_key_elements(writer, value, std::index_sequence_for<Args...>{});
+    }
+
+    template<typename T, typename U>
+    auto encode_radix_key(radix_key_writer& writer, const std::pair<T, U>& value)
+        -> bool
+    {
+        return encode_radix_key_elements(writer, value, std::make_index_sequence<2>{});
+    }
+
+    template<typename T>
+    auto radix_key(const T& value)
+        -> std::uint64_t
+    {
+        radix_key_writer writer;
+        encode_radix_key(writer, value);
+        return writer.value;
+    }
+}}
+
+#endif // CPPSORT_DETAIL_RADIX_KEY_H_
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_SAMPLING_H_
+#define CPPSORT_DETAIL_SAMPLING_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <cpp-sort/probes/estimate.h>
+
+namespace cppsort
+{
+namespace detail
+{
+    //
+    // Tools shared by the sampled measures of presortedness: they
+    // draw their samples from a small pseudo-random generator seeded
+    // with the size of the collection, which makes the estimates
+    // reproducible from one run to another
+    //
+
+    class sampling_engine
+    {
+        private:
+
+            std::uint64_t state;
+
+        public:
+
+            explicit sampling_engine(std::uint64_t seed) noexcept:
+                state(seed)
+            {}
+
+            // splitmix64
+            auto operator()() noexcept
+                -> std::uint64_t
+            {
+                std::uint64_t res = (state += 0x9e3779b97f4a7c15);
+                res = (res ^ (res >> 30)) * 0xbf58476d1ce4e5b9;
+                res = (res ^ (res >> 27)) * 0x94d049bb133111eb;
+                return res ^ (res >> 31);
+            }
+
+            // Integer in [0, bound), the bias is negligible for the
+            // bounds used by the probes
+            auto below(std::uint64_t bound) noexcept
+                -> std::uint64_t
+            {
+                return operator()() % bound;
+            }
+    };
+
+    // Wilson score interval with a confidence level of 95% for the
+    // proportion of successes in independent trials
+    inline auto wilson_interval(std::uint64_t successes, std::uint64_t trials)
+        -> std::pair<double, double>
+    {
+        constexpr double z = 1.959963984540054;
+        double n = static_cast<double>(trials);
+        double p = static_cast<double>(successes) / n;
+        double denominator = 1.0 + z * z / n;
+        double center = (p + z * z / (2.0 * n)) / denominator;
+        double half_width = z * std::sqrt(p * (1.0 - p) / n + z * z / (4.0 * n * n)) / denominator;
+        return { std::max(0.0, center - half_width), std::min(1.0, center + half_width) };
+    }
+
+    // Scales the proportion p and its interval [lower, upper] to a
+    // measure whose maximal value is total
+    template<typename T>
+    auto make_estimate(double p, double lower, double upper, T total)
+        -> probe::estimate<T>
+    {
+        double scale = static_cast<double>(total);
+        auto clamp = [total](double value) {
+            return std::min(total, std::max(T(0), static_cast<T>(value)));
+        };
+        return {
+            clamp(std::round(p * scale)),
+            clamp(std::floor(lower * scale)),
+            clamp(std::ceil(upper * scale))
+        };
+    }
+
+    template<typename T>
+    auto make_exact_estimate(T value)
+        -> probe::estimate<T>
+    {
+        return { value, value, value };
+    }
+}}
+
+#endif // CPPSORT_DETAIL_SAMPLING_H_
@@ -0,0 +1,392 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_SIMD_PARTITION_H_
+#define CPPSORT_DETAIL_SIMD_PARTITION_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+#include <cpp-sort/utility/functional.h>
+#include "iterator_traits.h"
+#if defined(__AVX2__) || defined(__AVX512F__)
+#   include <immintrin.h>
+#endif
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Block comparisons
+
+    // simd_block_compare<T, Greater> compares 64 consecutive values of
+    // type T against a pivot and returns a 64-bit mask whose i-th bit is
+    // set when the i-th value compares less (or greater when Greater is
+    // true) than the pivot; it is only specialized for the types and
+    // instruction sets the code is compiled for
+
+    template<typename T, bool Greater, typename=void>
+    struct simd_block_compare
+    {
+        static constexpr bool available = false;
+    };
+
+    template<typename T>
+    using simd_partition_int32_t = std::integral_constant<bool,
+        std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 4
+    >;
+
+    template<typename T>
+    using simd_partition_uint32_t = std::integral_constant<bool,
+        std::is_integral<T>::value && std::is_unsigned<T>::value && sizeof(T) == 4
+    >;
+
+    template<typename T>
+    using simd_partition_int64_t = std::integral_constant<bool,
+        std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 8
+    >;
+
+    template<typename T>
+    using simd_partition_uint64_t = std::integral_constant<bool,
+        std::is_integral<T>::value && std::is_unsigned<T>::value && sizeof(T) == 8
+    >;
+
+#if defined(__AVX512F__)
+    // AVX-512 comparisons directly produce bit masks
+
+    template<typename T, bool Greater>
+    struct simd_block_compare<T, Greater, std::enable_if_t<
+        simd_partition_int32_t<T>::value || simd_partition_uint32_t<T>::value
+    >>
+    {
+        static constexpr bool available = true;
+
+        static auto compare(__m512i values, __m512i pivot)
+            -> std::uint64_t
+        {
+            // _MM_CMPINT_LT and _MM_CMPINT_NLE are respectively < and >
+            constexpr int predicate = Greater ? _MM_CMPINT_NLE : _MM_CMPINT_LT;
+            return simd_partition_int32_t<T>::value ?
+                _mm512_cmp_epi32_mask(values, pivot, predicate) :
+                _mm512_cmp_epu32_mask(values, pivot, predicate);
+        }
+
+        static auto mask(const T* ptr, T pivot)
+            -> std::uint64_t
+        {
+            __m512i pivots = _mm512_set1_epi32(static_cast<int>(pivot));
+            std::uint64_t res = 0;
+            for (int i = 0 ; i < 4 ; ++i) {
+                __m512i values = _mm512_loadu_si512(ptr + 16 * i);
+                res |= compare(values, pivots) << (16 * i);
+            }
+            return res;
+        }
+    };
+
+    template<typename T, bool Greater>
+    struct simd_block_compare<T, Greater, std::enable_if_t<
+        simd_partition_int64_t<T>::value || simd_partition_uint64_t<T>::value
+    >>
+    {
+        static constexpr bool available = true;
+
+        static auto compare(__m512i values, __m512i pivot)
+            -> std::uint64_t
+        {
+            constexpr int predicate = Greater ? _MM_CMPINT_NLE : _MM_CMPINT_LT;
+            return simd_partition_int64_t<T>::value ?
+                _mm512_cmp_epi64_mask(values, pivot, predicate) :
+                _mm512_cmp_epu64_mask(values, pivot, predicate);
+        }
+
+        static auto mask(const T* ptr, T pivot)
+            -> std::uint64_t
+        {
+            __m512i pivots = _mm512_set1_epi64(static_cast<long long>(pivot));
+            std::uint64_t res = 0;
+            for (int i = 0 ; i < 8 ; ++i) {
+                __m512i values = _mm512_loadu_si512(ptr + 8 * i);
+                res |= compare(values, pivots) << (8 * i);
+            }
+            return res;
+        }
+    };
+
+    template<bool Greater>
+    struct simd_block_compare<float, Greater>
+    {
+        static constexpr bool available = true;
+
+        static auto mask(const float* ptr, float pivot)
+            -> std::uint64_t
+        {
+            // Ordered comparisons: NaN never compares less or greater
+            constexpr int predicate = Greater ? _CMP_GT_OQ : _CMP_LT_OQ;
+            __m512 pivots = _mm512_set1_ps(pivot);
+            std::uint64_t res = 0;
+            for (int i = 0 ; i < 4 ; ++i) {
+                __m512 values = _mm512_loadu_ps(ptr + 16 * i);
+                res |= std::uint64_t(_mm512_cmp_ps_mask(values, pivots, predicate)) << (16 * i);
+            }
+            return res;
+        }
+    };
+
+    template<bool Greater>
+    struct simd_block_compare<double, Greater>
+    {
+        static constexpr bool available = true;
+
+        static auto mask(const double* ptr, double pivot)
+            -> std::uint64_t
+        {
+            constexpr int predicate = Greater ? _CMP_GT_OQ : _CMP_LT_OQ;
+            __m512d pivots = _mm512_set1_pd(pivot);
+            std::uint64_t res = 0;
+            for (int i = 0 ; i < 8 ; ++i) {
+                __m512d values = _mm512_loadu_pd(ptr + 8 * i);
+                res |= std::uint64_t(_mm512_cmp_pd_mask(values, pivots, predicate)) << (8 * i);
+            }
+            return res;
+        }
+    };
+#elif defined(__AVX2__)
+    // AVX2 only has signed "greater than" comparisons for integers, the
+    // sign bit is flipped to compare unsigned integers, then movemask
+    // gathers the sign bits of the comparison results
+
+    template<typename T, bool Greater>
+    struct simd_block_compare<T, Greater, std::enable_if_t<
+        simd_partition_int32_t<T>::value || simd_partition_uint32_t<T>::value
+    >>
+    {
+        static constexpr bool available = true;
+
+        static auto mask(const T* ptr, T pivot)
+            -> std::uint64_t
+        {
+            __m256i flip = _mm256_set1_epi32(simd_partition_int32_t<T>::value ? 0 : INT32_MIN);
+            __m256i pivots = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(pivot)), flip);
+            std::uint64_t res = 0;
+            for (int i = 0 ; i < 8 ; ++i) {
+                __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + 8 * i));
+                values = _mm256_xor_si256(values, flip);
+                __m256i cmp = Greater ?
+                    _mm256_cmpgt_epi32(values, pivots) :
+                    _mm256_cmpgt_epi32(pivots, values);
+                auto bits = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(cmp)));
+                res |= std::uint64_t(bits) << (8 * i);
+            }
+            return res;
+        }
+    };
+
+    template<typename T, bool Greater>
+    struct simd_block_compare<T, Greater, std::enable_if_t<
+        simd_partition_int64_t<T>::value || simd_partition_uint64_t<T>::value
+    >>
+    {
+        static constexpr bool available = true;
+
+        static auto mask(const T* ptr, T pivot)
+            -> std::uint64_t
+        {
+            __m256i flip = _mm256_set1_epi64x(simd_partition_int64_t<T>::value ? 0 : INT64_MIN);
+            __m256i pivots = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(pivot)), flip);
+            std::uint64_t res = 0;
+            for (int i = 0 ; i < 16 ; ++i) {
+                __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + 4 * i));
+                values = _mm256_xor_si256(values, flip);
+                __m256i cmp = Greater ?
+                    _mm256_cmpgt_epi64(values, pivots) :
+                    _mm256_cmpgt_epi64(pivots, values);
+                auto bits = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(cmp)));
+                res |= std::uint64_t(bits) << (4 * i);
+            }
+            return res;
+        }
+    };
+
+    template<bool Greater>
+    struct simd_block_compare<float, Greater>
+    {
+        static constexpr bool available = true;
+
+        static auto mask(const float* ptr, float pivot)
+            -> std::uint64_t
+        {
+            // Ordered comparisons: NaN never compares less or greater
+            constexpr int predicate = Greater ? _CMP_GT_OQ : _CMP_LT_OQ;
+            __m256 pivots = _mm256_set1_ps(pivot);
+            std::uint64_t res = 0;
+            for (int i = 0 ; i < 8 ; ++i) {
+                __m256 cmp = _mm256_cmp_ps(_mm256_loadu_ps(ptr + 8 * i), pivots, predicate);
+                res |= std::uint64_t(static_cast<unsigned>(_mm256_movemask_ps(cmp))) << (8 * i);
+            }
+            return res;
+        }
+    };
+
+    template<bool Greater>
+    struct simd_block_compare<double, Greater>
+    {
+        static constexpr bool available = true;
+
+        static auto mask(const double* ptr, double pivot)
+            -> std::uint64_t
+        {
+            constexpr int predicate = Greater ? _CMP_GT_OQ : _CMP_LT_OQ;
+            __m256d pivots = _mm256_set1_pd(pivot);
+            std::uint64_t res = 0;
+            for (int i = 0 ; i < 16 ; ++i) {
+                __m256d cmp = _mm256_cmp_pd(_mm256_loadu_pd(ptr + 4 * i), pivots, predicate);
+                res |= std::uint64_t(static_cast<unsigned>(_mm256_movemask_pd(cmp))) << (4 * i);
+            }
+            return res;
+        }
+    };
+#endif
+
+    ////////////////////////////////////////////////////////////
+    // Offsets extraction
+
+    // Turning a mask into a list of offsets is done one byte at a time:
+    // a table gives the positions of the bits set in every possible
+    // byte, packed in a 64-bit integer, which is written in one go to
+    // the offsets buffer before advancing by the number of set bits,
+    // which is also stored in the table
+
+    struct simd_offsets_table
+    {
+        std::uint64_t forward[256];
+        std::uint64_t backward[256];
+        unsigned char count[256];
+
+        constexpr simd_offsets_table():
+            forward(),
+            backward(),
+            count()
+        {
+            for (int byte = 0 ; byte < 256 ; ++byte) {
+                int shift = 0;
+                for (int bit = 0 ; bit < 8 ; ++bit) {
+                    if (byte & (1 << bit)) {
+                        forward[byte] |= std::uint64_t(bit) << shift;
+                        shift += 8;
+                    }
+                }
+                shift = 0;
+                for (int bit = 7 ; bit >= 0 ; --bit) {
+                    if (byte & (1 << bit)) {
+                        backward[byte] |= std::uint64_t(7 - bit) << shift;
+                        shift += 8;
+                    }
+                }
+                count[byte] = static_cast<unsigned char>(shift / 8);
+            }
+        }
+    };
+
+    template<typename=void>
+    struct simd_offsets
+    {
+        static constexpr simd_offsets_table table{};
+    };
+
+    template<typename T>
+    constexpr simd_offsets_table simd_offsets<T>::table;
+
+    inline auto simd_store_offsets(unsigned char* offsets, std::uint64_t packed)
+        -> void
+    {
+        std::memcpy(offsets, &packed, sizeof(packed));
+    }
+
+    // Writes to offsets the positions of the bits set in mask, in
+    // ascending order, and returns the number of written offsets;
+    // offsets must have room for 64 elements
+    inline auto simd_forward_offsets(std::uint64_t mask, unsigned char* offsets)
+        -> int
+    {
+        constexpr std::uint64_t broadcast = 0x0101010101010101u;
+        int num = 0;
+        for (int i = 0 ; i < 8 ; ++i) {
+            auto byte = static_cast<unsigned>(mask >> (8 * i)) & 0xffu;
+            simd_store_offsets(offsets + num, simd_offsets<>::table.forward[byte] + broadcast * unsigned(8 * i));
+            num += simd_offsets<>::table.count[byte];
+        }
+        return num;
+    }
+
+    // Writes to offsets 64 - i for every position i of a bit set in
+    // mask, in ascending order of the written values, and returns the
+    // number of written offsets; offsets must have room for 64 elements
+    inline auto simd_backward_offsets(std::uint64_t mask, unsigned char* offsets)
+        -> int
+    {
+        constexpr std::uint64_t broadcast = 0x0101010101010101u;
+        int num = 0;
+        for (int i = 7 ; i >= 0 ; --i) {
+            auto byte = static_cast<unsigned>(mask >> (8 * i)) & 0xffu;
+            simd_store_offsets(offsets + num, simd_offsets<>::table.backward[byte] + broadcast * unsigned(57 - 8 * i));
+            num += simd_offsets<>::table.count[byte];
+        }
+        return num;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Dispatch
+
+    // Iterators known to point to contiguous memory: this can't be
+    // expressed in C++14, so only pointers and std::vector iterators
+    // are recognized
+
+    template<typename Iterator>
+    struct is_known_contiguous_iterator:
+        disjunction<
+            std::is_pointer<Iterator>,
+            std::is_same<Iterator, typename std::vector<value_type_t<Iterator>>::iterator>,
+            std::is_same<Iterator, typename std::vector<value_type_t<Iterator>>::const_iterator>
+        >
+    {};
+
+    template<typename Compare, typename T>
+    struct is_simd_partition_greater:
+        disjunction<
+            std::is_same<Compare, std::greater<>>,
+            std::is_same<Compare, std::greater<T>>
+        >
+    {};
+
+    template<typename Compare, typename T>
+    struct is_simd_partition_comparison:
+        disjunction<
+            std::is_same<Compare, std::less<>>,
+            std::is_same<Compare, std::less<T>>,
+            is_simd_partition_greater<Compare, T>
+        >
+    {};
+
+    template<typename RandomAccessIterator, typename Compare, typename Projection>
+    struct can_use_simd_partition:
+        conjunction<
+            is_known_contiguous_iterator<RandomAccessIterator>,
+            std::is_same<Projection, utility::identity>,
+            is_simd_partition_comparison<Compare, value_type_t<RandomAccessIterator>>,
+            std::integral_constant<bool, simd_block_compare<
+                value_type_t<RandomAccessIterator>,
+                is_simd_partition_greater<Compare, value_type_t<RandomAccessIterator>>::value
+            >::available>
+        >
+    {};
+}}
+
+#endif // CPPSORT_DETAIL_SIMD_PARTITION_H_
@@ -0,0 +1,483 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_SIMD_SORTING_NETWORK_H_
+#define CPPSORT_DETAIL_SIMD_SORTING_NETWORK_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#if defined(__SSE4_1__) || defined(__AVX2__) || defined(__AVX512F__)
+#   include <immintrin.h>
+#endif
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Vector operations
+
+    // simd_network_ops<T, N> provides the operations needed to run a
+    // sorting network on N values of type T held in a single vector
+    // register; it is only specialized for the combinations of types
+    // and sizes supported by the instruction sets the code is compiled
+    // for, which makes the dispatch happen entirely at compile time
+
+    template<typename T, std::size_t N, typename=void>
+    struct simd_network_ops
+    {
+        static constexpr bool available = false;
+    };
+
+    template<typename T>
+    using simd_int32_t = std::integral_constant<bool,
+        std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 4
+    >;
+
+    template<typename T>
+    using simd_uint32_t = std::integral_constant<bool,
+        std::is_integral<T>::value && std::is_unsigned<T>::value && sizeof(T) == 4
+    >;
+
+    template<typename T>
+    using simd_int64_t = std::integral_constant<bool,
+        std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 8
+    >;
+
+    template<typename T>
+    using simd_uint64_t = std::integral_constant<bool,
+        std::is_integral<T>::value && std::is_unsigned<T>::value && sizeof(T) == 8
+    >;
+
+#ifdef __SSE4_1__
+    template<typename T>
+    struct simd_network_ops<T, 4, std::enable_if_t<simd_int32_t<T>::value || simd_uint32_t<T>::value>>
+    {
+        static constexpr bool available = true;
+        using vector = __m128i;
+
+        static auto load(const T* ptr) -> vector { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)); }
+        static auto store(T* ptr, vector vec) -> void { _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), vec); }
+
+        static auto min(vector lhs, vector rhs)
+            -> vector
+        {
+            return simd_int32_t<T>::value ? _mm_min_epi32(lhs, rhs) : _mm_min_epu32(lhs, rhs);
+        }
+
+        static auto max(vector lhs, vector rhs)
+            -> vector
+        {
+            return simd_int32_t<T>::value ? _mm_max_epi32(lhs, rhs) : _mm_max_epu32(lhs, rhs);
+        }
+
+        template<int P0, int P1, int P2, int P3>
+        static auto permute(vector vec)
+            -> vector
+        {
+            return _mm_shuffle_epi32(vec, P0 | (P1 << 2) | (P2 << 4) | (P3 << 6));
+        }
+
+        template<unsigned Mask>
+        static auto blend(vector lhs, vector rhs)
+            -> vector
+        {
+            // Every 32-bit lane spans two 16-bit lanes
+            return _mm_blend_epi16(lhs, rhs, (Mask & 1 ? 0x03 : 0) | (Mask & 2 ? 0x0c : 0) |
+                                             (Mask & 4 ? 0x30 : 0) | (Mask & 8 ? 0xc0 : 0));
+        }
+    };
+
+    template<>
+    struct simd_network_ops<float, 4>
+    {
+        static constexpr bool available = true;
+        using vector = __m128;
+
+        static auto load(const float* ptr) -> vector { return _mm_loadu_ps(ptr); }
+        static auto store(float* ptr, vector vec) -> void { _mm_storeu_ps(ptr, vec); }
+        static auto min(vector lhs, vector rhs) -> vector { return _mm_min_ps(lhs, rhs); }
+        static auto max(vector lhs, vector rhs) -> vector { return _mm_max_ps(lhs, rhs); }
+
+        template<int P0, int P1, int P2, int P3>
+        static auto permute(vector vec)
+            -> vector
+        {
+            return _mm_shuffle_ps(vec, vec, P0 | (P1 << 2) | (P2 << 4) | (P3 << 6));
+        }
+
+        template<unsigned Mask>
+        static auto blend(vector lhs, vector rhs)
+            -> vector
+        {
+            return _mm_blend_ps(lhs, rhs, Mask);
+        }
+    };
+#endif
+
+#ifdef __AVX2__
+    template<typename T>
+    struct simd_network_ops<T, 8, std::enable_if_t<simd_int32_t<T>::value || simd_uint32_t<T>::value>>
+    {
+        static constexpr bool available = true;
+        using vector = __m256i;
+
+        static auto load(const T* ptr) -> vector { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)); }
+        static auto store(T* ptr, vector vec) -> void { _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), vec); }
+
+        static auto min(vector lhs, vector rhs)
+            -> vector
+        {
+            return simd_int32_t<T>::value ? _mm256_min_epi32(lhs, rhs) : _mm256_min_epu32(lhs, rhs);
+        }
+
+        static auto max(vector lhs, vector rhs)
+            -> vector
+        {
+            return simd_int32_t<T>::value ? _mm256_max_epi32(lhs, rhs) : _mm256_max_epu32(lhs, rhs);
+        }
+
+        template<int... Partners>
+        static auto permute(vector vec)
+            -> vector
+        {
+            return _mm256_permutevar8x32_epi32(vec, _mm256_setr_epi32(Partners...));
+        }
+
+        template<unsigned Mask>
+        static auto blend(vector lhs, vector rhs)
+            -> vector
+        {
+            return _mm256_blend_epi32(lhs, rhs, Mask);
+        }
+    };
+
+    template<>
+    struct simd_network_ops<float, 8>
+    {
+        static constexpr bool available = true;
+        using vector = __m256;
+
+        static auto load(const float* ptr) -> vector { return _mm256_loadu_ps(ptr); }
+        static auto store(float* ptr, vector vec) -> void { _mm256_storeu_ps(ptr, vec); }
+        static auto min(vector lhs, vector rhs) -> vector { return _mm256_min_ps(lhs, rhs); }
+        static auto max(vector lhs, vector rhs) -> vector { return _mm256_max_ps(lhs, rhs); }
+
+        template<int... Partners>
+        static auto permute(vector vec)
+            -> vector
+        {
+            return _mm256_permutevar8x32_ps(vec, _mm256_setr_epi32(Partners...));
+        }
+
+        template<unsigned Mask>
+        static auto blend(vector lhs, vector rhs)
+            -> vector
+        {
+            return _mm256_blend_ps(lhs, rhs, Mask);
+        }
+    };
+
+    template<>
+    struct simd_network_ops<double, 4>
+    {
+        static constexpr bool available = true;
+        using vector = __m256d;
+
+        static auto load(const double* ptr) -> vector { return _mm256_loadu_pd(ptr); }
+        static auto store(double* ptr, vector vec) -> void { _mm256_storeu_pd(ptr, vec); }
+        static auto min(vector lhs, vector rhs) -> vector { return _mm256_min_pd(lhs, rhs); }
+        static auto max(vector lhs, vector rhs) -> vector { return _mm256_max_pd(lhs, rhs); }
+
+        template<int P0, int P1, int P2, int P3>
+        static auto permute(vector vec)
+            -> vector
+        {
+            return _mm256_permute4x64_pd(vec, P0 | (P1 << 2) | (P2 << 4) | (P3 << 6));
+        }
+
+        template<unsigned Mask>
+        static auto blend(vector lhs, vector rhs)
+            -> vector
+        {
+            return _mm256_blend_pd(lhs, rhs, Mask);
+        }
+    };
+#endif
+
+#ifdef __AVX512F__
+    // _mm512_setr_epi32 and friends are macros with some compilers,
+    // which prevents passing them a parameter pack
+    template<typename Integer, int... Partners>
+    auto indices()
+        -> __m512i
+    {
+        static constexpr Integer values[] = { Partners... };
+        return _mm512_loadu_si512(values);
+    }
+
+    template<typename T>
+    struct simd_network_ops<T, 16, std::enable_if_t<simd_int32_t<T>::value || simd_uint32_t<T>::value>>
+    {
+        static constexpr bool available = true;
+        using vector = __m512i;
+
+        static auto load(const T* ptr) -> vector { return _mm512_loadu_si512(ptr); }
+        static auto store(T* ptr, vector vec) -> void { _mm512_storeu_si512(ptr, vec); }
+
+        static auto min(vector lhs, vector rhs)
+            -> vector
+        {
+            return simd_int32_t<T>::value ? _mm512_min_epi32(lhs, rhs) : _mm512_min_epu32(lhs, rhs);
+        }
+
+        static auto max(vector lhs, vector rhs)
+            -> vector
+        {
+            return simd_int32_t<T>::value ? _mm512_max_epi32(lhs, rhs) : _mm512_max_epu32(lhs, rhs);
+        }
+
+        template<int... Partners>
+        static auto permute(vector vec)
+            -> vector
+        {
+            return _mm512_permutexvar_epi32(indices<std::int32_t, Partners...>(), vec);
+        }
+
+        template<unsigned Mask>
+        static auto blend(vector lhs, vector rhs)
+            -> vector
+        {
+            return _mm512_mask_blend_epi32(static_cast<__mmask16>(Mask), lhs, rhs);
+        }
+    };
+
+    template<>
+    struct simd_network_ops<float, 16>
+    {
+        static constexpr bool available = true;
+        using vector = __m512;
+
+        static auto load(const float* ptr) -> vector { return _mm512_loadu_ps(ptr); }
+        static auto store(float* ptr, vector vec) -> void { _mm512_storeu_ps(ptr, vec); }
+        static auto min(vector lhs, vector rhs) -> vector { return _mm512_min_ps(lhs, rhs); }
+        static auto max(vector lhs, vector rhs) -> vector { return _mm512_max_ps(lhs, rhs); }
+
+        template<int... Partners>
+        static auto permute(vector vec)
+            -> vector
+        {
+            return _mm512_permutexvar_ps(indices<std::int32_t, Partners...>(), vec);
+        }
+
+        template<unsigned Mask>
+        static auto blend(vector lhs, vector rhs)
+            -> vector
+        {
+            return _mm512_mask_blend_ps(static_cast<__mmask16>(Mask), lhs, rhs);
+        }
+    };
+
+    template<typename T>
+    struct simd_network_ops<T, 8, std::enable_if_t<simd_int64_t<T>::value || simd_uint64_t<T>::value>>
+    {
+        static constexpr bool available = true;
+        using vector = __m512i;
+
+        static auto load(const T* ptr) -> vector { return _mm512_loadu_si512(ptr); }
+        static auto store(T* ptr, vector vec) -> void { _mm512_storeu_si512(ptr, vec); }
+
+        static auto min(vector lhs, vector rhs)
+            -> vector
+        {
+            return simd_int64_t<T>::value ? _mm512_min_epi64(lhs, rhs) : _mm512_min_epu64(lhs, rhs);
+        }
+
+        static auto max(vector lhs, vector rhs)
+            -> vector
+        {
+            return simd_int64_t<T>::value ? _mm512_max_epi64(lhs, rhs) : _mm512_max_epu64(lhs, rhs);
+        }
+
+        template<int... Partners>
+        static auto permute(vector vec)
+            -> vector
+        {
+            return _mm512_permutexvar_epi64(indices<std::int64_t, Partners...>(), vec);
+        }
+
+        template<unsigned Mask>
+        static auto blend(vector lhs, vector rhs)
+            -> vector
+        {
+            return _mm512_mask_blend_epi64(static_cast<__mmask8>(Mask), lhs, rhs);
+        }
+    };
+
+    template<>
+    struct simd_network_ops<double, 8>
+    {
+        static constexpr bool available = true;
+        using vector = __m512d;
+
+        static auto load(const double* ptr) -> vector { return _mm512_loadu_pd(ptr); }
+        static auto store(double* ptr, vector vec) -> void { _mm512_storeu_pd(ptr, vec); }
+        static auto min(vector lhs, vector rhs) -> vector { return _mm512_min_pd(lhs, rhs); }
+        static auto max(vector lhs, vector rhs) -> vector { return _mm512_max_pd(lhs, rhs); }
+
+        template<int... Partners>
+        static auto permute(vector vec)
+            -> vector
+        {
+            return _mm512_permutexvar_pd(indices<std::int64_t, Partners...>(), vec);
+        }
+
+        template<unsigned Mask>
+        static auto blend(vector lhs, vector rhs)
+            -> vector
+        {
+            return _mm512_mask_blend_pd(static_cast<__mmask8>(Mask), lhs, rhs);
+        }
+    };
+#endif
+
+    ////////////////////////////////////////////////////////////
+    // Layered sorting networks
+
+    // Every layer of a network is described by the index of the lane
+    // each lane is compared with, lanes that don't take part in any
+    // compare-exchange unit of the layer being their own partner; the
+    // networks are chosen for their number of layers rather than for
+    // their number of units since all the units of a layer are
+    // performed at once: the networks for 4 and 8 values are
+    // depth-optimal, the one for 16 values has 10 layers where the
+    // optimal depth is 9
+
+    template<typename... Layers>
+    struct simd_network_layers {};
+
+    template<std::size_t N>
+    struct simd_network;
+
+    template<>
+    struct simd_network<4>
+    {
+        using layers = simd_network_layers<
+            std::integer_sequence<int, 1, 0, 3, 2>,
+            std::integer_sequence<int, 2, 3, 0, 1>,
+            std::integer_sequence<int, 0, 2, 1, 3>
+        >;
+    };
+
+    template<>
+    struct simd_network<8>
+    {
+        using layers = simd_network_layers<
+            std::integer_sequence<int, 2, 3, 0, 1, 6, 7, 4, 5>,
+            std::integer_sequence<int, 4, 5, 6, 7, 0, 1, 2, 3>,
+            std::integer_sequence<int, 1, 0, 3, 2, 5, 4, 7, 6>,
+            std::integer_sequence<int, 0, 1, 4, 5, 2, 3, 6, 7>,
+            std::integer_sequence<int, 0, 4, 2, 6, 1, 5, 3, 7>,
+            std::integer_sequence<int, 0, 2, 1, 4, 3, 6, 5, 7>
+        >;
+    };
+
+    template<>
+    struct simd_network<16>
+    {
+        using layers = simd_network_layers<
+            std::integer_sequence<int, 13, 12, 15, 14, 8, 6, 5, 11, 4, 10, 9, 7, 1, 0, 3, 2>,
+            std::integer_sequence<int, 5, 7, 9, 4, 3, 0, 13, 1, 14, 2, 15, 12, 11, 6, 8, 10>,
+            std::integer_sequence<int, 1, 0, 3, 2, 5, 4, 8, 9, 6, 7, 11, 10, 13, 12, 15, 14>,
+            std::integer_sequence<int, 2, 3, 0, 1, 10, 11, 7, 6, 9, 8, 4, 5, 14, 15, 12, 13>,
+            std::integer_sequence<int, 0, 2, 1, 12, 6, 7, 4, 5, 10, 11, 8, 9, 3, 14, 13, 15>,
+            std::integer_sequence<int, 0, 4, 6, 3, 1, 8, 2, 10, 5, 13, 7, 14, 12, 9, 11, 15>,
+            std::integer_sequence<int, 0, 1, 4, 6, 2, 5, 3, 7, 8, 12, 10, 13, 9, 11, 14, 15>,
+            std::integer_sequence<int, 0, 1, 2, 5, 4, 3, 8, 9, 6, 7, 12, 11, 10, 13, 14, 15>,
+            std::integer_sequence<int, 0, 1, 2, 4, 3, 6, 5, 8, 7, 10, 9, 12, 11, 13, 14, 15>,
+            std::integer_sequence<int, 0, 1, 2, 3, 4, 5, 7, 6, 9, 8, 10, 11, 12, 13, 14, 15>
+        >;
+    };
+
+    // Lanes whose partner has a smaller index receive the maximum
+    // of the pair when sorting in ascending order
+    template<int... Partners>
+    constexpr auto simd_upper_lanes_mask(std::integer_sequence<int, Partners...>)
+        -> unsigned
+    {
+        const int partners[] = { Partners... };
+        unsigned mask = 0;
+        for (int lane = 0 ; lane < static_cast<int>(sizeof...(Partners)) ; ++lane) {
+            if (partners[lane] < lane) {
+                mask |= 1u << lane;
+            }
+        }
+        return mask;
+    }
+
+    template<typename Ops, bool Descending, int... Partners>
+    auto simd_network_layer(typename Ops::vector vec, std::integer_sequence<int, Partners...> layer)
+        -> typename Ops::vector
+    {
+        constexpr unsigned mask = simd_upper_lanes_mask(layer);
+        auto partners = Ops::template permute<Partners...>(vec);
+        auto low = Ops::min(vec, partners);
+        auto high = Ops::max(vec, partners);
+        return Descending ?
+            Ops::template blend<mask>(high, low) :
+            Ops::template blend<mask>(low, high);
+    }
+
+    template<typename Ops, bool Descending, typename... Layers>
+    auto simd_network_apply(typename Ops::vector vec, simd_network_layers<Layers...>)
+        -> typename Ops::vector
+    {
+        using swallow = int[];
+        (void) swallow { 0, (vec = simd_network_layer<Ops, Descending>(vec, Layers{}), 0)... };
+        return vec;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Kernel selection
+
+    // Vector kernels are only used when the number of values to sort
+    // matches the width of a register exactly, smaller collections are
+    // sorted with the scalar networks instead of being padded
+
+    template<typename T, std::size_t N>
+    using has_simd_sorting_network = std::integral_constant<bool,
+        (N == 4 || N == 8 || N == 16) && simd_network_ops<T, N>::available
+    >;
+
+    // Sorts the N values starting at first, which are loaded in a single
+    // vector register; only usable when has_simd_sorting_network<T, N>
+    template<std::size_t N, bool Descending, typename RandomAccessIterator>
+    auto simd_sorting_network(RandomAccessIterator first)
+        -> void
+    {
+        using value_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+        using ops = simd_network_ops<value_type, N>;
+
+        value_type values[N];
+        for (std::size_t i = 0 ; i < N ; ++i) {
+            values[i] = first[i];
+        }
+
+        auto vec = ops::load(values);
+        vec = simd_network_apply<ops, Descending>(vec, typename simd_network<N>::layers{});
+        ops::store(values, vec);
+
+        for (std::size_t i = 0 ; i < N ; ++i) {
+            first[i] = values[i];
+        }
+    }
+}}
+
+#endif // CPPSORT_DETAIL_SIMD_SORTING_NETWORK_H_
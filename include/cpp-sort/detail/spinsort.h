@@ -126,7 +126,7 @@ namespace detail
             // sorted part
             // the data are inserted in rng_aux
             //-----------------------------------------------------------------------
-            std::vector<RandomAccessIterator1> viter;
+            std::vector<RandomAccessIterator1, resource_allocator<RandomAccessIterator1>> viter;
             auto beta = rng_aux.first;
             auto data = rng_aux.first;
 
@@ -380,8 +380,9 @@ namespace detail
                     nptr = (nelem + 1) >> 1;
                     std::size_t nelem_1 = nptr;
                     std::size_t nelem_2 = nelem - nelem_1;
+                    ptr.get_deleter() = operator_deleter(nptr * sizeof(rvalue_reference));
                     ptr.reset(static_cast<rvalue_reference*>(
-                        ::operator new(nptr * sizeof(rvalue_reference))
+                        detail::allocate(nptr * sizeof(rvalue_reference))
                     ));
                     range_buf range_aux(ptr.get(), (ptr.get() + nptr));
 
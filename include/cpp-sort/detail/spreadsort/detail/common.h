@@ -27,6 +27,7 @@ Phil Endecott and Frank Gennari
 #include <type_traits>
 #include <vector>
 #include "constants.h"
+#include "../../memory.h"
 
 namespace cppsort
 {
@@ -40,6 +41,13 @@ namespace detail
     template<bool Condition, typename T=void>
     using disable_if_t = std::enable_if_t<not Condition, T>;
 
+    //Cache of bin positions, taken from the current memory resource
+    template<typename RandomAccessIter>
+    using bin_cache_t = std::vector<
+        RandomAccessIter,
+        cppsort::detail::resource_allocator<RandomAccessIter>
+    >;
+
     //This only works on unsigned data types
     template<typename T>
     auto rough_log_2_size(const T& input)
@@ -116,7 +124,7 @@ namespace detail
     // This generates the memory overhead to use in radix sorting.
     template<typename RandomAccessIterator>
     auto size_bins(std::size_t *bin_sizes,
-                   std::vector<RandomAccessIterator> &bin_cache,
+                   bin_cache_t<RandomAccessIterator> &bin_cache,
                    unsigned cache_offset, unsigned &cache_end,
                    unsigned bin_count)
         -> RandomAccessIterator*
@@ -130,7 +130,7 @@ namespace detail
     template<typename RandomAccessIter, typename Div_type,
              typename Size_type, typename Projection>
     auto positive_float_sort_rec(RandomAccessIter first, RandomAccessIter last,
-                                 std::vector<RandomAccessIter> &bin_cache, unsigned cache_offset,
+                                 bin_cache_t<RandomAccessIter> &bin_cache, unsigned cache_offset,
                                  std::size_t *bin_sizes, Projection projection)
         -> void
     {
@@ -195,7 +195,7 @@ namespace detail
     template<typename RandomAccessIter, typename Div_type,
              typename Size_type, typename Projection>
     auto negative_float_sort_rec(RandomAccessIter first, RandomAccessIter last,
-                                 std::vector<RandomAccessIter> &bin_cache,
+                                 bin_cache_t<RandomAccessIter> &bin_cache,
                                  unsigned cache_offset, std::size_t *bin_sizes,
                                  Projection projection)
         -> void
@@ -261,7 +261,7 @@ namespace detail
     template<typename RandomAccessIter, typename Div_type,
              typename Size_type, typename Projection>
     auto float_sort_rec(RandomAccessIter first, RandomAccessIter last,
-                        std::vector<RandomAccessIter> &bin_cache, unsigned cache_offset,
+                        bin_cache_t<RandomAccessIter> &bin_cache, unsigned cache_offset,
                         std::size_t *bin_sizes, Projection projection)
         -> void
     {
@@ -370,7 +370,7 @@ namespace detail
         >
     {
       std::size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_cache_t<RandomAccessIter> bin_cache;
       float_sort_rec<RandomAccessIter, std::int32_t, std::uint32_t>
         (first, last, bin_cache, 0, bin_sizes, projection);
     }
@@ -385,7 +385,7 @@ namespace detail
         >
     {
       std::size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_cache_t<RandomAccessIter> bin_cache;
       float_sort_rec<RandomAccessIter, std::int64_t, std::uint64_t>
         (first, last, bin_cache, 0, bin_sizes, projection);
     }
@@ -96,7 +96,7 @@ namespace spreadsort
     template<typename RandomAccessIter, typename Div_type,
              typename Size_type, typename Projection>
     auto spreadsort_rec(RandomAccessIter first, RandomAccessIter last,
-                        std::vector<RandomAccessIter> &bin_cache, unsigned cache_offset,
+                        bin_cache_t<RandomAccessIter> &bin_cache, unsigned cache_offset,
                         std::size_t *bin_sizes, Projection projection)
         -> void
     {
@@ -208,7 +208,7 @@ namespace spreadsort
         >
     {
       std::size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_cache_t<RandomAccessIter> bin_cache;
       spreadsort_rec<RandomAccessIter, Div_type, std::size_t, Projection>(
           first, last, bin_cache, 0, bin_sizes, projection);
     }
@@ -225,7 +225,7 @@ namespace spreadsort
         >
     {
       std::size_t bin_sizes[1 << max_finishing_splits];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_cache_t<RandomAccessIter> bin_cache;
       spreadsort_rec<RandomAccessIter, Div_type, std::uintmax_t, Projection>(
           first, last, bin_cache, 0, bin_sizes, projection);
     }
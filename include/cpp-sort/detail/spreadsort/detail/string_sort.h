@@ -155,7 +155,7 @@ namespace spreadsort
     template<typename Unsigned_char_type, typename RandomAccessIter, typename Projection>
     auto string_sort_rec(RandomAccessIter first, RandomAccessIter last,
                          std::size_t char_offset,
-                         std::vector<RandomAccessIter> &bin_cache,
+                         bin_cache_t<RandomAccessIter> &bin_cache,
                          unsigned cache_offset, std::size_t *bin_sizes,
                          Projection projection)
         -> void
@@ -265,7 +265,7 @@ namespace spreadsort
     template<typename Unsigned_char_type, typename RandomAccessIter, typename Projection>
     auto reverse_string_sort_rec(RandomAccessIter first, RandomAccessIter last,
                                  std::size_t char_offset,
-                                 std::vector<RandomAccessIter> &bin_cache,
+                                 bin_cache_t<RandomAccessIter> &bin_cache,
                                  unsigned cache_offset, std::size_t *bin_sizes,
                                  Projection projection)
         -> void
@@ -383,7 +383,7 @@ namespace spreadsort
         -> std::enable_if_t<sizeof(Unsigned_char_type) <= 2, void>
     {
       std::size_t bin_sizes[(1 << (8 * sizeof(Unsigned_char_type))) + 1];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_cache_t<RandomAccessIter> bin_cache;
       string_sort_rec<Unsigned_char_type>(first, last, 0, bin_cache, 0,
                                           bin_sizes, projection);
     }
@@ -396,7 +396,7 @@ namespace spreadsort
         -> std::enable_if_t<sizeof(Unsigned_char_type) <= 2, void>
     {
       std::size_t bin_sizes[(1 << (8 * sizeof(Unsigned_char_type))) + 1];
-      std::vector<RandomAccessIter> bin_cache;
+      bin_cache_t<RandomAccessIter> bin_cache;
       reverse_string_sort_rec<Unsigned_char_type>(first, last, 0, bin_cache, 0,
                                                   bin_sizes, projection);
     }
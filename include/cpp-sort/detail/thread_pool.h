@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_THREAD_POOL_H_
+#define CPPSORT_DETAIL_THREAD_POOL_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/utility/memory_resource.h>
+#include <cpp-sort/utility/thread_pool.h>
+
+namespace cppsort
+{
+namespace detail
+{
+    // The pool itself is part of the public interface, the rest of
+    // this header is the machinery used by the parallel algorithms
+    using utility::thread_pool;
+
+    inline auto default_thread_pool()
+        -> thread_pool&
+    {
+        static thread_pool pool(
+            std::max(std::thread::hardware_concurrency(), 1u) - 1
+        );
+        return pool;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Thread pool of a parallel sorter
+
+    // Parallel sorters schedule their tasks on the pool shared by
+    // the whole library, unless they were constructed with a
+    // reference to another pool, which must outlive them
+
+    class thread_pool_storage
+    {
+        private:
+
+            thread_pool* pool = nullptr;
+
+        public:
+
+            thread_pool_storage() = default;
+
+            constexpr explicit thread_pool_storage(thread_pool& pool) noexcept:
+                pool(&pool)
+            {}
+
+            auto get_pool() const
+                -> thread_pool&
+            {
+                return pool ? *pool : default_thread_pool();
+            }
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Fork-join group of tasks
+
+    // Tasks spawned in a group must be complete before the group is
+    // destroyed since they generally refer to the stack frame that
+    // spawned them; the first exception thrown by a task is stored
+    // and rethrown by wait()
+
+    class task_group
+    {
+        private:
+
+            thread_pool& pool;
+            std::atomic<std::size_t> outstanding{0};
+            std::mutex exception_mutex;
+            std::exception_ptr exception;
+
+        public:
+
+            explicit task_group(thread_pool& pool=default_thread_pool()):
+                pool(pool)
+            {}
+
+            task_group(const task_group&) = delete;
+            task_group& operator=(const task_group&) = delete;
+
+            ~task_group()
+            {
+                wait_no_throw();
+            }
+
+            auto concurrency() const noexcept
+                -> std::size_t
+            {
+                return pool.concurrency();
+            }
+
+            // Pool running the tasks of the group, nested groups
+            // should generally be created from the same pool
+            auto get_pool() const noexcept
+                -> thread_pool&
+            {
+                return pool;
+            }
+
+            template<typename Function>
+            auto spawn(Function&& function)
+                -> void
+            {
+                ++outstanding;
+                try {
+                    // The task draws its scratch memory from the resource
+                    // of the thread that spawned it, wherever it runs
+                    auto resource = utility::detail::current_memory_resource();
+                    pool.submit([this, resource, func=std::decay_t<Function>(std::forward<Function>(function))]() mutable {
+                        utility::scoped_memory_resource _(resource);
+                        try {
+                            func();
+                        } catch (...) {
+                            std::lock_guard<std::mutex> lock(exception_mutex);
+                            if (not exception) {
+                                exception = std::current_exception();
+                            }
+                        }
+                        --outstanding;
+                    });
+                } catch (...) {
+                    --outstanding;
+                    throw;
+                }
+            }
+
+            // Waits for the tasks without reporting their exceptions, meant
+            // to be called before cleaning up after an error
+            auto wait_no_throw() noexcept
+                -> void
+            {
+                while (outstanding.load() > 0) {
+                    if (not pool.try_run_pending_task()) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+
+            auto wait()
+                -> void
+            {
+                wait_no_throw();
+                if (exception) {
+                    std::rethrow_exception(std::exchange(exception, nullptr));
+                }
+            }
+    };
+
+    // Runs a task that can't throw in the group, or in the current
+    // thread when it can't be spawned, which ensures that a pass of
+    // work split between several tasks never stops halfway through
+    template<typename Function>
+    auto spawn_or_run(task_group& group, const Function& function)
+        -> void
+    {
+        try {
+            group.spawn(function);
+        } catch (...) {
+            function();
+        }
+    }
+}}
+
+#endif // CPPSORT_DETAIL_THREAD_POOL_H_
@@ -89,7 +89,7 @@ namespace detail
         // Silence GCC -Winline warning
         ~TimSort() noexcept {}
 
-        std::vector<run<iterator>> pending_;
+        std::vector<run<iterator>, resource_allocator<run<iterator>>> pending_;
 
         static auto sort(iterator const lo, iterator const hi, Compare compare, Projection projection)
             -> void
@@ -413,7 +413,7 @@ namespace detail
                 buffer.reset(nullptr);
                 buffer.get_deleter() = operator_deleter(new_size * sizeof(rvalue_reference));
                 buffer.reset(static_cast<rvalue_reference*>(
-                    ::operator new(new_size * sizeof(rvalue_reference))
+                    detail::allocate(new_size * sizeof(rvalue_reference))
                 ));
                 buffer_size = new_size;
             }
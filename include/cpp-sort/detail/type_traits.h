@@ -281,6 +281,23 @@ namespace detail
     struct is_unsigned<__uint128_t>:
         std::true_type
     {};
+
+    template<typename T>
+    struct make_unsigned:
+        std::make_unsigned<T>
+    {};
+
+    template<>
+    struct make_unsigned<__int128_t>
+    {
+        using type = __uint128_t;
+    };
+
+    template<>
+    struct make_unsigned<__uint128_t>
+    {
+        using type = __uint128_t;
+    };
 #else
     template<typename T>
     using is_integral = std::is_integral<T>;
@@ -290,7 +307,13 @@ namespace detail
 
     template<typename T>
     using is_unsigned = std::is_unsigned<T>;
+
+    template<typename T>
+    using make_unsigned = std::make_unsigned<T>;
 #endif
+
+    template<typename T>
+    using make_unsigned_t = typename make_unsigned<T>::type;
 }}
 
 #endif // CPPSORT_DETAIL_TYPE_TRAITS_H_
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017 Morwenn
+ * Copyright (c) 2015-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #ifndef CPPSORT_FIXED_SORTING_NETWORK_SORTER_H_
@@ -9,11 +9,17 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <cstddef>
+#include <functional>
 #include <iterator>
 #include <type_traits>
 #include <utility>
 #include <cpp-sort/sorter_facade.h>
 #include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/iter_move.h>
+#include "../detail/iterator_traits.h"
+#include "../detail/simd_sorting_network.h"
+#include "../detail/type_traits.h"
 
 namespace cppsort
 {
@@ -30,11 +36,70 @@ namespace cppsort
                 "sorting_network_sorter has no specialization for this size of N"
             );
         };
+
+        // Sorting arithmetic types with std::less<> or std::greater<> only
+        // requires min/max operations: when the target architecture has
+        // vector instructions for the type, the network runs in a single
+        // vector register instead of performing the compare-exchange
+        // units one after the other
+
+        template<typename RandomAccessIterator, typename Compare, typename Projection, std::size_t N>
+        struct can_use_simd_sorting_network:
+            conjunction<
+                has_simd_sorting_network<value_type_t<RandomAccessIterator>, N>,
+                std::is_same<reference_t<RandomAccessIterator>, value_type_t<RandomAccessIterator>&>,
+                negation<is_detected<utility::detail::has_iter_move_t, RandomAccessIterator>>,
+                negation<is_detected<utility::detail::has_iter_swap_t, RandomAccessIterator>>,
+                disjunction<
+                    std::is_same<Compare, std::less<>>,
+                    std::is_same<Compare, std::greater<>>
+                >,
+                std::is_same<Projection, utility::identity>
+            >
+        {};
+
+        template<std::size_t N>
+        struct sorting_network_sorter_dispatcher
+        {
+            template<
+                typename RandomAccessIterator,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<is_projection_iterator_v<
+                    Projection, RandomAccessIterator, Compare
+                >>
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Compare compare={}, Projection projection={}) const
+                -> void
+            {
+                sort(std::move(first), std::move(last),
+                     std::move(compare), std::move(projection),
+                     can_use_simd_sorting_network<RandomAccessIterator, Compare, Projection, N>{});
+            }
+
+            template<typename RandomAccessIterator, typename Compare, typename Projection>
+            static auto sort(RandomAccessIterator first, RandomAccessIterator last,
+                             Compare compare, Projection projection, std::false_type)
+                -> void
+            {
+                sorting_network_sorter_impl<N>{}(std::move(first), std::move(last),
+                                                 std::move(compare), std::move(projection));
+            }
+
+            template<typename RandomAccessIterator, typename Compare, typename Projection>
+            static auto sort(RandomAccessIterator first, RandomAccessIterator,
+                             Compare, Projection, std::true_type)
+                -> void
+            {
+                simd_sorting_network<N, std::is_same<Compare, std::greater<>>::value>(first);
+            }
+        };
     }
 
     template<std::size_t N>
     struct sorting_network_sorter:
-        sorter_facade<detail::sorting_network_sorter_impl<N>>
+        sorter_facade<detail::sorting_network_sorter_dispatcher<N>>
     {};
 
     ////////////////////////////////////////////////////////////
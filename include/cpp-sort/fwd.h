@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2019 Morwenn
+ * Copyright (c) 2016-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #ifndef CPPSORT_FWD_H_
@@ -24,6 +24,7 @@ namespace cppsort
     ////////////////////////////////////////////////////////////
     // Sorters
 
+    struct adaptive_sorter;
     template<typename BufferProvider>
     struct block_sorter;
     struct counting_sorter;
@@ -37,6 +38,16 @@ namespace cppsort
     struct integer_spread_sorter;
     struct merge_insertion_sorter;
     struct merge_sorter;
+    template<std::size_t SequentialThreshold>
+    struct parallel_counting_sorter;
+    template<std::size_t SequentialThreshold>
+    struct parallel_merge_sorter;
+    template<std::size_t SequentialThreshold>
+    struct parallel_pdq_sorter;
+    template<std::size_t SequentialThreshold>
+    struct parallel_ska_sorter;
+    template<std::size_t SequentialThreshold>
+    struct parallel_spread_sorter;
     struct pdq_sorter;
     struct poplar_sorter;
     struct quick_merge_sorter;
@@ -75,7 +86,7 @@ namespace cppsort
     struct indirect_adapter;
     template<typename Sorter>
     struct out_of_place_adapter;
-    template<typename Sorter>
+    template<typename Sorter, typename KeyEncoding=void>
     struct schwartz_adapter;
     template<typename Sorter>
     struct self_sort_adapter;
@@ -85,6 +96,8 @@ namespace cppsort
     struct stable_adapter;
     template<typename Sorter>
     struct verge_adapter;
+    template<typename Sorter>
+    struct workspace_adapter;
 }
 
 #endif // CPPSORT_FWD_H_
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018 Morwenn
+ * Copyright (c) 2016-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #ifndef CPPSORT_PROBES_H_
@@ -8,9 +8,11 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <cpp-sort/probes/accumulators.h>
 #include <cpp-sort/probes/dis.h>
 #include <cpp-sort/probes/enc.h>
 #include <cpp-sort/probes/exc.h>
+#include <cpp-sort/probes/fused.h>
 #include <cpp-sort/probes/ham.h>
 #include <cpp-sort/probes/inv.h>
 #include <cpp-sort/probes/max.h>
@@ -19,5 +21,8 @@
 #include <cpp-sort/probes/par.h>
 #include <cpp-sort/probes/rem.h>
 #include <cpp-sort/probes/runs.h>
+#include <cpp-sort/probes/sampled_inv.h>
+#include <cpp-sort/probes/sampled_rem.h>
+#include <cpp-sort/probes/sampled_runs.h>
 
 #endif // CPPSORT_PROBES_H_
@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_PROBES_ACCUMULATORS_H_
+#define CPPSORT_PROBES_ACCUMULATORS_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/functional.h>
+#include "../detail/upper_bound.h"
+
+namespace cppsort
+{
+namespace probe
+{
+    //
+    // Accumulators compute a measure of presortedness over a sequence
+    // that is received chunk by chunk: they only keep what the measure
+    // needs to know about the elements seen so far, which are never
+    // looked at again, so the projected elements are copied
+    //
+
+    namespace detail
+    {
+        template<typename T, typename Compare, typename Projection>
+        class accumulator_base
+        {
+            public:
+
+                ////////////////////////////////////////////////////////////
+                // Public types
+
+                using value_type = T;
+                using key_type = std::decay_t<decltype(utility::as_function(std::declval<Projection&>())(
+                    std::declval<const T&>()
+                ))>;
+                using difference_type = std::ptrdiff_t;
+
+                ////////////////////////////////////////////////////////////
+                // Construction
+
+                accumulator_base() = default;
+
+                explicit accumulator_base(Compare compare, Projection projection={}):
+                    compare(std::move(compare)),
+                    projection(std::move(projection))
+                {}
+
+                ////////////////////////////////////////////////////////////
+                // Accessors
+
+                // Number of elements pushed so far
+                auto size() const noexcept
+                    -> difference_type
+                {
+                    return _size;
+                }
+
+            protected:
+
+                auto project(const T& value)
+                    -> key_type
+                {
+                    return utility::as_function(projection)(value);
+                }
+
+                auto less(const key_type& lhs, const key_type& rhs)
+                    -> bool
+                {
+                    return utility::as_function(compare)(lhs, rhs);
+                }
+
+                Compare compare;
+                Projection projection;
+                difference_type _size = 0;
+        };
+
+        // Remembers the last element pushed
+        template<typename T, typename Compare, typename Projection>
+        class last_element_accumulator:
+            public accumulator_base<T, Compare, Projection>
+        {
+            using base = accumulator_base<T, Compare, Projection>;
+
+            public:
+
+                using base::base;
+
+            protected:
+
+                auto last() const
+                    -> const typename base::key_type&
+                {
+                    return _last.front();
+                }
+
+                auto set_last(typename base::key_type&& key)
+                    -> void
+                {
+                    // The vector holds at most one element, it avoids
+                    // requiring default-constructible keys
+                    if (_last.empty()) {
+                        _last.push_back(std::move(key));
+                    } else {
+                        _last.front() = std::move(key);
+                    }
+                }
+
+            private:
+
+                std::vector<typename base::key_type> _last;
+        };
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Runs
+
+    template<
+        typename T,
+        typename Compare = std::less<>,
+        typename Projection = utility::identity
+    >
+    class runs_accumulator:
+        public detail::last_element_accumulator<T, Compare, Projection>
+    {
+        using base = detail::last_element_accumulator<T, Compare, Projection>;
+
+        public:
+
+            using base::base;
+            using typename base::difference_type;
+
+            auto push(const T& element)
+                -> void
+            {
+                auto key = this->project(element);
+                if (this->_size > 0 && this->less(key, this->last())) {
+                    ++_count;
+                }
+                this->set_last(std::move(key));
+                ++this->_size;
+            }
+
+            template<typename InputIterator>
+            auto push(InputIterator first, InputIterator last)
+                -> void
+            {
+                for (; first != last ; ++first) {
+                    push(*first);
+                }
+            }
+
+            // Runs of the elements pushed so far, O(1)
+            auto value() const noexcept
+                -> difference_type
+            {
+                return _count;
+            }
+
+        private:
+
+            difference_type _count = 0;
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Mono
+
+    template<
+        typename T,
+        typename Compare = std::less<>,
+        typename Projection = utility::identity
+    >
+    class mono_accumulator:
+        public detail::last_element_accumulator<T, Compare, Projection>
+    {
+        using base = detail::last_element_accumulator<T, Compare, Projection>;
+
+        public:
+
+            using base::base;
+            using typename base::difference_type;
+
+            auto push(const T& element)
+                -> void
+            {
+                auto key = this->project(element);
+                if (this->_size > 0) {
+                    // The element that ends a run starts the next one,
+                    // whose direction is unknown until two elements
+                    // compare unequal
+                    switch (_run) {
+                        case unknown_run:
+                            if (this->less(key, this->last())) {
+                                _run = descending_run;
+                            } else if (this->less(this->last(), key)) {
+                                _run = ascending_run;
+                            }
+                            break;
+                        case ascending_run:
+                            if (this->less(key, this->last())) {
+                                ++_count;
+                                _run = unknown_run;
+                            }
+                            break;
+                        case descending_run:
+                            if (this->less(this->last(), key)) {
+                                ++_count;
+                                _run = unknown_run;
+                            }
+                            break;
+                    }
+                }
+                this->set_last(std::move(key));
+                ++this->_size;
+            }
+
+            template<typename InputIterator>
+            auto push(InputIterator first, InputIterator last)
+                -> void
+            {
+                for (; first != last ; ++first) {
+                    push(*first);
+                }
+            }
+
+            // Mono of the elements pushed so far, O(1)
+            auto value() const noexcept
+                -> difference_type
+            {
+                return _count;
+            }
+
+        private:
+
+            enum { unknown_run, ascending_run, descending_run } _run = unknown_run;
+            difference_type _count = 0;
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Rem
+
+    template<
+        typename T,
+        typename Compare = std::less<>,
+        typename Projection = utility::identity
+    >
+    class rem_accumulator:
+        public detail::accumulator_base<T, Compare, Projection>
+    {
+        using base = detail::accumulator_base<T, Compare, Projection>;
+
+        public:
+
+            using base::base;
+            using typename base::difference_type;
+            using typename base::key_type;
+
+            auto push(const T& element)
+                -> void
+            {
+                // Patience sorting: the longest non-decreasing subsequence
+                // is as long as the number of stacks
+                auto key = this->project(element);
+                auto it = cppsort::detail::upper_bound(
+                    _stack_tops.begin(), _stack_tops.end(), key,
+                    utility::as_function(this->compare), utility::identity{});
+                if (it == _stack_tops.end()) {
+                    _stack_tops.push_back(std::move(key));
+                } else {
+                    *it = std::move(key);
+                }
+                ++this->_size;
+            }
+
+            template<typename InputIterator>
+            auto push(InputIterator first, InputIterator last)
+                -> void
+            {
+                for (; first != last ; ++first) {
+                    push(*first);
+                }
+            }
+
+            // Rem of the elements pushed so far, O(1)
+            auto value() const noexcept
+                -> difference_type
+            {
+                return this->_size - static_cast<difference_type>(_stack_tops.size());
+            }
+
+        private:
+
+            // Top (smaller) elements in patience sorting stacks
+            std::vector<key_type> _stack_tops;
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Dis
+
+    template<
+        typename T,
+        typename Compare = std::less<>,
+        typename Projection = utility::identity
+    >
+    class dis_accumulator:
+        public detail::accumulator_base<T, Compare, Projection>
+    {
+        using base = detail::accumulator_base<T, Compare, Projection>;
+
+        public:
+
+            using base::base;
+            using typename base::difference_type;
+            using typename base::key_type;
+
+            auto push(const T& element)
+                -> void
+            {
+                // The farthest element that forms an inversion with the
+                // new one is the first prefix maximum greater than it
+                auto key = this->project(element);
+                auto it = cppsort::detail::upper_bound(
+                    _records.begin(), _records.end(), key,
+                    utility::as_function(this->compare), utility::identity{});
+                if (it != _records.end()) {
+                    auto pos = _record_positions[it - _records.begin()];
+                    _max_dist = std::max(_max_dist, this->_size - pos);
+                } else if (_records.empty() || this->less(_records.back(), key)) {
+                    _records.push_back(std::move(key));
+                    _record_positions.push_back(this->_size);
+                }
+                ++this->_size;
+            }
+
+            template<typename InputIterator>
+            auto push(InputIterator first, InputIterator last)
+                -> void
+            {
+                for (; first != last ; ++first) {
+                    push(*first);
+                }
+            }
+
+            // Dis of the elements pushed so far, O(1)
+            auto value() const noexcept
+                -> difference_type
+            {
+                return _max_dist;
+            }
+
+        private:
+
+            // Elements greater than every element before them, and their
+            // positions in the sequence
+            std::vector<key_type> _records;
+            std::vector<difference_type> _record_positions;
+            difference_type _max_dist = 0;
+    };
+}}
+
+#endif // CPPSORT_PROBES_ACCUMULATORS_H_
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_PROBES_ESTIMATE_H_
+#define CPPSORT_PROBES_ESTIMATE_H_
+
+namespace cppsort
+{
+namespace probe
+{
+    // Result of the sampled measures of presortedness: an estimate
+    // of the measure and an interval that contains the exact value
+    // of the measure with a probability of about 95%
+    template<typename T>
+    struct estimate
+    {
+        T value;
+        T lower;
+        T upper;
+    };
+}}
+
+#endif // CPPSORT_PROBES_ESTIMATE_H_
@@ -8,8 +8,11 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <algorithm>
 #include <functional>
 #include <iterator>
+#include <memory>
+#include <numeric>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -19,7 +22,6 @@
 #include <cpp-sort/utility/functional.h>
 #include <cpp-sort/utility/size.h>
 #include <cpp-sort/utility/static_const.h>
-#include "../detail/indirect_compare.h"
 #include "../detail/iterator_traits.h"
 #include "../detail/pdqsort.h"
 
@@ -29,6 +31,65 @@ namespace probe
 {
     namespace detail
     {
+        // Computes Exc from the positions of the elements in sorted
+        // order, where compare_positions compares the elements at the
+        // given positions; positions is left in an unspecified state
+        template<typename Difference, typename ComparePositions>
+        auto exc_from_sorted_positions(Difference* positions, Difference size,
+                                       ComparePositions compare_positions)
+            -> Difference
+        {
+            // Equivalent elements can go anywhere in the range of their
+            // group once sorted: the elements already in that range stay
+            // where they are and the other ones take the remaining slots
+            // by increasing original position, which makes the result
+            // independent of the order of equivalent elements
+            Difference group_begin = 0;
+            while (group_begin < size) {
+                Difference pivot = positions[group_begin];
+                Difference group_end = group_begin + 1;
+                while (group_end < size && not compare_positions(pivot, positions[group_end])) {
+                    ++group_end;
+                }
+
+                Difference moved_end = group_begin;
+                for (Difference idx = group_begin ; idx < group_end ; ++idx) {
+                    Difference pos = positions[idx];
+                    if (pos < group_begin || pos >= group_end) {
+                        positions[moved_end++] = pos;
+                    }
+                }
+                std::sort(positions + group_begin, positions + moved_end);
+
+                // Fill backwards to read the moved elements before
+                // their slots are overwritten
+                for (Difference slot = group_end ; slot-- > group_begin ;) {
+                    if (not compare_positions(slot, pivot) && not compare_positions(pivot, slot)) {
+                        positions[slot] = slot;
+                    } else {
+                        positions[slot] = positions[--moved_end];
+                    }
+                }
+                group_begin = group_end;
+            }
+
+            // A cycle of k elements needs k - 1 exchanges, visited
+            // positions are marked as being in place
+            Difference exchanges = 0;
+            for (Difference start = 0 ; start < size ; ++start) {
+                Difference current = start;
+                Difference next = positions[start];
+                while (next != start) {
+                    ++exchanges;
+                    positions[current] = current;
+                    current = next;
+                    next = positions[current];
+                }
+                positions[current] = current;
+            }
+            return exchanges;
+        }
+
         template<typename ForwardIterator, typename Compare, typename Projection>
         auto exc_probe_algo(ForwardIterator first, ForwardIterator last,
                             cppsort::detail::difference_type_t<ForwardIterator> size,
@@ -44,7 +105,7 @@ namespace probe
             }
 
             ////////////////////////////////////////////////////////////
-            // Indirectly sort the iterators
+            // Indirectly sort the positions
 
             // Copy the iterators in a vector
             std::vector<ForwardIterator> iterators;
@@ -53,59 +114,19 @@ namespace probe
                 iterators.push_back(it);
             }
 
-            // Sort the iterators on pointed values
-            pdqsort(
-                iterators.begin(), iterators.end(),
-                cppsort::detail::make_indirect_compare(compare, projection),
-                utility::identity{}
-            );
+            // Sort the positions on pointed values
+            std::unique_ptr<difference_type[]> positions(new difference_type[size]);
+            std::iota(positions.get(), positions.get() + size, difference_type(0));
+            auto compare_positions = [&](difference_type lhs, difference_type rhs) {
+                return comp(proj(*iterators[lhs]), proj(*iterators[rhs]));
+            };
+            cppsort::detail::pdqsort(positions.get(), positions.get() + size,
+                                     compare_positions, utility::identity{});
 
             ////////////////////////////////////////////////////////////
-            // Count the number of cycles
-
-            std::vector<bool> sorted(size, false);
-
-            // Element where the current cycle starts
-            auto start = first;
-
-            difference_type cycles = 0;
-            while (start != last) {
-                // Find the element to put in current's place
-                auto current = start;
-                auto next_pos = std::distance(first, current);
-                auto next = iterators[next_pos];
-                sorted[next_pos] = true;
-
-                // Process the current cycle
-                if (next != current) {
-                    while (next != start) {
-                        // If an element is in the place of another element that compares
-                        // equivalent, it means that this element was actually already in
-                        // a suitable place, so we count one more cycle as if it was an
-                        // already suitably placed element, this handles collections with
-                        // several elements which compare equivalent
-                        if (not comp(proj(*next), proj(*current)) &&
-                            not comp(proj(*current), proj(*next))) {
-                            ++cycles;
-                        }
-                        // Locate the next element of the cycle
-                        current = next;
-                        auto next_pos = std::distance(first, next);
-                        next = iterators[next_pos];
-                        sorted[next_pos] = true;
-                    }
-                }
+            // Count the number of exchanges
 
-                ++cycles;
-
-                // Find the next cycle
-                auto&& sorted_it = sorted.begin() + std::distance(first, start);
-                do {
-                    ++start;
-                    ++sorted_it;
-                } while (start != last && *sorted_it);
-            }
-            return size - cycles;
+            return exc_from_sorted_positions(positions.get(), size, compare_positions);
         }
 
         struct exc_impl
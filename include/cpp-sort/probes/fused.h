@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_PROBES_FUSED_H_
+#define CPPSORT_PROBES_FUSED_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cpp-sort/probes/exc.h>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/static_const.h>
+#include "../detail/count_inversions.h"
+#include "../detail/iterator_traits.h"
+#include "../detail/lower_bound.h"
+#include "../detail/pdqsort.h"
+#include "../detail/upper_bound.h"
+
+namespace cppsort
+{
+namespace probe
+{
+    ////////////////////////////////////////////////////////////
+    // Measures
+
+    // Set of measures computed by fused_probe
+    enum class measure: unsigned
+    {
+        dis  = 1u << 0,
+        enc  = 1u << 1,
+        exc  = 1u << 2,
+        ham  = 1u << 3,
+        inv  = 1u << 4,
+        max  = 1u << 5,
+        mono = 1u << 6,
+        osc  = 1u << 7,
+        rem  = 1u << 8,
+        runs = 1u << 9,
+        all  = (1u << 10) - 1
+    };
+
+    constexpr auto operator|(measure lhs, measure rhs) noexcept
+        -> measure
+    {
+        return static_cast<measure>(static_cast<unsigned>(lhs) | static_cast<unsigned>(rhs));
+    }
+
+    constexpr auto operator&(measure lhs, measure rhs) noexcept
+        -> measure
+    {
+        return static_cast<measure>(static_cast<unsigned>(lhs) & static_cast<unsigned>(rhs));
+    }
+
+    // Result of fused_probe, the measures that were not
+    // requested are left to 0
+    template<typename T>
+    struct measurements
+    {
+        T dis = 0;
+        T enc = 0;
+        T exc = 0;
+        T ham = 0;
+        T inv = 0;
+        T max = 0;
+        T mono = 0;
+        T osc = 0;
+        T rem = 0;
+        T runs = 0;
+    };
+
+    namespace detail
+    {
+        template<measure Measures>
+        struct fused_impl
+        {
+            static constexpr auto has(measure m) noexcept
+                -> bool
+            {
+                return (Measures & m) != measure{};
+            }
+
+            template<
+                typename ForwardIterator,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, ForwardIterator, Compare>
+                >
+            >
+            auto operator()(ForwardIterator first, ForwardIterator last,
+                            Compare compare={}, Projection projection={}) const
+                -> measurements<cppsort::detail::difference_type_t<ForwardIterator>>
+            {
+                using difference_type = cppsort::detail::difference_type_t<ForwardIterator>;
+                auto&& comp = utility::as_function(compare);
+                auto&& proj = utility::as_function(projection);
+
+                measurements<difference_type> res;
+
+                // The measures below need to know where every element
+                // goes once the collection is sorted
+                constexpr bool needs_order = has(
+                    measure::dis | measure::exc | measure::ham |
+                    measure::inv | measure::max | measure::osc
+                );
+
+                ////////////////////////////////////////////////////////////
+                // Single pass measures
+
+                // Iterators in their original order
+                std::vector<ForwardIterator> iterators;
+                // Top (smaller) elements in patience sorting stacks for Rem
+                std::vector<ForwardIterator> stack_tops;
+                // Head and tail of encroaching lists for Enc
+                std::vector<std::pair<ForwardIterator, ForwardIterator>> lists;
+
+                auto deref_proj = [&proj](ForwardIterator it) -> decltype(auto) {
+                    return proj(*it);
+                };
+
+                // Kind of the current run for Mono, equivalent elements
+                // at the beginning of a run don't give its direction
+                enum { unknown_run, ascending_run, descending_run } run = unknown_run;
+
+                difference_type size = 0;
+                ForwardIterator prev = first;
+                for (auto it = first ; it != last ; ++it) {
+                    auto&& value = proj(*it);
+
+                    if (size > 0 && (has(measure::runs) || has(measure::mono))) {
+                        bool step_down = comp(value, proj(*prev));
+                        if (has(measure::runs) && step_down) {
+                            ++res.runs;
+                        }
+                        if (has(measure::mono)) {
+                            // The element that ends a run starts the next one
+                            switch (run) {
+                                case unknown_run:
+                                    if (step_down) {
+                                        run = descending_run;
+                                    } else if (comp(proj(*prev), value)) {
+                                        run = ascending_run;
+                                    }
+                                    break;
+                                case ascending_run:
+                                    if (step_down) {
+                                        ++res.mono;
+                                        run = unknown_run;
+                                    }
+                                    break;
+                                case descending_run:
+                                    if (comp(proj(*prev), value)) {
+                                        ++res.mono;
+                                        run = unknown_run;
+                                    }
+                                    break;
+                            }
+                        }
+                    }
+
+                    if (has(measure::rem)) {
+                        auto top = cppsort::detail::upper_bound(
+                            stack_tops.begin(), stack_tops.end(),
+                            value, comp, deref_proj);
+                        if (top == stack_tops.end()) {
+                            stack_tops.push_back(it);
+                        } else {
+                            *top = it;
+                        }
+                    }
+
+                    if (has(measure::enc)) {
+                        // Binary search for an encroaching list where
+                        // value <= list.first or value >= list.second
+                        bool value_is_smaller = true;
+                        auto count = lists.size();
+                        auto res_it = lists.begin();
+                        while (count > 0) {
+                            auto list_it = res_it + count / 2;
+                            if (not comp(proj(*list_it->first), value)) {
+                                count /= 2;
+                                value_is_smaller = true;
+                            } else if (not comp(value, proj(*list_it->second))) {
+                                count /= 2;
+                                value_is_smaller = false;
+                            } else {
+                                res_it = ++list_it;
+                                count -= count / 2 + 1;
+                            }
+                        }
+
+                        if (res_it == lists.end()) {
+                            lists.emplace_back(it, it);
+                        } else if (value_is_smaller) {
+                            res_it->first = it;
+                        } else {
+                            res_it->second = it;
+                        }
+                    }
+
+                    if (needs_order) {
+                        iterators.push_back(it);
+                    }
+                    prev = it;
+                    ++size;
+                }
+
+                if (size < 2) {
+                    return res;
+                }
+                if (has(measure::rem)) {
+                    res.rem = size - static_cast<difference_type>(stack_tops.size());
+                }
+                if (has(measure::enc)) {
+                    res.enc = static_cast<difference_type>(lists.size()) - 1;
+                }
+                if (not needs_order) {
+                    return res;
+                }
+
+                ////////////////////////////////////////////////////////////
+                // Measures relying on the sorted order
+
+                // The following algorithms work on the positions of the
+                // elements, Dis and Inv share a scratch buffer of positions
+                auto value_at = [&proj, &iterators](difference_type pos) -> decltype(auto) {
+                    return proj(*iterators[pos]);
+                };
+                std::unique_ptr<difference_type[]> buffer;
+                if (has(measure::dis) || has(measure::inv)) {
+                    buffer.reset(new difference_type[size]);
+                }
+
+                if (has(measure::dis)) {
+                    // Position of the smallest element in [pos, size), the
+                    // farthest element smaller than the one at a given
+                    // position is found by binary search in these minima
+                    buffer[size - 1] = size - 1;
+                    for (difference_type pos = size - 1 ; pos > 0 ; --pos) {
+                        buffer[pos - 1] = comp(value_at(pos - 1), value_at(buffer[pos])) ? pos - 1 : buffer[pos];
+                    }
+                    for (difference_type pos = 0 ; pos < size - 1 - res.dis ; ++pos) {
+                        auto bound = cppsort::detail::lower_bound(
+                            buffer.get() + pos + 1, buffer.get() + size,
+                            value_at(pos), compare, value_at
+                        );
+                        res.dis = std::max(res.dis, (bound - buffer.get()) - pos - 1);
+                    }
+                }
+
+                constexpr bool needs_sort = has(
+                    measure::exc | measure::ham | measure::inv |
+                    measure::max | measure::osc
+                );
+                if (not needs_sort) {
+                    return res;
+                }
+
+                // Positions of the elements in sorted order, sorting them by
+                // counting inversions saves a sort when Inv is requested
+                std::unique_ptr<difference_type[]> positions(new difference_type[size]);
+                std::iota(positions.get(), positions.get() + size, difference_type(0));
+                auto compare_positions = [&comp, &value_at](difference_type lhs, difference_type rhs) {
+                    return comp(value_at(lhs), value_at(rhs));
+                };
+                if (has(measure::inv)) {
+                    res.inv = cppsort::detail::count_inversions<difference_type>(
+                        positions.get(), positions.get() + size,
+                        buffer.get(), compare_positions
+                    );
+                } else {
+                    cppsort::detail::pdqsort(positions.get(), positions.get() + size,
+                                             compare_positions, utility::identity{});
+                }
+
+                if (has(measure::ham)) {
+                    for (difference_type pos = 0 ; pos < size ; ++pos) {
+                        if (compare_positions(pos, positions[pos]) ||
+                            compare_positions(positions[pos], pos)) {
+                            ++res.ham;
+                        }
+                    }
+                }
+
+                if (has(measure::max)) {
+                    // Every element can go anywhere in the range of the
+                    // elements equivalent to it once sorted
+                    difference_type group_begin = 0;
+                    while (group_begin < size) {
+                        difference_type group_end = group_begin + 1;
+                        while (group_end < size &&
+                               not compare_positions(positions[group_begin], positions[group_end])) {
+                            ++group_end;
+                        }
+                        for (difference_type sorted_pos = group_begin ; sorted_pos < group_end ; ++sorted_pos) {
+                            difference_type pos = positions[sorted_pos];
+                            if (pos < group_begin) {
+                                res.max = std::max(group_begin - pos, res.max);
+                            } else if (pos >= group_end) {
+                                res.max = std::max(pos - group_end + 1, res.max);
+                            }
+                        }
+                        group_begin = group_end;
+                    }
+                }
+
+                if (has(measure::osc)) {
+                    // Count the elements strictly between the elements of
+                    // every pair of adjacent elements
+                    for (difference_type pos = 0 ; pos < size - 1 ; ++pos) {
+                        difference_type lhs = pos;
+                        difference_type rhs = pos + 1;
+                        if (compare_positions(rhs, lhs)) {
+                            std::swap(lhs, rhs);
+                        } else if (not compare_positions(lhs, rhs)) {
+                            continue;
+                        }
+                        auto lower = cppsort::detail::upper_bound_n(positions.get(), size,
+                                                                    value_at(lhs), compare, value_at);
+                        auto upper = cppsort::detail::lower_bound_n(positions.get(), size,
+                                                                    value_at(rhs), compare, value_at);
+                        res.osc += upper - lower;
+                    }
+                }
+
+                if (has(measure::exc)) {
+                    res.exc = exc_from_sorted_positions(positions.get(), size, compare_positions);
+                }
+
+                return res;
+            }
+        };
+    }
+
+    template<measure Measures>
+    struct fused_probe:
+        sorter_facade<detail::fused_impl<Measures>>
+    {};
+
+    namespace
+    {
+        constexpr auto&& fused = utility::static_const<
+            fused_probe<measure::all>
+        >::value;
+    }
+}}
+
+#endif // CPPSORT_PROBES_FUSED_H_
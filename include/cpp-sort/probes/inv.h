@@ -8,19 +8,23 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <algorithm>
 #include <functional>
 #include <iterator>
 #include <memory>
 #include <type_traits>
 #include <utility>
+#include <vector>
 #include <cpp-sort/sorter_facade.h>
 #include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/as_function.h>
 #include <cpp-sort/utility/functional.h>
 #include <cpp-sort/utility/size.h>
 #include <cpp-sort/utility/static_const.h>
 #include "../detail/count_inversions.h"
 #include "../detail/indirect_compare.h"
 #include "../detail/iterator_traits.h"
+#include "../detail/memory.h"
 
 namespace cppsort
 {
@@ -28,33 +32,126 @@ namespace probe
 {
     namespace detail
     {
-        template<typename ForwardIterator, typename Compare, typename Projection>
-        auto inv_probe_algo(ForwardIterator first, ForwardIterator last,
-                            cppsort::detail::difference_type_t<ForwardIterator> size,
-                            Compare compare, Projection projection)
+        // Inversions can be counted directly on a copy of the projected
+        // elements when they are arithmetic types compared with the
+        // usual operators
+        template<typename Compare, typename Key>
+        using can_count_key_inversions = std::integral_constant<bool,
+            std::is_arithmetic<Key>::value && (
+                std::is_same<Compare, std::less<>>::value ||
+                std::is_same<Compare, std::greater<>>::value
+            )
+        >;
+
+        template<typename ResultType, typename Key, typename Counter>
+        auto inv_probe_keys(Key* keys, ResultType size, Counter counter, std::true_type /* integer keys */)
+            -> ResultType
+        {
+            auto bounds = std::minmax_element(keys, keys + size);
+            auto max_rank = cppsort::detail::inversions_key_rank(*bounds.second, *bounds.first);
+            if (cppsort::detail::use_inversions_fenwick_tree(size, max_rank)) {
+                return counter.template bounded_keys<ResultType>(keys, size, *bounds.first, max_rank + 1);
+            }
+
+            auto buffer = cppsort::detail::make_inversions_keys_buffer<Key>(size);
+            return counter.template keys<ResultType>(keys, buffer.get(), size);
+        }
+
+        template<typename ResultType, typename Key, typename Counter>
+        auto inv_probe_keys(Key* keys, ResultType size, Counter counter, std::false_type /* integer keys */)
+            -> ResultType
+        {
+            auto buffer = cppsort::detail::make_inversions_keys_buffer<Key>(size);
+            return counter.template keys<ResultType>(keys, buffer.get(), size);
+        }
+
+        template<typename ForwardIterator, typename Compare, typename Projection, typename Counter>
+        auto inv_probe_dispatch(ForwardIterator first, ForwardIterator last,
+                              cppsort::detail::difference_type_t<ForwardIterator> size,
+                              Compare, Projection projection, Counter counter,
+                              std::true_type /* key inversions */)
             -> ::cppsort::detail::difference_type_t<ForwardIterator>
         {
-            using difference_type = ::cppsort::detail::difference_type_t<ForwardIterator>;
+            using key_type = cppsort::detail::projected_t<ForwardIterator, Projection>;
+            auto&& proj = utility::as_function(projection);
 
-            if (size < 2) {
-                return 0;
+            // Inversions in descending order are inversions in ascending
+            // order of the reversed sequence
+            auto keys = cppsort::detail::make_inversions_keys_buffer<key_type>(size);
+            if (std::is_same<Compare, std::greater<>>::value) {
+                auto store = keys.get() + size;
+                for (ForwardIterator it = first ; it != last ; ++it) {
+                    *--store = proj(*it);
+                }
+            } else {
+                auto store = keys.get();
+                for (ForwardIterator it = first ; it != last ; ++it) {
+                    *store++ = proj(*it);
+                }
             }
 
-            auto iterators = std::make_unique<ForwardIterator[]>(size);
-            auto buffer = std::make_unique<ForwardIterator[]>(size);
+            using is_integer_key = std::integral_constant<bool,
+                std::is_integral<key_type>::value &&
+                not std::is_same<key_type, bool>::value
+            >;
+            return inv_probe_keys(keys.get(), size, counter, is_integer_key{});
+        }
+
+        template<typename ForwardIterator, typename Compare, typename Projection, typename Counter>
+        auto inv_probe_dispatch(ForwardIterator first, ForwardIterator last,
+                              cppsort::detail::difference_type_t<ForwardIterator> size,
+                              Compare compare, Projection projection, Counter counter,
+                              std::false_type /* key inversions */)
+            -> ::cppsort::detail::difference_type_t<ForwardIterator>
+        {
+            using difference_type = ::cppsort::detail::difference_type_t<ForwardIterator>;
+
+            using iterators_type = std::vector<
+                ForwardIterator,
+                cppsort::detail::resource_allocator<ForwardIterator>
+            >;
+            iterators_type iterators(size);
+            iterators_type buffer(size);
 
-            auto store = iterators.get();
+            auto store = iterators.data();
             for (ForwardIterator it = first ; it != last ; ++it) {
                 *store++ = it;
             }
 
-            return cppsort::detail::count_inversions<difference_type>(
-                iterators.get(), iterators.get() + size, buffer.get(),
+            return counter.template iterators<difference_type>(
+                iterators.data(), buffer.data(), size,
                 cppsort::detail::indirect_compare<Compare, Projection>(std::move(compare),
                                                                        std::move(projection))
             );
         }
 
+        template<typename ForwardIterator, typename Compare, typename Projection, typename Counter>
+        auto inv_probe_algo(ForwardIterator first, ForwardIterator last,
+                            cppsort::detail::difference_type_t<ForwardIterator> size,
+                            Compare compare, Projection projection, Counter counter)
+            -> ::cppsort::detail::difference_type_t<ForwardIterator>
+        {
+            if (size < 2) {
+                return 0;
+            }
+
+            using key_type = cppsort::detail::projected_t<ForwardIterator, Projection>;
+            return inv_probe_dispatch(first, last, size,
+                                      std::move(compare), std::move(projection), counter,
+                                      can_count_key_inversions<Compare, key_type>{});
+        }
+
+        template<typename ForwardIterator, typename Compare, typename Projection>
+        auto inv_probe_algo(ForwardIterator first, ForwardIterator last,
+                            cppsort::detail::difference_type_t<ForwardIterator> size,
+                            Compare compare, Projection projection)
+            -> ::cppsort::detail::difference_type_t<ForwardIterator>
+        {
+            return inv_probe_algo(first, last, size,
+                                  std::move(compare), std::move(projection),
+                                  cppsort::detail::sequential_inversions_counter{});
+        }
+
         struct inv_impl
         {
             template<
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017 Morwenn
+ * Copyright (c) 2016-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #ifndef CPPSORT_PROBES_OSC_H_
@@ -58,8 +58,8 @@ namespace probe
 
                     while (next != last)
                     {
-                        if (comp(std::min(proj(*current), proj(*next)), value) &&
-                            comp(value, std::max(proj(*current), proj(*next))))
+                        if (comp(std::min(proj(*current), proj(*next), comp), value) &&
+                            comp(value, std::max(proj(*current), proj(*next), comp)))
                         {
                             ++count;
                         }
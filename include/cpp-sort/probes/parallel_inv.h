@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_PROBES_PARALLEL_INV_H_
+#define CPPSORT_PROBES_PARALLEL_INV_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/probes/inv.h>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/size.h>
+#include <cpp-sort/utility/static_const.h>
+#include "../detail/parallel_count_inversions.h"
+#include "../detail/thread_pool.h"
+
+namespace cppsort
+{
+namespace probe
+{
+    namespace detail
+    {
+        template<typename ForwardIterator, typename Compare, typename Projection>
+        auto parallel_inv_probe_algo(ForwardIterator first, ForwardIterator last,
+                                     cppsort::detail::difference_type_t<ForwardIterator> size,
+                                     Compare compare, Projection projection)
+            -> ::cppsort::detail::difference_type_t<ForwardIterator>
+        {
+            cppsort::detail::task_group group;
+            return inv_probe_algo(first, last, size,
+                                  std::move(compare), std::move(projection),
+                                  cppsort::detail::parallel_inversions_counter{&group});
+        }
+
+        struct parallel_inv_impl
+        {
+            template<
+                typename ForwardIterable,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_v<Projection, ForwardIterable, Compare>
+                >
+            >
+            auto operator()(ForwardIterable&& iterable,
+                            Compare compare={}, Projection projection={}) const
+                -> decltype(auto)
+            {
+                return parallel_inv_probe_algo(std::begin(iterable), std::end(iterable),
+                                               utility::size(iterable),
+                                               std::move(compare), std::move(projection));
+            }
+
+            template<
+                typename ForwardIterator,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, ForwardIterator, Compare>
+                >
+            >
+            auto operator()(ForwardIterator first, ForwardIterator last,
+                            Compare compare={}, Projection projection={}) const
+                -> decltype(auto)
+            {
+                return parallel_inv_probe_algo(first, last, std::distance(first, last),
+                                               std::move(compare), std::move(projection));
+            }
+        };
+    }
+
+    namespace
+    {
+        constexpr auto&& parallel_inv = utility::static_const<
+            sorter_facade<detail::parallel_inv_impl>
+        >::value;
+    }
+}}
+
+#endif // CPPSORT_PROBES_PARALLEL_INV_H_
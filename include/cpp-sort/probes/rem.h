@@ -65,17 +65,14 @@ namespace probe
             // Top (smaller) elements in patience sorting stacks
             std::vector<ForwardIterator> stack_tops;
 
-            auto deref_compare = [&](const auto& lhs, auto rhs_it) mutable {
-                return comp(lhs, *rhs_it);
-            };
-            auto deref_proj = [&](const auto& value) mutable -> decltype(auto) {
-                return proj(value);
+            auto deref_proj = [&](ForwardIterator it) mutable -> decltype(auto) {
+                return proj(*it);
             };
 
             while (first != last) {
                 auto it = cppsort::detail::upper_bound(
                     stack_tops.begin(), stack_tops.end(),
-                    proj(*first), deref_compare, deref_proj);
+                    proj(*first), comp, deref_proj);
 
                 if (it == stack_tops.end()) {
                     // The element is bigger than everything else,
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_PROBES_SAMPLED_INV_H_
+#define CPPSORT_PROBES_SAMPLED_INV_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/probes/estimate.h>
+#include <cpp-sort/probes/inv.h>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/static_const.h>
+#include "../detail/iterator_traits.h"
+#include "../detail/sampling.h"
+
+namespace cppsort
+{
+namespace probe
+{
+    namespace detail
+    {
+        template<std::size_t SampleSize>
+        struct sampled_inv_impl
+        {
+            static_assert(SampleSize > 0, "the sample size must be positive");
+
+            template<
+                typename RandomAccessIterator,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, RandomAccessIterator, Compare>
+                >
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Compare compare={}, Projection projection={}) const
+                -> estimate<cppsort::detail::difference_type_t<RandomAccessIterator>>
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        cppsort::detail::iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "sampled_inv requires at least random-access iterators"
+                );
+
+                using difference_type = cppsort::detail::difference_type_t<RandomAccessIterator>;
+                auto&& comp = utility::as_function(compare);
+                auto&& proj = utility::as_function(projection);
+
+                // Small collections are measured exactly
+                difference_type size = last - first;
+                if (size <= static_cast<difference_type>(SampleSize)) {
+                    return cppsort::detail::make_exact_estimate(
+                        probe::inv(first, last, std::move(compare), std::move(projection))
+                    );
+                }
+
+                // Compare random pairs of elements, the proportion of
+                // inverted pairs estimates the proportion of inversions
+                // among the n * (n - 1) / 2 pairs of the collection
+                cppsort::detail::sampling_engine engine(size);
+                std::uint64_t inversions = 0;
+                for (std::size_t sample = 0 ; sample < SampleSize ; ++sample) {
+                    auto pos1 = static_cast<difference_type>(engine.below(size));
+                    auto pos2 = static_cast<difference_type>(engine.below(size - 1));
+                    if (pos2 >= pos1) {
+                        ++pos2;
+                    } else {
+                        std::swap(pos1, pos2);
+                    }
+                    if (comp(proj(first[pos2]), proj(first[pos1]))) {
+                        ++inversions;
+                    }
+                }
+
+                auto bounds = cppsort::detail::wilson_interval(inversions, SampleSize);
+                return cppsort::detail::make_estimate(
+                    static_cast<double>(inversions) / SampleSize,
+                    bounds.first, bounds.second,
+                    size * (size - 1) / 2
+                );
+            }
+        };
+    }
+
+    template<std::size_t SampleSize = 1024>
+    struct sampled_inv_estimator:
+        sorter_facade<detail::sampled_inv_impl<SampleSize>>
+    {};
+
+    namespace
+    {
+        constexpr auto&& sampled_inv = utility::static_const<
+            sampled_inv_estimator<>
+        >::value;
+    }
+}}
+
+#endif // CPPSORT_PROBES_SAMPLED_INV_H_
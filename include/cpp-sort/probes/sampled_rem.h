@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_PROBES_SAMPLED_REM_H_
+#define CPPSORT_PROBES_SAMPLED_REM_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cpp-sort/probes/estimate.h>
+#include <cpp-sort/probes/rem.h>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/static_const.h>
+#include "../detail/iterator_traits.h"
+#include "../detail/sampling.h"
+#include "../detail/upper_bound.h"
+
+namespace cppsort
+{
+namespace probe
+{
+    namespace detail
+    {
+        template<std::size_t SampleSize>
+        struct sampled_rem_impl
+        {
+            static_assert(SampleSize > 0, "the sample size must be positive");
+
+            template<
+                typename RandomAccessIterator,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, RandomAccessIterator, Compare>
+                >
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Compare compare={}, Projection projection={}) const
+                -> estimate<cppsort::detail::difference_type_t<RandomAccessIterator>>
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        cppsort::detail::iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "sampled_rem requires at least random-access iterators"
+                );
+
+                using difference_type = cppsort::detail::difference_type_t<RandomAccessIterator>;
+                auto&& proj = utility::as_function(projection);
+
+                // Small collections are measured exactly
+                difference_type size = last - first;
+                if (size <= static_cast<difference_type>(SampleSize)) {
+                    return cppsort::detail::make_exact_estimate(
+                        probe::rem(first, last, std::move(compare), std::move(projection))
+                    );
+                }
+
+                // Compute the longest non-decreasing subsequence of a
+                // subsequence made of one random element in every slice
+                // of the collection: the proportion of sampled elements
+                // it contains overestimates the proportion of elements
+                // in the longest non-decreasing subsequence of the
+                // whole collection
+                cppsort::detail::sampling_engine engine(size);
+                std::vector<RandomAccessIterator> sample;
+                sample.reserve(SampleSize);
+                for (std::size_t idx = 0 ; idx < SampleSize ; ++idx) {
+                    difference_type begin = size * idx / SampleSize;
+                    difference_type end = size * (idx + 1) / SampleSize;
+                    sample.push_back(first + begin + static_cast<difference_type>(engine.below(end - begin)));
+                }
+
+                // Patience sorting, only the top of every stack is kept
+                std::vector<RandomAccessIterator> stack_tops;
+                auto deref_proj = [&proj](RandomAccessIterator it) -> decltype(auto) {
+                    return proj(*it);
+                };
+                for (RandomAccessIterator it: sample) {
+                    auto top = cppsort::detail::upper_bound(stack_tops.begin(), stack_tops.end(),
+                                                            proj(*it), compare, deref_proj);
+                    if (top == stack_tops.end()) {
+                        stack_tops.push_back(it);
+                    } else {
+                        *top = it;
+                    }
+                }
+
+                difference_type sample_size = SampleSize;
+                auto sample_lnds = static_cast<difference_type>(stack_tops.size());
+
+                // The elements of the longest non-decreasing subsequence
+                // of the sample also form a non-decreasing subsequence of
+                // the whole collection, which gives a deterministic upper
+                // bound; the lower bound follows from Hoeffding's inequality
+                double proportion = 1.0 - static_cast<double>(sample_lnds) / sample_size;
+                double epsilon = std::sqrt(std::log(1.0 / 0.05) / (2.0 * sample_size));
+                auto scale = [size](double ratio) {
+                    return std::max(0.0, ratio) * static_cast<double>(size);
+                };
+                difference_type upper = size - sample_lnds;
+                return {
+                    std::min(upper, static_cast<difference_type>(std::round(scale(proportion)))),
+                    std::min(upper, static_cast<difference_type>(std::floor(scale(proportion - epsilon)))),
+                    upper
+                };
+            }
+        };
+    }
+
+    template<std::size_t SampleSize = 1024>
+    struct sampled_rem_estimator:
+        sorter_facade<detail::sampled_rem_impl<SampleSize>>
+    {};
+
+    namespace
+    {
+        constexpr auto&& sampled_rem = utility::static_const<
+            sampled_rem_estimator<>
+        >::value;
+    }
+}}
+
+#endif // CPPSORT_PROBES_SAMPLED_REM_H_
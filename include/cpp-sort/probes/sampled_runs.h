@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_PROBES_SAMPLED_RUNS_H_
+#define CPPSORT_PROBES_SAMPLED_RUNS_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/probes/estimate.h>
+#include <cpp-sort/probes/runs.h>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/static_const.h>
+#include "../detail/iterator_traits.h"
+#include "../detail/sampling.h"
+
+namespace cppsort
+{
+namespace probe
+{
+    namespace detail
+    {
+        template<std::size_t SampleSize>
+        struct sampled_runs_impl
+        {
+            static_assert(SampleSize > 0, "the sample size must be positive");
+
+            template<
+                typename RandomAccessIterator,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, RandomAccessIterator, Compare>
+                >
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Compare compare={}, Projection projection={}) const
+                -> estimate<cppsort::detail::difference_type_t<RandomAccessIterator>>
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        cppsort::detail::iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "sampled_runs requires at least random-access iterators"
+                );
+
+                using difference_type = cppsort::detail::difference_type_t<RandomAccessIterator>;
+                auto&& comp = utility::as_function(compare);
+                auto&& proj = utility::as_function(projection);
+
+                // Small collections are measured exactly
+                difference_type size = last - first;
+                if (size <= static_cast<difference_type>(SampleSize)) {
+                    return cppsort::detail::make_exact_estimate(
+                        probe::runs(first, last, std::move(compare), std::move(projection))
+                    );
+                }
+
+                // Check whether random adjacent pairs of elements are in
+                // order, the positions of the pairs are stratified: one
+                // of them is picked in every slice of the collection
+                cppsort::detail::sampling_engine engine(size);
+                std::uint64_t step_downs = 0;
+                for (std::size_t sample = 0 ; sample < SampleSize ; ++sample) {
+                    difference_type begin = (size - 1) * sample / SampleSize;
+                    difference_type end = (size - 1) * (sample + 1) / SampleSize;
+                    auto pos = begin + static_cast<difference_type>(engine.below(end - begin));
+                    if (comp(proj(first[pos + 1]), proj(first[pos]))) {
+                        ++step_downs;
+                    }
+                }
+
+                auto bounds = cppsort::detail::wilson_interval(step_downs, SampleSize);
+                return cppsort::detail::make_estimate(
+                    static_cast<double>(step_downs) / SampleSize,
+                    bounds.first, bounds.second,
+                    size - 1
+                );
+            }
+        };
+    }
+
+    template<std::size_t SampleSize = 1024>
+    struct sampled_runs_estimator:
+        sorter_facade<detail::sampled_runs_impl<SampleSize>>
+    {};
+
+    namespace
+    {
+        constexpr auto&& sampled_runs = utility::static_const<
+            sampled_runs_estimator<>
+        >::value;
+    }
+}}
+
+#endif // CPPSORT_PROBES_SAMPLED_RUNS_H_
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_SORTERS_ADAPTIVE_SORTER_H_
+#define CPPSORT_SORTERS_ADAPTIVE_SORTER_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/probes/sampled_rem.h>
+#include <cpp-sort/probes/sampled_runs.h>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/sorters/drop_merge_sorter.h>
+#include <cpp-sort/sorters/pdq_sorter.h>
+#include <cpp-sort/sorters/ska_sorter.h>
+#include <cpp-sort/sorters/verge_sorter.h>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/static_const.h>
+#include "../detail/iterator_traits.h"
+#include "../detail/ska_sort.h"
+#include "../detail/type_traits.h"
+
+namespace cppsort
+{
+    ////////////////////////////////////////////////////////////
+    // Decision
+
+    // Sorters that adaptive_sorter can pick
+    enum class adaptive_sorter_choice
+    {
+        drop_merge_sorter,
+        pdq_sorter,
+        ska_sorter,
+        verge_sorter
+    };
+
+    inline auto to_string(adaptive_sorter_choice choice)
+        -> const char*
+    {
+        switch (choice) {
+            case adaptive_sorter_choice::drop_merge_sorter:
+                return "drop_merge_sorter";
+            case adaptive_sorter_choice::ska_sorter:
+                return "ska_sorter";
+            case adaptive_sorter_choice::verge_sorter:
+                return "verge_sorter";
+            default:
+                return "pdq_sorter";
+        }
+    }
+
+    // Measures are expressed as ratios of the size of the collection
+    struct adaptive_sorter_thresholds
+    {
+        // Smaller collections are sorted with pdq_sorter without
+        // being measured
+        std::ptrdiff_t min_probe_size = 256;
+        // Maximal Rem for drop_merge_sorter
+        double max_rem = 0.2;
+        // Maximal Rem of the reversed collection for verge_sorter
+        double max_reversed_rem = 0.2;
+        // Maximal proportion of step downs for verge_sorter
+        double max_step_downs = 0.01;
+        // Minimal size for ska_sorter
+        std::ptrdiff_t min_radix_size = 1024;
+    };
+
+    // Measures of the collection and sorter picked from them, the
+    // measures that were not needed to make a decision are left to 0
+    struct adaptive_sorter_decision
+    {
+        adaptive_sorter_choice sorter;
+        std::ptrdiff_t size;
+        bool probed;
+        double rem;
+        double reversed_rem;
+        double step_downs;
+        bool radix_sortable;
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Sorter
+
+    namespace detail
+    {
+        template<typename RandomAccessIterator, typename Compare, typename Projection>
+        using adaptive_sorter_radix_sortable = std::integral_constant<bool,
+            std::is_same<remove_cvref_t<Compare>, std::less<>>::value &&
+            is_ska_sortable_v<projected_t<RandomAccessIterator, Projection>>
+        >;
+
+        struct adaptive_sorter_impl
+        {
+            adaptive_sorter_thresholds thresholds;
+
+            constexpr adaptive_sorter_impl() = default;
+
+            constexpr explicit adaptive_sorter_impl(adaptive_sorter_thresholds thresholds):
+                thresholds(thresholds)
+            {}
+
+            ////////////////////////////////////////////////////////////
+            // Decision
+
+            template<
+                typename RandomAccessIterator,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, RandomAccessIterator, Compare>
+                >
+            >
+            auto decide(RandomAccessIterator first, RandomAccessIterator last,
+                        Compare compare={}, Projection projection={}) const
+                -> adaptive_sorter_decision
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "adaptive_sorter requires at least random-access iterators"
+                );
+
+                adaptive_sorter_decision decision = {
+                    adaptive_sorter_choice::pdq_sorter,
+                    last - first, false, 0.0, 0.0, 0.0,
+                    adaptive_sorter_radix_sortable<RandomAccessIterator, Compare, Projection>::value
+                };
+                if (decision.size < thresholds.min_probe_size || decision.size < 2) {
+                    return decision;
+                }
+                decision.probed = true;
+                double size = static_cast<double>(decision.size);
+
+                // Few elements out of place: drop them and merge them back
+                auto rem = probe::sampled_rem_estimator<256>{}(first, last, compare, projection);
+                decision.rem = rem.value / size;
+                if (decision.rem <= thresholds.max_rem) {
+                    decision.sorter = adaptive_sorter_choice::drop_merge_sorter;
+                    return decision;
+                }
+
+                // Few elements out of place in the reversed order: verge
+                // sort reverses the descending runs in linear time
+                auto&& comp = utility::as_function(compare);
+                auto reversed_comp = [&comp](auto&& lhs, auto&& rhs) {
+                    return comp(std::forward<decltype(rhs)>(rhs),
+                                std::forward<decltype(lhs)>(lhs));
+                };
+                auto reversed_rem = probe::sampled_rem_estimator<256>{}(first, last, reversed_comp, projection);
+                decision.reversed_rem = reversed_rem.value / size;
+                if (decision.reversed_rem <= thresholds.max_reversed_rem) {
+                    decision.sorter = adaptive_sorter_choice::verge_sorter;
+                    return decision;
+                }
+
+                // Few long runs: verge sort merges them
+                auto step_downs = probe::sampled_runs_estimator<256>{}(first, last, compare, projection);
+                decision.step_downs = step_downs.value / size;
+                if (decision.step_downs <= thresholds.max_step_downs) {
+                    decision.sorter = adaptive_sorter_choice::verge_sorter;
+                    return decision;
+                }
+
+                // Radix sorting beats every comparison sort on shuffled
+                // data, long runs excepted
+                if (decision.radix_sortable && decision.size >= thresholds.min_radix_size) {
+                    decision.sorter = adaptive_sorter_choice::ska_sorter;
+                }
+                return decision;
+            }
+
+            template<
+                typename RandomAccessIterable,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_v<Projection, RandomAccessIterable, Compare>
+                >
+            >
+            auto decide(RandomAccessIterable&& iterable,
+                        Compare compare={}, Projection projection={}) const
+                -> adaptive_sorter_decision
+            {
+                return decide(std::begin(iterable), std::end(iterable),
+                              std::move(compare), std::move(projection));
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Sorting
+
+            template<
+                typename RandomAccessIterator,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, RandomAccessIterator, Compare>
+                >
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Compare compare={}, Projection projection={}) const
+                -> adaptive_sorter_decision
+            {
+                auto decision = decide(first, last, compare, projection);
+                switch (decision.sorter) {
+                    case adaptive_sorter_choice::drop_merge_sorter:
+                        drop_merge_sorter{}(std::move(first), std::move(last),
+                                            std::move(compare), std::move(projection));
+                        break;
+                    case adaptive_sorter_choice::ska_sorter:
+                        radix_sort(std::move(first), std::move(last),
+                                   std::move(compare), std::move(projection),
+                                   adaptive_sorter_radix_sortable<
+                                       RandomAccessIterator, Compare, Projection
+                                   >{});
+                        break;
+                    case adaptive_sorter_choice::verge_sorter:
+                        verge_sorter{}(std::move(first), std::move(last),
+                                       std::move(compare), std::move(projection));
+                        break;
+                    default:
+                        pdq_sorter{}(std::move(first), std::move(last),
+                                     std::move(compare), std::move(projection));
+                        break;
+                }
+                return decision;
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Sorter traits
+
+            using iterator_category = std::random_access_iterator_tag;
+            using is_always_stable = std::false_type;
+
+            private:
+
+                template<typename RandomAccessIterator, typename Compare, typename Projection>
+                static auto radix_sort(RandomAccessIterator first, RandomAccessIterator last,
+                                       Compare, Projection projection, std::true_type)
+                    -> void
+                {
+                    ska_sorter{}(std::move(first), std::move(last), std::move(projection));
+                }
+
+                template<typename RandomAccessIterator, typename Compare, typename Projection>
+                static auto radix_sort(RandomAccessIterator first, RandomAccessIterator last,
+                                       Compare compare, Projection projection, std::false_type)
+                    -> void
+                {
+                    // Never picked, only here to make the dispatch compile
+                    pdq_sorter{}(std::move(first), std::move(last),
+                                 std::move(compare), std::move(projection));
+                }
+        };
+    }
+
+    struct adaptive_sorter:
+        sorter_facade<detail::adaptive_sorter_impl>
+    {
+        adaptive_sorter() = default;
+
+        constexpr explicit adaptive_sorter(adaptive_sorter_thresholds thresholds):
+            sorter_facade<detail::adaptive_sorter_impl>(thresholds)
+        {}
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Sort function
+
+    namespace
+    {
+        constexpr auto&& adaptive_sort
+            = utility::static_const<adaptive_sorter>::value;
+    }
+}
+
+#endif // CPPSORT_SORTERS_ADAPTIVE_SORTER_H_
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2019 Morwenn
+ * Copyright (c) 2016-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #ifndef CPPSORT_SORTERS_COUNTING_SORTER_H_
@@ -13,6 +13,8 @@
 #include <type_traits>
 #include <utility>
 #include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/functional.h>
 #include <cpp-sort/utility/static_const.h>
 #include "../detail/counting_sort.h"
 #include "../detail/iterator_traits.h"
@@ -61,6 +63,58 @@ namespace cppsort
                 reverse_counting_sort(std::move(first), std::move(last));
             }
 
+            template<
+                typename ForwardIterator,
+                typename Projection,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, ForwardIterator>
+                >
+            >
+            auto operator()(ForwardIterator first, ForwardIterator last,
+                            Projection projection) const
+                -> std::enable_if_t<
+                    not std::is_same<Projection, utility::identity>::value &&
+                    detail::is_counting_key<projected_t<ForwardIterator, Projection>>::value
+                >
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::forward_iterator_tag,
+                        iterator_category_t<ForwardIterator>
+                    >::value,
+                    "counting_sorter requires at least forward iterators"
+                );
+
+                key_indexed_counting_sort<false>(std::move(first), std::move(last),
+                                                 std::move(projection));
+            }
+
+            template<
+                typename ForwardIterator,
+                typename Projection,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, ForwardIterator, std::greater<>>
+                >
+            >
+            auto operator()(ForwardIterator first, ForwardIterator last,
+                            std::greater<>, Projection projection) const
+                -> std::enable_if_t<
+                    not std::is_same<Projection, utility::identity>::value &&
+                    detail::is_counting_key<projected_t<ForwardIterator, Projection>>::value
+                >
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::forward_iterator_tag,
+                        iterator_category_t<ForwardIterator>
+                    >::value,
+                    "counting_sorter requires at least forward iterators"
+                );
+
+                key_indexed_counting_sort<true>(std::move(first), std::move(last),
+                                                std::move(projection));
+            }
+
             ////////////////////////////////////////////////////////////
             // Sorter traits
 
@@ -73,6 +127,43 @@ namespace cppsort
         sorter_facade<detail::counting_sorter_impl>
     {};
 
+    ////////////////////////////////////////////////////////////
+    // is_stable specializations
+
+    // Sorting by a projected key uses a stable key-indexed counting sort
+
+    template<typename Iterable, typename Projection>
+    struct is_stable<counting_sorter(Iterable, Projection)>:
+        std::integral_constant<bool,
+            is_projection_v<Projection, Iterable> &&
+            not std::is_same<Projection, utility::identity>::value
+        >
+    {};
+
+    template<typename Iterable, typename Projection>
+    struct is_stable<counting_sorter(Iterable, std::greater<>, Projection)>:
+        std::integral_constant<bool,
+            is_projection_v<Projection, Iterable, std::greater<>> &&
+            not std::is_same<Projection, utility::identity>::value
+        >
+    {};
+
+    template<typename Iterator, typename Projection>
+    struct is_stable<counting_sorter(Iterator, Iterator, Projection)>:
+        std::integral_constant<bool,
+            is_projection_iterator_v<Projection, Iterator> &&
+            not std::is_same<Projection, utility::identity>::value
+        >
+    {};
+
+    template<typename Iterator, typename Projection>
+    struct is_stable<counting_sorter(Iterator, Iterator, std::greater<>, Projection)>:
+        std::integral_constant<bool,
+            is_projection_iterator_v<Projection, Iterator, std::greater<>> &&
+            not std::is_same<Projection, utility::identity>::value
+        >
+    {};
+
     ////////////////////////////////////////////////////////////
     // Sort function
 
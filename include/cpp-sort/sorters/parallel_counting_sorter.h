@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_SORTERS_PARALLEL_COUNTING_SORTER_H_
+#define CPPSORT_SORTERS_PARALLEL_COUNTING_SORTER_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/static_const.h>
+#include <cpp-sort/utility/thread_pool.h>
+#include "../detail/iterator_traits.h"
+#include "../detail/parallel_counting_sort.h"
+#include "../detail/thread_pool.h"
+#include "../detail/type_traits.h"
+
+namespace cppsort
+{
+    ////////////////////////////////////////////////////////////
+    // Sorter
+
+    namespace detail
+    {
+        template<std::size_t SequentialThreshold>
+        struct parallel_counting_sorter_impl:
+            thread_pool_storage
+        {
+            parallel_counting_sorter_impl() = default;
+
+            constexpr explicit parallel_counting_sorter_impl(thread_pool& pool) noexcept:
+                thread_pool_storage(pool)
+            {}
+
+            template<typename RandomAccessIterator>
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last) const
+                -> std::enable_if_t<
+                    detail::is_integral<value_type_t<RandomAccessIterator>>::value
+                >
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "parallel_counting_sorter requires at least random-access iterators"
+                );
+
+                using difference_type = difference_type_t<RandomAccessIterator>;
+                parallel_counting_sort(std::move(first), std::move(last),
+                                       static_cast<difference_type>(SequentialThreshold),
+                                       this->get_pool());
+            }
+
+            template<typename RandomAccessIterator>
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last, std::greater<>) const
+                -> std::enable_if_t<
+                    detail::is_integral<value_type_t<RandomAccessIterator>>::value
+                >
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "parallel_counting_sorter requires at least random-access iterators"
+                );
+
+                using difference_type = difference_type_t<RandomAccessIterator>;
+                parallel_reverse_counting_sort(std::move(first), std::move(last),
+                                               static_cast<difference_type>(SequentialThreshold),
+                                               this->get_pool());
+            }
+
+            template<
+                typename RandomAccessIterator,
+                typename Projection,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, RandomAccessIterator>
+                >
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Projection projection) const
+                -> std::enable_if_t<
+                    not std::is_same<Projection, utility::identity>::value &&
+                    detail::is_counting_key<projected_t<RandomAccessIterator, Projection>>::value
+                >
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "parallel_counting_sorter requires at least random-access iterators"
+                );
+
+                using difference_type = difference_type_t<RandomAccessIterator>;
+                parallel_key_indexed_counting_sort(std::move(first), std::move(last), std::move(projection),
+                                                   static_cast<difference_type>(SequentialThreshold),
+                                                   this->get_pool());
+            }
+
+            template<
+                typename RandomAccessIterator,
+                typename Projection,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, RandomAccessIterator, std::greater<>>
+                >
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            std::greater<>, Projection projection) const
+                -> std::enable_if_t<
+                    not std::is_same<Projection, utility::identity>::value &&
+                    detail::is_counting_key<projected_t<RandomAccessIterator, Projection>>::value
+                >
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "parallel_counting_sorter requires at least random-access iterators"
+                );
+
+                using difference_type = difference_type_t<RandomAccessIterator>;
+                parallel_reverse_key_indexed_counting_sort(std::move(first), std::move(last), std::move(projection),
+                                                           static_cast<difference_type>(SequentialThreshold),
+                                                           this->get_pool());
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Sorter traits
+
+            using iterator_category = std::random_access_iterator_tag;
+            using is_always_stable = std::false_type;
+        };
+    }
+
+    template<std::size_t SequentialThreshold = 65536>
+    struct parallel_counting_sorter:
+        sorter_facade<detail::parallel_counting_sorter_impl<SequentialThreshold>>
+    {
+        parallel_counting_sorter() = default;
+
+        constexpr explicit parallel_counting_sorter(utility::thread_pool& pool) noexcept:
+            sorter_facade<detail::parallel_counting_sorter_impl<SequentialThreshold>>(pool)
+        {}
+    };
+
+    ////////////////////////////////////////////////////////////
+    // is_stable specializations
+
+    // Sorting by a projected key uses a stable key-indexed counting sort
+
+    template<std::size_t SequentialThreshold, typename Iterable, typename Projection>
+    struct is_stable<parallel_counting_sorter<SequentialThreshold>(Iterable, Projection)>:
+        std::integral_constant<bool,
+            is_projection_v<Projection, Iterable> &&
+            not std::is_same<Projection, utility::identity>::value
+        >
+    {};
+
+    template<std::size_t SequentialThreshold, typename Iterable, typename Projection>
+    struct is_stable<parallel_counting_sorter<SequentialThreshold>(Iterable, std::greater<>, Projection)>:
+        std::integral_constant<bool,
+            is_projection_v<Projection, Iterable, std::greater<>> &&
+            not std::is_same<Projection, utility::identity>::value
+        >
+    {};
+
+    template<std::size_t SequentialThreshold, typename Iterator, typename Projection>
+    struct is_stable<parallel_counting_sorter<SequentialThreshold>(Iterator, Iterator, Projection)>:
+        std::integral_constant<bool,
+            is_projection_iterator_v<Projection, Iterator> &&
+            not std::is_same<Projection, utility::identity>::value
+        >
+    {};
+
+    template<std::size_t SequentialThreshold, typename Iterator, typename Projection>
+    struct is_stable<parallel_counting_sorter<SequentialThreshold>(Iterator, Iterator, std::greater<>, Projection)>:
+        std::integral_constant<bool,
+            is_projection_iterator_v<Projection, Iterator, std::greater<>> &&
+            not std::is_same<Projection, utility::identity>::value
+        >
+    {};
+
+    ////////////////////////////////////////////////////////////
+    // Sort function
+
+    namespace
+    {
+        constexpr auto&& parallel_counting_sort
+            = utility::static_const<parallel_counting_sorter<>>::value;
+    }
+}
+
+#endif // CPPSORT_SORTERS_PARALLEL_COUNTING_SORTER_H_
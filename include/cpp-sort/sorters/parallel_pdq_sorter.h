@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_SORTERS_PARALLEL_PDQ_SORTER_H_
+#define CPPSORT_SORTERS_PARALLEL_PDQ_SORTER_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/static_const.h>
+#include <cpp-sort/utility/thread_pool.h>
+#include "../detail/iterator_traits.h"
+#include "../detail/parallel_pdqsort.h"
+#include "../detail/thread_pool.h"
+
+namespace cppsort
+{
+    ////////////////////////////////////////////////////////////
+    // Sorter
+
+    namespace detail
+    {
+        template<std::size_t SequentialThreshold>
+        struct parallel_pdq_sorter_impl:
+            thread_pool_storage
+        {
+            parallel_pdq_sorter_impl() = default;
+
+            constexpr explicit parallel_pdq_sorter_impl(thread_pool& pool) noexcept:
+                thread_pool_storage(pool)
+            {}
+
+            template<
+                typename RandomAccessIterator,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, RandomAccessIterator, Compare>
+                >
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Compare compare={}, Projection projection={}) const
+                -> void
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "parallel_pdq_sorter requires at least random-access iterators"
+                );
+
+                using difference_type = difference_type_t<RandomAccessIterator>;
+                parallel_pdqsort(std::move(first), std::move(last),
+                                 std::move(compare), std::move(projection),
+                                 static_cast<difference_type>(SequentialThreshold),
+                                 this->get_pool());
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Sorter traits
+
+            using iterator_category = std::random_access_iterator_tag;
+            using is_always_stable = std::false_type;
+        };
+    }
+
+    template<std::size_t SequentialThreshold = 16384>
+    struct parallel_pdq_sorter:
+        sorter_facade<detail::parallel_pdq_sorter_impl<SequentialThreshold>>
+    {
+        parallel_pdq_sorter() = default;
+
+        constexpr explicit parallel_pdq_sorter(utility::thread_pool& pool) noexcept:
+            sorter_facade<detail::parallel_pdq_sorter_impl<SequentialThreshold>>(pool)
+        {}
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Sort function
+
+    namespace
+    {
+        constexpr auto&& parallel_pdq_sort
+            = utility::static_const<parallel_pdq_sorter<>>::value;
+    }
+}
+
+#endif // CPPSORT_SORTERS_PARALLEL_PDQ_SORTER_H_
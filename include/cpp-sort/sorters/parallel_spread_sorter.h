@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_SORTERS_PARALLEL_SPREAD_SORTER_H_
+#define CPPSORT_SORTERS_PARALLEL_SPREAD_SORTER_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/adapters/hybrid_adapter.h>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/static_const.h>
+#include <cpp-sort/utility/thread_pool.h>
+#include "../detail/iterator_traits.h"
+#include "../detail/parallel_spreadsort.h"
+#include "../detail/thread_pool.h"
+
+#if __cplusplus > 201402L && __has_include(<string_view>)
+#   include <string_view>
+#endif
+
+namespace cppsort
+{
+    ////////////////////////////////////////////////////////////
+    // Sorter
+
+    namespace detail
+    {
+        template<std::size_t SequentialThreshold>
+        struct parallel_integer_spread_sorter_impl:
+            thread_pool_storage
+        {
+            parallel_integer_spread_sorter_impl() = default;
+
+            constexpr explicit parallel_integer_spread_sorter_impl(thread_pool& pool) noexcept:
+                thread_pool_storage(pool)
+            {}
+
+            template<
+                typename RandomAccessIterator,
+                typename Projection = utility::identity
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Projection projection={}) const
+                -> std::enable_if_t<
+                    std::is_integral<projected_t<RandomAccessIterator, Projection>>::value && (
+                        sizeof(projected_t<RandomAccessIterator, Projection>) <= sizeof(std::size_t) ||
+                        sizeof(projected_t<RandomAccessIterator, Projection>) <= sizeof(std::uintmax_t)
+                    ) &&
+                    is_projection_iterator_v<Projection, RandomAccessIterator>
+                >
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "parallel_spread_sorter requires at least random-access iterators"
+                );
+
+                using difference_type = difference_type_t<RandomAccessIterator>;
+                parallel_integer_sort(std::move(first), std::move(last), std::move(projection),
+                                      static_cast<difference_type>(SequentialThreshold),
+                                      this->get_pool());
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Sorter traits
+
+            using iterator_category = std::random_access_iterator_tag;
+            using is_always_stable = std::false_type;
+        };
+
+        template<std::size_t SequentialThreshold>
+        struct parallel_float_spread_sorter_impl:
+            thread_pool_storage
+        {
+            parallel_float_spread_sorter_impl() = default;
+
+            constexpr explicit parallel_float_spread_sorter_impl(thread_pool& pool) noexcept:
+                thread_pool_storage(pool)
+            {}
+
+            template<
+                typename RandomAccessIterator,
+                typename Projection = utility::identity
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Projection projection={}) const
+                -> std::enable_if_t<
+                    std::numeric_limits<projected_t<RandomAccessIterator, Projection>>::is_iec559 && (
+                        sizeof(projected_t<RandomAccessIterator, Projection>) == sizeof(std::uint32_t) ||
+                        sizeof(projected_t<RandomAccessIterator, Projection>) == sizeof(std::uint64_t)
+                    ) &&
+                    is_projection_iterator_v<Projection, RandomAccessIterator>
+                >
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "parallel_spread_sorter requires at least random-access iterators"
+                );
+
+                using difference_type = difference_type_t<RandomAccessIterator>;
+                parallel_float_sort(std::move(first), std::move(last), std::move(projection),
+                                    static_cast<difference_type>(SequentialThreshold),
+                                    this->get_pool());
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Sorter traits
+
+            using iterator_category = std::random_access_iterator_tag;
+            using is_always_stable = std::false_type;
+        };
+
+        template<std::size_t SequentialThreshold>
+        struct parallel_string_spread_sorter_impl:
+            thread_pool_storage
+        {
+            parallel_string_spread_sorter_impl() = default;
+
+            constexpr explicit parallel_string_spread_sorter_impl(thread_pool& pool) noexcept:
+                thread_pool_storage(pool)
+            {}
+
+            ////////////////////////////////////////////////////////////
+            // Ascending string sort
+
+            template<
+                typename RandomAccessIterator,
+                typename Projection = utility::identity
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Projection projection={}) const
+                -> std::enable_if_t<
+                    std::is_same<projected_t<RandomAccessIterator, Projection>, std::string>::value
+#if __cplusplus > 201402L && __has_include(<string_view>)
+                    || std::is_same<projected_t<RandomAccessIterator, Projection>, std::string_view>::value
+#endif
+                >
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "parallel_spread_sorter requires at least random-access iterators"
+                );
+
+                using difference_type = difference_type_t<RandomAccessIterator>;
+                parallel_string_sort<unsigned char, false>(
+                    std::move(first), std::move(last), std::move(projection),
+                    static_cast<difference_type>(SequentialThreshold),
+                    this->get_pool()
+                );
+            }
+
+            template<
+                typename RandomAccessIterator,
+                typename Projection = utility::identity
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Projection projection={}) const
+                -> std::enable_if_t<(
+                        std::is_same<projected_t<RandomAccessIterator, Projection>, std::wstring>::value
+#if __cplusplus > 201402L && __has_include(<string_view>)
+                        || std::is_same<projected_t<RandomAccessIterator, Projection>, std::wstring_view>::value
+#endif
+                    ) && (sizeof(wchar_t) == 2)
+                >
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "parallel_spread_sorter requires at least random-access iterators"
+                );
+
+                using difference_type = difference_type_t<RandomAccessIterator>;
+                parallel_string_sort<std::uint16_t, false>(
+                    std::move(first), std::move(last), std::move(projection),
+                    static_cast<difference_type>(SequentialThreshold),
+                    this->get_pool()
+                );
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Descending string sort
+
+            template<
+                typename RandomAccessIterator,
+                typename Projection = utility::identity
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            std::greater<>, Projection projection={}) const
+                -> std::enable_if_t<
+                    std::is_same<projected_t<RandomAccessIterator, Projection>, std::string>::value
+#if __cplusplus > 201402L && __has_include(<string_view>)
+                    || std::is_same<projected_t<RandomAccessIterator, Projection>, std::string_view>::value
+#endif
+                >
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "parallel_spread_sorter requires at least random-access iterators"
+                );
+
+                using difference_type = difference_type_t<RandomAccessIterator>;
+                parallel_string_sort<unsigned char, true>(
+                    std::move(first), std::move(last), std::move(projection),
+                    static_cast<difference_type>(SequentialThreshold),
+                    this->get_pool()
+                );
+            }
+
+            template<
+                typename RandomAccessIterator,
+                typename Projection = utility::identity
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            std::greater<>, Projection projection={}) const
+                -> std::enable_if_t<(
+                        std::is_same<projected_t<RandomAccessIterator, Projection>, std::wstring>::value
+#if __cplusplus > 201402L && __has_include(<string_view>)
+                        || std::is_same<projected_t<RandomAccessIterator, Projection>, std::wstring_view>::value
+#endif
+                    ) && (sizeof(wchar_t) == 2)
+                >
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "parallel_spread_sorter requires at least random-access iterators"
+                );
+
+                using difference_type = difference_type_t<RandomAccessIterator>;
+                parallel_string_sort<std::uint16_t, true>(
+                    std::move(first), std::move(last), std::move(projection),
+                    static_cast<difference_type>(SequentialThreshold),
+                    this->get_pool()
+                );
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Sorter traits
+
+            using iterator_category = std::random_access_iterator_tag;
+            using is_always_stable = std::false_type;
+        };
+    }
+
+    template<std::size_t SequentialThreshold = 65536>
+    struct parallel_spread_sorter:
+        hybrid_adapter<
+            sorter_facade<detail::parallel_integer_spread_sorter_impl<SequentialThreshold>>,
+            sorter_facade<detail::parallel_float_spread_sorter_impl<SequentialThreshold>>,
+            sorter_facade<detail::parallel_string_spread_sorter_impl<SequentialThreshold>>
+        >
+    {
+        parallel_spread_sorter() = default;
+
+        constexpr explicit parallel_spread_sorter(utility::thread_pool& pool):
+            hybrid_adapter<
+                sorter_facade<detail::parallel_integer_spread_sorter_impl<SequentialThreshold>>,
+                sorter_facade<detail::parallel_float_spread_sorter_impl<SequentialThreshold>>,
+                sorter_facade<detail::parallel_string_spread_sorter_impl<SequentialThreshold>>
+            >(
+                sorter_facade<detail::parallel_integer_spread_sorter_impl<SequentialThreshold>>(pool),
+                sorter_facade<detail::parallel_float_spread_sorter_impl<SequentialThreshold>>(pool),
+                sorter_facade<detail::parallel_string_spread_sorter_impl<SequentialThreshold>>(pool)
+            )
+        {}
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Sort function
+
+    namespace
+    {
+        constexpr auto&& parallel_spread_sort
+            = utility::static_const<parallel_spread_sorter<>>::value;
+    }
+}
+
+#endif // CPPSORT_SORTERS_PARALLEL_SPREAD_SORTER_H_
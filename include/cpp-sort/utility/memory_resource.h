@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_UTILITY_MEMORY_RESOURCE_H_
+#define CPPSORT_UTILITY_MEMORY_RESOURCE_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+namespace cppsort
+{
+namespace utility
+{
+    ////////////////////////////////////////////////////////////
+    // Memory resource interface
+
+    // Mimics std::pmr::memory_resource (which is C++17), except that
+    // allocate returns nullptr instead of throwing when it fails to
+    // allocate the requested memory
+
+    class memory_resource
+    {
+        public:
+
+            virtual ~memory_resource() = default;
+
+            auto allocate(std::size_t bytes, std::size_t alignment=alignof(std::max_align_t))
+                -> void*
+            {
+                return do_allocate(bytes, alignment);
+            }
+
+            auto deallocate(void* pointer, std::size_t bytes,
+                            std::size_t alignment=alignof(std::max_align_t))
+                -> void
+            {
+                do_deallocate(pointer, bytes, alignment);
+            }
+
+        private:
+
+            virtual auto do_allocate(std::size_t bytes, std::size_t alignment)
+                -> void* = 0;
+
+            virtual auto do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment)
+                -> void = 0;
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Global operator new & delete
+
+    namespace detail
+    {
+        class new_delete_resource_impl final:
+            public memory_resource
+        {
+            private:
+
+                auto do_allocate(std::size_t bytes, std::size_t)
+                    -> void* override
+                {
+                    return ::operator new(bytes, std::nothrow);
+                }
+
+                auto do_deallocate(void* pointer, std::size_t bytes, std::size_t)
+                    -> void override
+                {
+#ifdef __cpp_sized_deallocation
+                    ::operator delete(pointer, bytes);
+#else
+                    (void)bytes;
+                    ::operator delete(pointer);
+#endif
+                }
+        };
+
+        // Resource used by the sorters running in the current thread,
+        // nullptr meaning that they directly use ::operator new
+        inline auto current_memory_resource()
+            -> memory_resource*&
+        {
+            static thread_local memory_resource* resource = nullptr;
+            return resource;
+        }
+    }
+
+    inline auto new_delete_resource() noexcept
+        -> memory_resource*
+    {
+        static detail::new_delete_resource_impl resource;
+        return &resource;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Resource used by the sorters
+
+    inline auto get_memory_resource() noexcept
+        -> memory_resource*
+    {
+        auto resource = detail::current_memory_resource();
+        return resource ? resource : new_delete_resource();
+    }
+
+    // Makes the sorters called from the current thread draw their
+    // scratch memory from the given resource until it is destroyed
+
+    class scoped_memory_resource
+    {
+        public:
+
+            explicit scoped_memory_resource(memory_resource* resource) noexcept:
+                previous(detail::current_memory_resource())
+            {
+                detail::current_memory_resource() = resource;
+            }
+
+            scoped_memory_resource(const scoped_memory_resource&) = delete;
+            scoped_memory_resource& operator=(const scoped_memory_resource&) = delete;
+
+            ~scoped_memory_resource()
+            {
+                detail::current_memory_resource() = previous;
+            }
+
+        private:
+
+            memory_resource* previous;
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Reusable scratch memory
+
+    // Hands out memory from a single chunk with a bump pointer, and
+    // recycles the whole chunk when every allocation has been given
+    // back; requests that don't fit are forwarded to the upstream
+    // resource, and the chunk is regrown to the peak memory use - at
+    // least doubling its size - the next time it is empty, so that
+    // repeatedly sorting collections of similar sizes ends up not
+    // allocating at all. It can be used by several threads at once,
+    // which is what happens when a parallel sorter is called from a
+    // thread using a scratch_pool
+
+    class scratch_pool final:
+        public memory_resource
+    {
+        public:
+
+            explicit scratch_pool(memory_resource* upstream=new_delete_resource()) noexcept:
+                upstream(upstream)
+            {}
+
+            explicit scratch_pool(std::size_t initial_size,
+                                  memory_resource* upstream=new_delete_resource()) noexcept:
+                upstream(upstream)
+            {
+                reserve(initial_size);
+            }
+
+            scratch_pool(const scratch_pool&) = delete;
+            scratch_pool& operator=(const scratch_pool&) = delete;
+
+            ~scratch_pool() override
+            {
+                free_chunk();
+            }
+
+            // Size of the chunk from which memory is handed out
+            auto capacity() const noexcept
+                -> std::size_t
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                return chunk_size;
+            }
+
+            // Grows the chunk to at least size bytes, which only
+            // happens when no allocation is alive
+            auto reserve(std::size_t size) noexcept
+                -> void
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (live_allocations == 0 && size > chunk_size) {
+                    if (size > wanted_size) {
+                        wanted_size = size;
+                    }
+                    free_chunk();
+                    allocate_chunk(wanted_size);
+                }
+            }
+
+            // Gives the chunk back to the upstream resource and forgets
+            // about the peak memory use, which must only be done when no
+            // allocation is alive
+            auto release() noexcept
+                -> void
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                free_chunk();
+                wanted_size = 0;
+            }
+
+        private:
+
+            auto do_allocate(std::size_t bytes, std::size_t alignment)
+                -> void* override
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (live_allocations == 0) {
+                    used = 0;
+                    live_bytes = 0;
+                    if (wanted_size > chunk_size) {
+                        auto new_size = chunk_size * 2;
+                        if (new_size < wanted_size) {
+                            new_size = wanted_size;
+                        }
+                        free_chunk();
+                        allocate_chunk(new_size);
+                    }
+                }
+
+                // Over-estimate the needed memory by the worst case
+                // alignment padding
+                live_bytes += bytes + alignment;
+                if (live_bytes > wanted_size) {
+                    wanted_size = live_bytes;
+                }
+
+                auto address = reinterpret_cast<std::uintptr_t>(chunk) + used;
+                auto aligned = (address + alignment - 1) & ~(alignment - 1);
+                auto end = reinterpret_cast<std::uintptr_t>(chunk) + chunk_size;
+                if (chunk && aligned <= end && bytes <= end - aligned) {
+                    used = aligned + bytes - reinterpret_cast<std::uintptr_t>(chunk);
+                    ++live_allocations;
+                    return reinterpret_cast<void*>(aligned);
+                }
+
+                void* res = upstream->allocate(bytes, alignment);
+                if (res) {
+                    ++live_allocations;
+                } else {
+                    live_bytes -= bytes + alignment;
+                }
+                return res;
+            }
+
+            auto do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment)
+                -> void override
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto address = reinterpret_cast<std::uintptr_t>(pointer);
+                auto begin = reinterpret_cast<std::uintptr_t>(chunk);
+                if (not chunk || address < begin || address >= begin + chunk_size) {
+                    upstream->deallocate(pointer, bytes, alignment);
+                }
+                --live_allocations;
+            }
+
+            auto allocate_chunk(std::size_t size) noexcept
+                -> void
+            {
+                if (size == 0) return;
+                chunk = static_cast<char*>(upstream->allocate(size));
+                chunk_size = chunk ? size : 0;
+            }
+
+            auto free_chunk() noexcept
+                -> void
+            {
+                if (chunk) {
+                    upstream->deallocate(chunk, chunk_size);
+                    chunk = nullptr;
+                    chunk_size = 0;
+                }
+            }
+
+            mutable std::mutex mutex;
+            memory_resource* upstream;
+            char* chunk = nullptr;
+            std::size_t chunk_size = 0;
+            // Bytes of the chunk handed out since it was last empty
+            std::size_t used = 0;
+            // Memory handed out since the chunk was last empty,
+            // alignment padding included
+            std::size_t live_bytes = 0;
+            std::size_t wanted_size = 0;
+            std::size_t live_allocations = 0;
+    };
+}}
+
+#endif // CPPSORT_UTILITY_MEMORY_RESOURCE_H_
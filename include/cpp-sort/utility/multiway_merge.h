@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_UTILITY_MULTIWAY_MERGE_H_
+#define CPPSORT_UTILITY_MULTIWAY_MERGE_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/thread_pool.h>
+#include "../detail/iterator_traits.h"
+#include "../detail/multiway_merge.h"
+#include "../detail/thread_pool.h"
+#include "../detail/type_traits.h"
+
+namespace cppsort
+{
+namespace utility
+{
+    namespace detail
+    {
+        template<typename Iterable>
+        using begin_t = decltype(std::begin(std::declval<Iterable&>()));
+
+        template<typename Iterable>
+        using run_iterator_t = begin_t<decltype(*std::declval<begin_t<Iterable>&>())>;
+
+        template<typename ForwardIterator>
+        using run_iterator_from_iterator_t = begin_t<decltype(*std::declval<ForwardIterator&>())>;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Sequential merge
+
+    template<
+        typename ForwardIterator,
+        typename OutputIterator,
+        typename Compare = std::less<>,
+        typename Projection = utility::identity,
+        typename = std::enable_if_t<
+            is_projection_iterator_v<
+                Projection, detail::run_iterator_from_iterator_t<ForwardIterator>, Compare
+            >
+        >
+    >
+    auto multiway_merge(ForwardIterator first, ForwardIterator last, OutputIterator result,
+                        Compare compare={}, Projection projection={})
+        -> OutputIterator
+    {
+        auto runs = cppsort::detail::make_merge_runs(std::move(first), std::move(last));
+        return cppsort::detail::loser_tree_merge(runs, std::move(result),
+                                                 std::move(compare), std::move(projection));
+    }
+
+    template<
+        typename ForwardIterable,
+        typename OutputIterator,
+        typename Compare = std::less<>,
+        typename Projection = utility::identity,
+        typename = std::enable_if_t<
+            is_projection_iterator_v<
+                Projection, detail::run_iterator_t<ForwardIterable>, Compare
+            >
+        >
+    >
+    auto multiway_merge(ForwardIterable&& runs, OutputIterator result,
+                        Compare compare={}, Projection projection={})
+        -> OutputIterator
+    {
+        return multiway_merge(std::begin(runs), std::end(runs), std::move(result),
+                              std::move(compare), std::move(projection));
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Parallel merge
+
+    template<
+        typename ForwardIterator,
+        typename RandomAccessIterator,
+        typename Compare = std::less<>,
+        typename Projection = utility::identity,
+        typename = std::enable_if_t<
+            is_projection_iterator_v<
+                Projection, detail::run_iterator_from_iterator_t<ForwardIterator>, Compare
+            >
+        >
+    >
+    auto parallel_multiway_merge(thread_pool& pool,
+                                 ForwardIterator first, ForwardIterator last,
+                                 RandomAccessIterator result,
+                                 Compare compare={}, Projection projection={})
+        -> RandomAccessIterator
+    {
+        static_assert(
+            std::is_base_of<
+                std::random_access_iterator_tag,
+                cppsort::detail::iterator_category_t<
+                    detail::run_iterator_from_iterator_t<ForwardIterator>
+                >
+            >::value &&
+            std::is_base_of<
+                std::random_access_iterator_tag,
+                cppsort::detail::iterator_category_t<RandomAccessIterator>
+            >::value,
+            "parallel_multiway_merge requires random-access runs and output"
+        );
+
+        auto runs = cppsort::detail::make_merge_runs(std::move(first), std::move(last));
+        return cppsort::detail::parallel_loser_tree_merge(runs, std::move(result),
+                                                          std::move(compare), std::move(projection),
+                                                          pool);
+    }
+
+    template<
+        typename ForwardIterable,
+        typename RandomAccessIterator,
+        typename Compare = std::less<>,
+        typename Projection = utility::identity,
+        typename = std::enable_if_t<
+            is_projection_iterator_v<
+                Projection, detail::run_iterator_t<ForwardIterable>, Compare
+            >
+        >
+    >
+    auto parallel_multiway_merge(thread_pool& pool,
+                                 ForwardIterable&& runs, RandomAccessIterator result,
+                                 Compare compare={}, Projection projection={})
+        -> RandomAccessIterator
+    {
+        return parallel_multiway_merge(pool, std::begin(runs), std::end(runs), std::move(result),
+                                       std::move(compare), std::move(projection));
+    }
+
+    template<
+        typename ForwardIterator,
+        typename RandomAccessIterator,
+        typename Compare = std::less<>,
+        typename Projection = utility::identity,
+        typename = std::enable_if_t<
+            is_projection_iterator_v<
+                Projection, detail::run_iterator_from_iterator_t<ForwardIterator>, Compare
+            >
+        >
+    >
+    auto parallel_multiway_merge(ForwardIterator first, ForwardIterator last,
+                                 RandomAccessIterator result,
+                                 Compare compare={}, Projection projection={})
+        -> RandomAccessIterator
+    {
+        return parallel_multiway_merge(cppsort::detail::default_thread_pool(),
+                                       std::move(first), std::move(last), std::move(result),
+                                       std::move(compare), std::move(projection));
+    }
+
+    template<
+        typename ForwardIterable,
+        typename RandomAccessIterator,
+        typename Compare = std::less<>,
+        typename Projection = utility::identity,
+        typename = std::enable_if_t<
+            is_projection_iterator_v<
+                Projection, detail::run_iterator_t<ForwardIterable>, Compare
+            >
+        >
+    >
+    auto parallel_multiway_merge(ForwardIterable&& runs, RandomAccessIterator result,
+                                 Compare compare={}, Projection projection={})
+        -> RandomAccessIterator
+    {
+        return parallel_multiway_merge(cppsort::detail::default_thread_pool(),
+                                       std::begin(runs), std::end(runs), std::move(result),
+                                       std::move(compare), std::move(projection));
+    }
+}}
+
+#endif // CPPSORT_UTILITY_MULTIWAY_MERGE_H_
@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_UTILITY_THREAD_POOL_H_
+#define CPPSORT_UTILITY_THREAD_POOL_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cppsort
+{
+namespace detail
+{
+    class task_group;
+
+    ////////////////////////////////////////////////////////////
+    // Type-erased task
+
+    // std::function requires copyable callables, which would prevent
+    // tasks from capturing move-only comparison or projection functions
+
+    struct pool_task_base
+    {
+        virtual ~pool_task_base() = default;
+        virtual auto run() -> void = 0;
+    };
+
+    template<typename Function>
+    struct pool_task:
+        pool_task_base
+    {
+        Function function;
+
+        explicit pool_task(Function&& func):
+            function(std::move(func))
+        {}
+
+        auto run() -> void override
+        {
+            function();
+        }
+    };
+}
+
+namespace utility
+{
+    ////////////////////////////////////////////////////////////
+    // Work-stealing thread pool
+
+    // Every worker thread owns a double-ended queue of tasks: it
+    // pushes and pops tasks at the back of its own queue (LIFO, which
+    // keeps the recursion of divide-and-conquer algorithms depth-first
+    // and cache-friendly) and steals tasks from the front of the other
+    // queues when its own is empty. Threads that don't belong to the
+    // pool push their tasks to an additional injection queue.
+    //
+    // Threads waiting for a group of tasks to complete don't block:
+    // they keep running pending tasks until the group is done, which
+    // allows arbitrary nesting of fork-join parallelism without any
+    // risk of deadlock, even when the pool has no worker thread.
+
+    class thread_pool
+    {
+        private:
+
+            struct task_queue
+            {
+                std::mutex mutex;
+                std::deque<std::unique_ptr<cppsort::detail::pool_task_base>> tasks;
+            };
+
+            // Queues, the last one being the injection queue
+            std::vector<std::unique_ptr<task_queue>> queues;
+            std::vector<std::thread> workers;
+
+            // Number of tasks currently sitting in the queues
+            std::atomic<std::size_t> pending{0};
+            std::atomic<bool> stopping{false};
+
+            std::mutex sleep_mutex;
+            std::condition_variable sleep_condition;
+
+            static auto current_pool()
+                -> thread_pool*&
+            {
+                static thread_local thread_pool* pool = nullptr;
+                return pool;
+            }
+
+            static auto current_index()
+                -> std::size_t&
+            {
+                static thread_local std::size_t index = 0;
+                return index;
+            }
+
+            auto own_queue_index() const
+                -> std::size_t
+            {
+                if (current_pool() == this) {
+                    return current_index();
+                }
+                return workers.size();
+            }
+
+            auto pop_task()
+                -> std::unique_ptr<cppsort::detail::pool_task_base>
+            {
+                std::size_t own_index = own_queue_index();
+
+                // Pop the most recent task of our own queue
+                {
+                    task_queue& queue = *queues[own_index];
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    if (not queue.tasks.empty()) {
+                        auto task = std::move(queue.tasks.back());
+                        queue.tasks.pop_back();
+                        --pending;
+                        return task;
+                    }
+                }
+
+                // Steal the oldest task of another queue
+                for (std::size_t i = 1 ; i < queues.size() ; ++i) {
+                    task_queue& queue = *queues[(own_index + i) % queues.size()];
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    if (not queue.tasks.empty()) {
+                        auto task = std::move(queue.tasks.front());
+                        queue.tasks.pop_front();
+                        --pending;
+                        return task;
+                    }
+                }
+                return nullptr;
+            }
+
+            auto worker_loop(std::size_t index)
+                -> void
+            {
+                current_pool() = this;
+                current_index() = index;
+
+                while (true) {
+                    if (try_run_pending_task()) {
+                        continue;
+                    }
+                    std::unique_lock<std::mutex> lock(sleep_mutex);
+                    sleep_condition.wait(lock, [this] {
+                        return stopping.load() || pending.load() > 0;
+                    });
+                    if (stopping.load()) {
+                        return;
+                    }
+                }
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Task submission & execution
+
+            // Only task groups submit tasks and wait for them, which
+            // keeps the public interface of the pool minimal
+
+            friend class cppsort::detail::task_group;
+
+            template<typename Function>
+            auto submit(Function&& function)
+                -> void
+            {
+                using task_t = cppsort::detail::pool_task<std::decay_t<Function>>;
+                std::unique_ptr<cppsort::detail::pool_task_base> task(
+                    new task_t(std::decay_t<Function>(std::forward<Function>(function)))
+                );
+
+                {
+                    task_queue& queue = *queues[own_queue_index()];
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    queue.tasks.push_back(std::move(task));
+                    ++pending;
+                }
+
+                if (not workers.empty()) {
+                    // Lock to avoid losing the wake-up of a worker that
+                    // checked pending right before we incremented it
+                    std::lock_guard<std::mutex> lock(sleep_mutex);
+                    sleep_condition.notify_one();
+                }
+            }
+
+            auto try_run_pending_task()
+                -> bool
+            {
+                if (pending.load() == 0) {
+                    return false;
+                }
+                auto task = pop_task();
+                if (not task) {
+                    return false;
+                }
+                task->run();
+                return true;
+            }
+
+        public:
+
+            ////////////////////////////////////////////////////////////
+            // Construction & destruction
+
+            explicit thread_pool(std::size_t nb_workers)
+            {
+                queues.reserve(nb_workers + 1);
+                for (std::size_t i = 0 ; i < nb_workers + 1 ; ++i) {
+                    queues.push_back(std::make_unique<task_queue>());
+                }
+
+                workers.reserve(nb_workers);
+                for (std::size_t i = 0 ; i < nb_workers ; ++i) {
+                    workers.emplace_back([this, i] { worker_loop(i); });
+                }
+            }
+
+            thread_pool(const thread_pool&) = delete;
+            thread_pool& operator=(const thread_pool&) = delete;
+
+            ~thread_pool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(sleep_mutex);
+                    stopping = true;
+                }
+                sleep_condition.notify_all();
+                for (auto& worker: workers) {
+                    worker.join();
+                }
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Observers
+
+            // Number of threads that can run tasks concurrently: the
+            // worker threads plus the thread waiting for the tasks
+            auto concurrency() const noexcept
+                -> std::size_t
+            {
+                return workers.size() + 1;
+            }
+    };
+}}
+
+#endif // CPPSORT_UTILITY_THREAD_POOL_H_
@@ -3,9 +3,12 @@
  * SPDX-License-Identifier: MIT
  */
 #include <algorithm>
+#include <cstddef>
 #include <forward_list>
 #include <functional>
 #include <iterator>
+#include <random>
+#include <string>
 #include <vector>
 #include <catch2/catch.hpp>
 #include <cpp-sort/adapters/container_aware_adapter.h>
@@ -102,3 +105,81 @@ TEST_CASE( "container_aware_adapter and std::forward_list",
         CHECK( std::is_sorted(std::begin(vec_copy), std::end(vec_copy)) );
     }
 }
+
+TEST_CASE( "container_aware_adapter<merge_sorter> and std::forward_list patterns",
+           "[container_aware_adapter][merge_sorter]" )
+{
+    // The algorithm detects and reverses runs, make sure that it is
+    // stable whatever the runs look like
+
+    struct element
+    {
+        int key;
+        int position;
+    };
+
+    auto check_stable_sort = [](std::vector<int> keys) {
+        std::vector<element> vec;
+        for (std::size_t i = 0 ; i < keys.size() ; ++i) {
+            vec.push_back({ keys[i], static_cast<int>(i) });
+        }
+        std::forward_list<element> collection(std::begin(vec), std::end(vec));
+        cppsort::container_aware_adapter<cppsort::merge_sorter> sorter;
+        sorter(collection, &element::key);
+
+        std::stable_sort(std::begin(vec), std::end(vec), [](const element& lhs, const element& rhs) {
+            return lhs.key < rhs.key;
+        });
+        return std::equal(std::begin(collection), std::end(collection), std::begin(vec),
+                          [](const element& lhs, const element& rhs) {
+                              return lhs.key == rhs.key && lhs.position == rhs.position;
+                          });
+    };
+
+    std::vector<int> keys;
+    auto generate = [&keys](auto distribution, std::size_t size) {
+        keys.clear();
+        distribution(std::back_inserter(keys), size);
+        // Plenty of equivalent keys
+        for (auto& key: keys) {
+            key /= 4;
+        }
+        return keys;
+    };
+
+    CHECK( check_stable_sort({}) );
+    CHECK( check_stable_sort({ 5 }) );
+    // Big lists are sorted through an array of their nodes
+    for (std::size_t size : { 2, 3, 10, 1000, 5000 }) {
+        CHECK( check_stable_sort(generate(dist::shuffled_16_values{}, size)) );
+        CHECK( check_stable_sort(generate(dist::ascending{}, size)) );
+        CHECK( check_stable_sort(generate(dist::descending{}, size)) );
+        CHECK( check_stable_sort(generate(dist::pipe_organ{}, size)) );
+        CHECK( check_stable_sort(generate(dist::push_front{}, size)) );
+        CHECK( check_stable_sort(generate(dist::ascending_sawtooth{}, size)) );
+        CHECK( check_stable_sort(generate(dist::descending_sawtooth{}, size)) );
+        CHECK( check_stable_sort(generate(dist::alternating{}, size)) );
+    }
+}
+
+TEST_CASE( "container_aware_adapter<merge_sorter> and big std::forward_list of strings",
+           "[container_aware_adapter][merge_sorter]" )
+{
+    // Keys that are not copied next to the node positions
+
+    std::vector<std::string> vec;
+    std::mt19937 engine(Catch::rngSeed());
+    for (int i = 0 ; i < 3000 ; ++i) {
+        vec.push_back(std::to_string(engine() % 1000));
+    }
+    std::forward_list<std::string> collection(std::begin(vec), std::end(vec));
+    auto first = std::begin(collection);
+    auto value = *first;
+
+    cppsort::container_aware_adapter<cppsort::merge_sorter> sorter;
+    sorter(collection, std::greater<>{});
+    std::stable_sort(std::begin(vec), std::end(vec), std::greater<>{});
+    CHECK( std::equal(std::begin(collection), std::end(collection), std::begin(vec)) );
+    // The nodes are relinked, not their values
+    CHECK( *first == value );
+}
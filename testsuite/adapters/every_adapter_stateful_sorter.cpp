@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019 Morwenn
+ * Copyright (c) 2019-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #include <algorithm>
@@ -198,4 +198,16 @@ TEST_CASE( "test stateful sorters with every adapter",
         sort_it(collection, std::greater<>{});
         CHECK( std::is_sorted(std::begin(collection), std::end(collection), std::greater<>{}) );
     }
+
+    SECTION( "workspace_adapter" )
+    {
+        stateful_sorter<> sorter(42);
+        cppsort::workspace_adapter<stateful_sorter<>> sort_it(sorter);
+
+        sort_it(collection, std::greater<>{});
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection), std::greater<>{}) );
+
+        sort_it(li, std::greater<>{});
+        CHECK( std::is_sorted(std::begin(li), std::end(li), std::greater<>{}) );
+    }
 }
@@ -3,8 +3,10 @@
  * SPDX-License-Identifier: MIT
  */
 #include <algorithm>
+#include <array>
 #include <functional>
 #include <iterator>
+#include <string>
 #include <vector>
 #include <catch2/catch.hpp>
 #include <cpp-sort/adapters/indirect_adapter.h>
@@ -13,6 +15,36 @@
 #include <testing-tools/distributions.h>
 #include <testing-tools/span.h>
 
+namespace
+{
+    // Counts the moves performed on the elements to sort
+    struct move_counted
+    {
+        static int nb_moves;
+        int value;
+
+        explicit move_counted(int value):
+            value(value)
+        {}
+
+        move_counted(move_counted&& other) noexcept:
+            value(other.value)
+        {
+            ++nb_moves;
+        }
+
+        auto operator=(move_counted&& other) noexcept
+            -> move_counted&
+        {
+            value = other.value;
+            ++nb_moves;
+            return *this;
+        }
+    };
+
+    int move_counted::nb_moves = 0;
+}
+
 TEST_CASE( "basic tests with indirect_adapter",
            "[indirect_adapter]" )
 {
@@ -90,3 +122,82 @@ TEST_CASE( "indirect_adapter with temporary span",
         CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
     }
 }
+
+TEST_CASE( "indirect_adapter with big and small elements",
+           "[indirect_adapter]" )
+{
+    // Small trivially copyable elements are moved into place through
+    // a buffer while other ones are moved in place along the cycles of
+    // the permutation, make sure that both strategies reorder the
+    // elements correctly
+
+    struct big_element
+    {
+        std::string name;
+        std::array<int, 32> payload;
+    };
+
+    cppsort::indirect_adapter<
+        cppsort::quick_sorter
+    > sorter;
+
+    SECTION( "small elements" )
+    {
+        std::vector<long long> collection;
+        for (int i = 0 ; i < 1000 ; ++i) {
+            collection.push_back((i * 7919) % 1000);
+        }
+        auto expected = collection;
+        std::sort(std::begin(expected), std::end(expected));
+
+        sorter(collection);
+        CHECK( collection == expected );
+    }
+
+    SECTION( "small elements that aren't trivially copyable" )
+    {
+        std::vector<std::string> collection;
+        for (int i = 0 ; i < 1000 ; ++i) {
+            collection.push_back(std::to_string((i * 7919) % 1000));
+        }
+        auto expected = collection;
+        std::sort(std::begin(expected), std::end(expected));
+
+        sorter(collection);
+        CHECK( collection == expected );
+    }
+
+    SECTION( "fewest moves for elements that aren't trivially copyable" )
+    {
+        std::vector<move_counted> collection;
+        collection.reserve(1000);
+        for (int i = 0 ; i < 1000 ; ++i) {
+            collection.emplace_back((i * 7919) % 1000);
+        }
+
+        move_counted::nb_moves = 0;
+        sorter(collection, &move_counted::value);
+        CHECK( helpers::is_sorted(std::begin(collection), std::end(collection),
+                                  std::less<>{}, &move_counted::value) );
+        CHECK( move_counted::nb_moves <= 1500 );
+    }
+
+    SECTION( "big elements" )
+    {
+        std::vector<big_element> collection;
+        for (int i = 0 ; i < 1000 ; ++i) {
+            big_element elem;
+            elem.name = std::to_string((i * 7919) % 1000);
+            elem.payload.fill((i * 7919) % 1000);
+            collection.push_back(elem);
+        }
+
+        sorter(collection, &big_element::name);
+        CHECK( helpers::is_sorted(std::begin(collection), std::end(collection),
+                                  std::less<>{}, &big_element::name) );
+        CHECK( std::all_of(std::begin(collection), std::end(collection), [](const big_element& elem) {
+            return std::to_string(elem.payload.front()) == elem.name
+                && elem.payload.front() == elem.payload.back();
+        }) );
+    }
+}
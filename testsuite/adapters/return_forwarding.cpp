@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018 Morwenn
+ * Copyright (c) 2018-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #include <functional>
@@ -115,6 +115,16 @@ TEST_CASE( "check that adapters correctly forward the result of the wrapped sort
         CHECK( sort(vec) == 42 );
         CHECK( sort(vec.begin(), vec.end(), std::less<>{}, cppsort::utility::identity{}) == 42 );
         CHECK( sort(vec.begin(), vec.end(), cppsort::utility::identity{}) == 42 );
+
+#ifdef __cpp_lib_uncaught_exceptions
+        // Radix keys replace the adapted sorter only when it returns nothing
+        auto radix_sort = cppsort::schwartz_adapter<
+            return_sorter,
+            cppsort::utility::radix_keys
+        >{};
+        CHECK( radix_sort(vec, std::negate<>{}) == 42 );
+        CHECK( radix_sort(vec, std::greater<>{}, std::negate<>{}) == 42 );
+#endif
     }
 
     SECTION( "self_sort_adapter" )
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/adapters/schwartz_adapter.h>
+#include <cpp-sort/sorters.h>
+#include <cpp-sort/utility/buffer.h>
+#include <testing-tools/algorithm.h>
+
+namespace
+{
+    struct element
+    {
+        std::string name;
+        int position;
+    };
+
+    auto get_key(const element& elem)
+        -> std::string
+    {
+        // Only keep the first character to get plenty of equivalent keys
+        return elem.name.substr(0, 1);
+    }
+}
+
+TEST_CASE( "schwartz_adapter over random-access iterators",
+           "[schwartz_adapter]" )
+{
+    // With random-access iterators and types that are not trivially
+    // copyable, the projected keys are sorted in an array distinct from
+    // the original elements which are only moved into place once the
+    // keys are sorted
+
+    std::mt19937 engine(Catch::rngSeed());
+    std::vector<element> collection;
+    for (int i = 0 ; i < 1500 ; ++i) {
+        collection.push_back({ std::to_string(engine() % 1000), i });
+    }
+
+    SECTION( "stable sorter" )
+    {
+        cppsort::schwartz_adapter<cppsort::merge_sorter> sorter;
+        sorter(collection, &get_key);
+        CHECK( std::is_sorted(collection.begin(), collection.end(), [](auto& lhs, auto& rhs) {
+            auto lhs_key = get_key(lhs);
+            auto rhs_key = get_key(rhs);
+            return lhs_key < rhs_key || (lhs_key == rhs_key && lhs.position < rhs.position);
+        }) );
+    }
+
+    SECTION( "stable sorter with iterators and comparison" )
+    {
+        cppsort::schwartz_adapter<cppsort::tim_sorter> sorter;
+        sorter(collection.begin(), collection.end(), std::greater<>{}, &get_key);
+        CHECK( std::is_sorted(collection.begin(), collection.end(), [](auto& lhs, auto& rhs) {
+            auto lhs_key = get_key(lhs);
+            auto rhs_key = get_key(rhs);
+            return lhs_key > rhs_key || (lhs_key == rhs_key && lhs.position < rhs.position);
+        }) );
+    }
+
+    SECTION( "radix sorter on the keys" )
+    {
+        cppsort::schwartz_adapter<cppsort::spread_sorter> sorter;
+        sorter(collection, &element::position);
+        CHECK( helpers::is_sorted(collection.begin(), collection.end(),
+                                  std::less<>{}, &element::position) );
+        CHECK( collection.back().position == 1499 );
+    }
+}
+
+TEST_CASE( "schwartz_adapter with trivially copyable elements and arithmetic keys",
+           "[schwartz_adapter]" )
+{
+    // Arithmetic keys are sorted in an array distinct from the original
+    // elements even when the latter are trivially copyable
+
+    struct point
+    {
+        int x;
+        double y;
+    };
+
+    std::mt19937 engine(Catch::rngSeed());
+    std::vector<point> collection;
+    for (int i = 0 ; i < 1500 ; ++i) {
+        collection.push_back({ static_cast<int>(engine() % 1000) - 500, static_cast<double>(i) });
+    }
+    auto expected = collection;
+    std::stable_sort(expected.begin(), expected.end(), [](const point& lhs, const point& rhs) {
+        return lhs.x < rhs.x;
+    });
+    auto same_points = [](const point& lhs, const point& rhs) {
+        return lhs.x == rhs.x && lhs.y == rhs.y;
+    };
+
+    SECTION( "radix sorter" )
+    {
+        cppsort::schwartz_adapter<cppsort::ska_sorter> sorter;
+        sorter(collection, &point::x);
+        CHECK( helpers::is_sorted(collection.begin(), collection.end(), std::less<>{}, &point::x) );
+        CHECK( std::is_permutation(collection.begin(), collection.end(), expected.begin(), same_points) );
+    }
+
+    SECTION( "stable sorter" )
+    {
+        cppsort::schwartz_adapter<cppsort::merge_sorter> sorter;
+        sorter(collection, &point::x);
+        CHECK( std::equal(collection.begin(), collection.end(), expected.begin(), same_points) );
+    }
+}
+
+TEST_CASE( "schwartz_adapter with move-only types",
+           "[schwartz_adapter]" )
+{
+    std::mt19937 engine(Catch::rngSeed());
+    std::vector<std::unique_ptr<int>> collection;
+    for (int i = 0 ; i < 500 ; ++i) {
+        collection.push_back(std::make_unique<int>(i));
+    }
+    std::shuffle(collection.begin(), collection.end(), engine);
+
+    auto deref = [](const std::unique_ptr<int>& ptr) { return *ptr; };
+    cppsort::schwartz_adapter<cppsort::pdq_sorter> sorter;
+    sorter(collection, deref);
+    CHECK( helpers::is_sorted(collection.begin(), collection.end(), std::less<>{}, deref) );
+    CHECK( *collection.front() == 0 );
+}
+
+TEMPLATE_TEST_CASE( "every random-access sorter with separately sorted keys", "[schwartz_adapter]",
+                    cppsort::block_sorter<cppsort::utility::fixed_buffer<0>>,
+                    cppsort::drop_merge_sorter,
+                    cppsort::grail_sorter<>,
+                    cppsort::heap_sorter,
+                    cppsort::insertion_sorter,
+                    cppsort::merge_insertion_sorter,
+                    cppsort::merge_sorter,
+                    cppsort::pdq_sorter,
+                    cppsort::poplar_sorter,
+                    cppsort::quick_merge_sorter,
+                    cppsort::quick_sorter,
+                    cppsort::selection_sorter,
+                    cppsort::ska_sorter,
+                    cppsort::smooth_sorter,
+                    cppsort::spin_sorter,
+                    cppsort::split_sorter,
+                    cppsort::spread_sorter,
+                    cppsort::tim_sorter,
+                    cppsort::verge_sorter )
+{
+    std::mt19937 engine(Catch::rngSeed());
+    std::vector<element> collection;
+    for (int i = 0 ; i < 412 ; ++i) {
+        collection.push_back({ std::to_string(i), i });
+    }
+    std::shuffle(collection.begin(), collection.end(), engine);
+
+    cppsort::schwartz_adapter<TestType> sorter;
+    sorter(collection, &element::position);
+    CHECK( helpers::is_sorted(collection.begin(), collection.end(),
+                              std::less<>{}, &element::position) );
+    CHECK( collection.front().name == "0" );
+}
+
+TEST_CASE( "schwartz_adapter with radix keys",
+           "[schwartz_adapter][radix_keys]" )
+{
+    // Projected elements are encoded into integers that are radix
+    // sorted, then the adapted sorter breaks the remaining ties; the
+    // stability of the adapted sorter must be preserved
+
+    std::mt19937 engine(Catch::rngSeed());
+    std::vector<element> collection;
+    for (int i = 0 ; i < 1500 ; ++i) {
+        auto value = static_cast<int>(engine() % 200) - 100;
+        collection.push_back({ "item_" + std::to_string(value), i });
+    }
+
+    auto check_stable_sort = [&](auto compare, auto projection) {
+        auto copy = collection;
+        cppsort::schwartz_adapter<cppsort::merge_sorter, cppsort::utility::radix_keys> sorter;
+        sorter(copy, compare, projection);
+
+        auto expected = collection;
+        std::stable_sort(expected.begin(), expected.end(), [&](auto& lhs, auto& rhs) {
+            return compare(projection(lhs), projection(rhs));
+        });
+        for (std::size_t i = 0 ; i < copy.size() ; ++i) {
+            if (copy[i].position != expected[i].position) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    SECTION( "exactly encoded keys" )
+    {
+        auto by_value = [](const element& elem) { return std::stoi(elem.name.substr(5)); };
+        CHECK( check_stable_sort(std::less<>{}, by_value) );
+        CHECK( check_stable_sort(std::greater<>{}, by_value) );
+
+        auto by_double = [](const element& elem) { return std::stoi(elem.name.substr(5)) / 4.0; };
+        CHECK( check_stable_sort(std::less<>{}, by_double) );
+    }
+
+    SECTION( "strings" )
+    {
+        auto by_name = [](const element& elem) { return elem.name; };
+        CHECK( check_stable_sort(std::less<>{}, by_name) );
+        CHECK( check_stable_sort(std::greater<>{}, by_name) );
+    }
+
+    SECTION( "tuples" )
+    {
+        auto by_tuple = [](const element& elem) {
+            return std::make_tuple(elem.name.size(), elem.name, elem.position % 3);
+        };
+        CHECK( check_stable_sort(std::less<>{}, by_tuple) );
+        CHECK( check_stable_sort(std::greater<>{}, by_tuple) );
+    }
+
+    SECTION( "unstable sorter" )
+    {
+        cppsort::schwartz_adapter<cppsort::pdq_sorter, cppsort::utility::radix_keys> sorter;
+        sorter(collection, &get_key);
+        CHECK( helpers::is_sorted(collection.begin(), collection.end(), std::less<>{}, &get_key) );
+    }
+
+    SECTION( "fallback for unsupported comparisons" )
+    {
+        cppsort::schwartz_adapter<cppsort::pdq_sorter, cppsort::utility::radix_keys> sorter;
+        sorter(collection, std::less<std::string>{}, &element::name);
+        CHECK( helpers::is_sorted(collection.begin(), collection.end(), std::less<>{}, &element::name) );
+    }
+}
@@ -11,6 +11,7 @@
 #include <catch2/catch.hpp>
 #include <cpp-sort/adapters/stable_adapter.h>
 #include <cpp-sort/sorters.h>
+#include <cpp-sort/sorters/parallel_merge_sorter.h>
 #include <cpp-sort/utility/buffer.h>
 #include <testing-tools/algorithm.h>
 
@@ -44,6 +45,7 @@ TEMPLATE_TEST_CASE( "every random-access sorter with stable_adapter", "[stable_a
                     cppsort::insertion_sorter,
                     cppsort::merge_insertion_sorter,
                     cppsort::merge_sorter,
+                    cppsort::parallel_merge_sorter<>,
                     cppsort::pdq_sorter,
                     cppsort::poplar_sorter,
                     cppsort::quick_merge_sorter,
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/adapters/hybrid_adapter.h>
+#include <cpp-sort/adapters/schwartz_adapter.h>
+#include <cpp-sort/adapters/workspace_adapter.h>
+#include <cpp-sort/sorters/merge_sorter.h>
+#include <cpp-sort/sorters/spin_sorter.h>
+#include <cpp-sort/sorters/tim_sorter.h>
+#include <cpp-sort/utility/memory_resource.h>
+#include <testing-tools/algorithm.h>
+#include <testing-tools/distributions.h>
+
+namespace
+{
+    // Counts the allocations that reach the global operator new
+    struct counting_resource final:
+        cppsort::utility::memory_resource
+    {
+        std::size_t allocations = 0;
+
+        auto do_allocate(std::size_t bytes, std::size_t alignment)
+            -> void* override
+        {
+            ++allocations;
+            return cppsort::utility::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        auto do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment)
+            -> void override
+        {
+            cppsort::utility::new_delete_resource()->deallocate(pointer, bytes, alignment);
+        }
+    };
+
+    struct wrapper { int value; };
+}
+
+TEMPLATE_TEST_CASE( "workspace_adapter keeps its memory between calls", "[workspace_adapter]",
+                    cppsort::spin_sorter,
+                    cppsort::tim_sorter )
+{
+    std::vector<int> original;
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(original), 5000, -1000);
+
+    // Make sure that the memory the adapter doesn't handle
+    // itself ends up in a resource that counts allocations
+    counting_resource resource;
+    cppsort::utility::scoped_memory_resource _(&resource);
+
+    cppsort::workspace_adapter<TestType> sorter;
+    CHECK( sorter.capacity() == 0 );
+
+    auto collection = original;
+    sorter(collection);
+    CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    collection = original;
+    sorter(collection, std::greater<>{});
+    CHECK( std::is_sorted(std::begin(collection), std::end(collection), std::greater<>{}) );
+    CHECK( sorter.capacity() > 0 );
+
+    // The workspace grows to the peak memory use of the previous
+    // sorts the next time it is empty, after which the memory stays
+    // in the workspace
+    collection = original;
+    sorter(collection);
+    CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    auto allocations = resource.allocations;
+    for (int i = 0 ; i < 3 ; ++i) {
+        collection = original;
+        sorter(std::begin(collection), std::end(collection));
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+    CHECK( resource.allocations == allocations );
+
+    sorter.shrink_to_fit();
+    CHECK( sorter.capacity() == 0 );
+
+    sorter.reserve(100'000);
+    CHECK( sorter.capacity() >= 100'000 );
+    collection = original;
+    sorter(collection);
+    CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+
+    // Copies get their own workspace
+    auto copy = sorter;
+    CHECK( copy.capacity() == 0 );
+}
+
+TEST_CASE( "workspace_adapter copies keep the upstream resource", "[workspace_adapter]" )
+{
+    counting_resource upstream;
+    cppsort::utility::scoped_memory_resource _(&upstream);
+    cppsort::workspace_adapter<cppsort::tim_sorter> sorter;
+
+    // The copy takes its memory from the resource the original
+    // adapter was created with, not from the current one
+    counting_resource other;
+    cppsort::utility::scoped_memory_resource _2(&other);
+    auto copy = sorter;
+    copy.reserve(1000);
+    CHECK( copy.capacity() >= 1000 );
+    CHECK( upstream.allocations == 1 );
+    CHECK( other.allocations == 0 );
+}
+
+TEST_CASE( "workspace_adapter composition with other adapters", "[workspace_adapter]" )
+{
+    std::vector<int> original;
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(original), 5000, -1000);
+
+    SECTION( "schwartz_adapter" )
+    {
+        std::vector<wrapper> collection;
+        for (int value: original) {
+            collection.push_back({value});
+        }
+        const cppsort::schwartz_adapter<
+            cppsort::workspace_adapter<cppsort::tim_sorter>
+        > sorter;
+        sorter(collection, &wrapper::value);
+        CHECK( helpers::is_sorted(std::begin(collection), std::end(collection),
+                                  std::less<>{}, &wrapper::value) );
+    }
+
+    SECTION( "hybrid_adapter" )
+    {
+        const cppsort::hybrid_adapter<
+            cppsort::workspace_adapter<cppsort::tim_sorter>,
+            cppsort::workspace_adapter<cppsort::merge_sorter>
+        > sorter;
+        auto collection = original;
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+
+        std::list<int> li(std::begin(original), std::end(original));
+        sorter(li, std::greater<>{});
+        CHECK( std::is_sorted(std::begin(li), std::end(li), std::greater<>{}) );
+    }
+}
@@ -2,13 +2,20 @@
  * Copyright (c) 2016-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
+#include <algorithm>
 #include <array>
+#include <cctype>
+#include <list>
 #include <locale>
+#include <random>
 #include <string>
+#include <vector>
 #include <catch2/catch.hpp>
+#include <cpp-sort/adapters/schwartz_adapter.h>
 #include <cpp-sort/comparators/case_insensitive_less.h>
 #include <cpp-sort/refined.h>
 #include <cpp-sort/sorters/heap_sorter.h>
+#include <cpp-sort/sorters/pdq_sorter.h>
 
 namespace sub
 {
@@ -95,3 +102,69 @@ TEST_CASE( "case-insensitive string comparison with case_insensitive_less" )
     }
 }
 
+TEST_CASE( "case_insensitive_less with long common prefixes" )
+{
+    // Reference comparison with the classic locale
+    auto reference_less = [](const std::string& lhs, const std::string& rhs) {
+        std::string lhs_lower, rhs_lower;
+        for (char c: lhs) lhs_lower.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+        for (char c: rhs) rhs_lower.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+        return lhs_lower < rhs_lower;
+    };
+
+    // Strings that share prefixes of various lengths and only differ
+    // by their case or by a single character, including non-ASCII ones
+    std::mt19937 engine(Catch::rngSeed());
+    const std::string alphabet = "aAbBzZ@[`{09_\xe9\xc9";
+    std::vector<std::string> strings;
+    for (std::size_t size : { 0, 1, 15, 16, 17, 31, 32, 33, 64, 100 }) {
+        std::string prefix;
+        for (std::size_t i = 0 ; i < size ; ++i) {
+            prefix.push_back(alphabet[engine() % alphabet.size()]);
+        }
+        for (int i = 0 ; i < 10 ; ++i) {
+            std::string str = prefix;
+            for (auto& c: str) {
+                if (engine() % 2 == 0) {
+                    c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                }
+            }
+            if (engine() % 2 == 0) {
+                str.push_back(alphabet[engine() % alphabet.size()]);
+            }
+            strings.push_back(str);
+        }
+    }
+
+    auto refined_less = cppsort::refined<std::string>(cppsort::case_insensitive_less(std::locale::classic()));
+    for (const auto& lhs: strings) {
+        for (const auto& rhs: strings) {
+            bool expected = reference_less(lhs, rhs);
+            CHECK( cppsort::case_insensitive_less(std::locale::classic())(lhs, rhs) == expected );
+            CHECK( refined_less(lhs, rhs) == expected );
+        }
+    }
+
+    SECTION( "non-contiguous sequences" )
+    {
+        for (const auto& lhs: strings) {
+            for (const auto& rhs: strings) {
+                std::list<char> lhs_list(lhs.begin(), lhs.end());
+                std::list<char> rhs_list(rhs.begin(), rhs.end());
+                CHECK( cppsort::case_insensitive_less(std::locale::classic())(lhs_list, rhs_list)
+                       == reference_less(lhs, rhs) );
+            }
+        }
+    }
+
+    SECTION( "case-folded keys" )
+    {
+        CHECK( cppsort::case_folded(std::string("aBc@[Z")) == "abc@[z" );
+        CHECK( cppsort::case_folded(std::locale::classic())(std::wstring(L"XyZ")) == L"xyz" );
+
+        auto copy = strings;
+        cppsort::schwartz_adapter<cppsort::pdq_sorter> sorter;
+        sorter(copy, cppsort::case_folded);
+        CHECK( std::is_sorted(copy.begin(), copy.end(), cppsort::case_insensitive_less) );
+    }
+}
@@ -2,11 +2,17 @@
  * Copyright (c) 2016-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
+#include <algorithm>
 #include <array>
+#include <cstddef>
+#include <random>
 #include <string>
+#include <vector>
 #include <catch2/catch.hpp>
+#include <cpp-sort/adapters/schwartz_adapter.h>
 #include <cpp-sort/comparators/natural_less.h>
 #include <cpp-sort/sorters/heap_sorter.h>
+#include <cpp-sort/sorters/pdq_sorter.h>
 
 TEST_CASE( "string natural sort with natural_less" )
 {
@@ -33,3 +39,59 @@ TEST_CASE( "string natural sort with natural_less" )
     CHECK( array == expected );
 }
 
+TEST_CASE( "natural_less corner cases" )
+{
+    using namespace std::string_literals;
+
+    // Equal numbers followed by different characters
+    CHECK( cppsort::natural_less("Yay 45"s, "Yay 45 a"s) );
+    CHECK_FALSE( cppsort::natural_less("Yay 45 a"s, "Yay 45"s) );
+    CHECK( cppsort::natural_less("a05b"s, "a5c"s) );
+    CHECK( cppsort::natural_less("a0b"s, "a00c"s) );
+    CHECK_FALSE( cppsort::natural_less("a00c"s, "a0b"s) );
+
+    // Leading zeros don't matter
+    CHECK_FALSE( cppsort::natural_less("Yay 045"s, "Yay 45"s) );
+    CHECK_FALSE( cppsort::natural_less("Yay 45"s, "Yay 045"s) );
+
+    // Numbers compare to other characters like digits
+    CHECK( cppsort::natural_less("a!"s, "a05"s) );
+    CHECK( cppsort::natural_less("a99"s, "a:"s) );
+}
+
+TEST_CASE( "natural order keys with natural_key" )
+{
+    // Random strings with many digits and leading zeros
+    std::mt19937 engine(Catch::rngSeed());
+    const std::string alphabet = "000123789a!:\xe9";
+    std::vector<std::string> strings;
+    for (int i = 0 ; i < 300 ; ++i) {
+        std::string str;
+        auto size = engine() % 8;
+        for (std::size_t j = 0 ; j < size ; ++j) {
+            str.push_back(alphabet[engine() % alphabet.size()]);
+        }
+        strings.push_back(str);
+    }
+    // Numbers with more than 255 significant digits
+    strings.push_back("a" + std::string(300, '1'));
+    strings.push_back("a" + std::string(300, '1') + "2");
+    strings.push_back("a" + std::string(299, '9'));
+
+    SECTION( "same order as natural_less" )
+    {
+        for (const auto& lhs: strings) {
+            for (const auto& rhs: strings) {
+                CHECK( (cppsort::natural_key(lhs) < cppsort::natural_key(rhs))
+                       == cppsort::natural_less(lhs, rhs) );
+            }
+        }
+    }
+
+    SECTION( "sort with cached keys" )
+    {
+        cppsort::schwartz_adapter<cppsort::pdq_sorter> sorter;
+        sorter(strings, cppsort::natural_key);
+        CHECK( std::is_sorted(strings.begin(), strings.end(), cppsort::natural_less) );
+    }
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2019 Morwenn
+ * Copyright (c) 2016-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #include <algorithm>
@@ -9,6 +9,11 @@
 #include <vector>
 #include <catch2/catch.hpp>
 #include <cpp-sort/sorters.h>
+#include <cpp-sort/sorters/parallel_counting_sorter.h>
+#include <cpp-sort/sorters/parallel_merge_sorter.h>
+#include <cpp-sort/sorters/parallel_pdq_sorter.h>
+#include <cpp-sort/sorters/parallel_ska_sorter.h>
+#include <cpp-sort/sorters/parallel_spread_sorter.h>
 #include <testing-tools/distributions.h>
 
 TEST_CASE( "test every instantiated sorter", "[sorters]" )
@@ -28,6 +33,12 @@ TEST_CASE( "test every instantiated sorter", "[sorters]" )
     std::list<long long int> li(std::begin(collection), std::end(collection));
     std::forward_list<long long int> fli(std::begin(collection), std::end(collection));
 
+    SECTION( "adaptive_sort" )
+    {
+        cppsort::adaptive_sort(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
     SECTION( "block_sort" )
     {
         cppsort::block_sort(collection);
@@ -76,6 +87,36 @@ TEST_CASE( "test every instantiated sorter", "[sorters]" )
         CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
     }
 
+    SECTION( "parallel_counting_sorter" )
+    {
+        cppsort::parallel_counting_sort(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "parallel_merge_sorter" )
+    {
+        cppsort::parallel_merge_sort(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "parallel_pdq_sorter" )
+    {
+        cppsort::parallel_pdq_sort(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "parallel_ska_sorter" )
+    {
+        cppsort::parallel_ska_sort(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "parallel_spread_sorter" )
+    {
+        cppsort::parallel_spread_sort(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
     SECTION( "pdq_sorter" )
     {
         cppsort::pdq_sort(collection);
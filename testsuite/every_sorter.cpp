@@ -10,11 +10,17 @@
 #include <vector>
 #include <catch2/catch.hpp>
 #include <cpp-sort/sorters.h>
+#include <cpp-sort/sorters/parallel_counting_sorter.h>
+#include <cpp-sort/sorters/parallel_merge_sorter.h>
+#include <cpp-sort/sorters/parallel_pdq_sorter.h>
+#include <cpp-sort/sorters/parallel_ska_sorter.h>
+#include <cpp-sort/sorters/parallel_spread_sorter.h>
 #include <cpp-sort/utility/buffer.h>
 #include <cpp-sort/utility/functional.h>
 #include <testing-tools/distributions.h>
 
 TEMPLATE_TEST_CASE( "test every random-access sorter with vector", "[sorters]",
+                    cppsort::adaptive_sorter,
                     cppsort::block_sorter<>,
                     cppsort::block_sorter<
                         cppsort::utility::dynamic_buffer<cppsort::utility::half>
@@ -29,6 +35,10 @@ TEMPLATE_TEST_CASE( "test every random-access sorter with vector", "[sorters]",
                     cppsort::insertion_sorter,
                     cppsort::merge_insertion_sorter,
                     cppsort::merge_sorter,
+                    cppsort::parallel_counting_sorter<>,
+                    cppsort::parallel_merge_sorter<>,
+                    cppsort::parallel_pdq_sorter<>,
+                    cppsort::parallel_ska_sorter<>,
                     cppsort::pdq_sorter,
                     cppsort::poplar_sorter,
                     cppsort::quick_merge_sorter,
@@ -57,6 +67,7 @@ TEMPLATE_TEST_CASE( "test every random-access sorter with vector", "[sorters]",
 }
 
 TEMPLATE_TEST_CASE( "test every random-access sorter with deque", "[sorters]",
+                    cppsort::adaptive_sorter,
                     cppsort::block_sorter<>,
                     cppsort::block_sorter<
                         cppsort::utility::dynamic_buffer<cppsort::utility::half>
@@ -71,6 +82,11 @@ TEMPLATE_TEST_CASE( "test every random-access sorter with deque", "[sorters]",
                     cppsort::insertion_sorter,
                     cppsort::merge_insertion_sorter,
                     cppsort::merge_sorter,
+                    cppsort::parallel_counting_sorter<>,
+                    cppsort::parallel_merge_sorter<>,
+                    cppsort::parallel_pdq_sorter<>,
+                    cppsort::parallel_ska_sorter<>,
+                    cppsort::parallel_spread_sorter<>,
                     cppsort::pdq_sorter,
                     cppsort::poplar_sorter,
                     cppsort::quick_merge_sorter,
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/probes/accumulators.h>
+#include <cpp-sort/probes/dis.h>
+#include <cpp-sort/probes/mono.h>
+#include <cpp-sort/probes/rem.h>
+#include <cpp-sort/probes/runs.h>
+
+namespace
+{
+    // Pushes the collection chunk by chunk and checks after every chunk
+    // that the accumulators agree with the probes on the elements seen
+    // so far
+    template<typename T, typename Compare, typename Projection>
+    auto check_accumulators(const std::vector<T>& collection,
+                            Compare compare, Projection projection)
+        -> void
+    {
+        cppsort::probe::dis_accumulator<T, Compare, Projection> dis(compare, projection);
+        cppsort::probe::mono_accumulator<T, Compare, Projection> mono(compare, projection);
+        cppsort::probe::rem_accumulator<T, Compare, Projection> rem(compare, projection);
+        cppsort::probe::runs_accumulator<T, Compare, Projection> runs(compare, projection);
+
+        std::size_t pos = 0;
+        std::size_t chunk_size = 1;
+        while (pos < collection.size()) {
+            auto first = collection.begin() + pos;
+            auto last = collection.begin() + std::min(pos + chunk_size, collection.size());
+            dis.push(first, last);
+            mono.push(first, last);
+            rem.push(first, last);
+            runs.push(first, last);
+            pos = last - collection.begin();
+            chunk_size = chunk_size * 2 + 1;
+
+            auto end = collection.begin() + pos;
+            CHECK( dis.size() == static_cast<std::ptrdiff_t>(pos) );
+            CHECK( dis.value() == cppsort::probe::dis(collection.begin(), end, compare, projection) );
+            CHECK( mono.value() == cppsort::probe::mono(collection.begin(), end, compare, projection) );
+            CHECK( rem.value() == cppsort::probe::rem(collection.begin(), end, compare, projection) );
+            CHECK( runs.value() == cppsort::probe::runs(collection.begin(), end, compare, projection) );
+        }
+    }
+}
+
+TEST_CASE( "measures of presortedness accumulators", "[probe][accumulators]" )
+{
+    SECTION( "empty accumulators" )
+    {
+        cppsort::probe::rem_accumulator<int> rem;
+        CHECK( rem.value() == 0 );
+        CHECK( rem.size() == 0 );
+
+        cppsort::probe::dis_accumulator<int> dis;
+        dis.push(5);
+        CHECK( dis.value() == 0 );
+        CHECK( dis.size() == 1 );
+    }
+
+    SECTION( "simple test" )
+    {
+        const std::vector<int> vec = { 6, 3, 9, 8, 4, 7, 1, 11 };
+        cppsort::probe::runs_accumulator<int> runs;
+        cppsort::probe::mono_accumulator<int> mono;
+        for (int value: vec) {
+            runs.push(value);
+            mono.push(value);
+        }
+        CHECK( runs.value() == cppsort::probe::runs(vec) );
+        CHECK( mono.value() == cppsort::probe::mono(vec) );
+    }
+
+    SECTION( "random chunks" )
+    {
+        std::mt19937 engine(Catch::rngSeed());
+        for (int modulo : { 4, 100, 1'000'000 }) {
+            std::vector<int> collection;
+            for (int i = 0 ; i < 500 ; ++i) {
+                collection.push_back(static_cast<int>(engine() % modulo));
+            }
+            check_accumulators(collection, std::less<>{}, cppsort::utility::identity{});
+            check_accumulators(collection, std::greater<>{}, cppsort::utility::identity{});
+            check_accumulators(collection, std::less<>{}, std::negate<>{});
+        }
+    }
+
+    SECTION( "copied keys" )
+    {
+        std::vector<std::string> collection = { "c", "a", "d", "b", "e", "a" };
+        auto size = [](const std::string& str) { return str.size(); };
+        check_accumulators(collection, std::less<>{}, cppsort::utility::identity{});
+        check_accumulators(collection, std::greater<>{}, size);
+    }
+}
@@ -6,6 +6,7 @@
 #include <vector>
 #include <catch2/catch.hpp>
 #include <cpp-sort/probes.h>
+#include <cpp-sort/probes/parallel_inv.h>
 #include <testing-tools/distributions.h>
 #include <testing-tools/functional_checks.h>
 
@@ -18,6 +19,7 @@ TEMPLATE_TEST_CASE( "every probe with comparison function altered by move", "[pr
                     decltype(cppsort::probe::max),
                     decltype(cppsort::probe::mono),
                     decltype(cppsort::probe::osc),
+                    decltype(cppsort::probe::parallel_inv),
                     decltype(cppsort::probe::par),
                     decltype(cppsort::probe::rem),
                     decltype(cppsort::probe::runs) )
@@ -40,6 +42,7 @@ TEMPLATE_TEST_CASE( "every probe with projection function altered by move", "[pr
                     decltype(cppsort::probe::max),
                     decltype(cppsort::probe::mono),
                     decltype(cppsort::probe::osc),
+                    decltype(cppsort::probe::parallel_inv),
                     decltype(cppsort::probe::par),
                     decltype(cppsort::probe::rem),
                     decltype(cppsort::probe::runs) )
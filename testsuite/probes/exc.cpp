@@ -1,8 +1,10 @@
 /*
- * Copyright (c) 2016-2019 Morwenn
+ * Copyright (c) 2016-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
+#include <algorithm>
 #include <forward_list>
+#include <functional>
 #include <iterator>
 #include <vector>
 #include <catch2/catch.hpp>
@@ -43,6 +45,27 @@ TEST_CASE( "presortedness measure: exc", "[probe][exc]" )
         CHECK( cppsort::probe::exc(std::begin(li), std::end(li)) == 10 );
     }
 
+    SECTION( "equivalent elements" )
+    {
+        // Sorted: 1 1 1 2 2 2, the 2s at positions 0 and 2 can be
+        // exchanged with the 1s at positions 3 and 5
+        std::vector<int> collection = { 2, 1, 2, 1, 2, 1 };
+        CHECK( cppsort::probe::exc(collection) == 2 );
+
+        // Sorted: 2 2 1 1, exchanging the elements at positions
+        // 0 and 3 is enough
+        std::vector<int> collection2 = { 1, 2, 1, 2 };
+        CHECK( cppsort::probe::exc(collection2, std::greater<>{}) == 1 );
+
+        // Sorted: 1 1 2 2 3 3, positions 0, 2 and 4 form a cycle of
+        // three elements and positions 1 and 5 a cycle of two
+        // elements, the 2 at position 3 is already in place
+        std::vector<int> collection3 = { 3, 3, 1, 2, 2, 1 };
+        CHECK( cppsort::probe::exc(collection3) == 3 );
+        // Sorted: 3 3 2 2 1 1, only positions 2 and 4 are misplaced
+        CHECK( cppsort::probe::exc(collection3, std::greater<>{}) == 1 );
+    }
+
     SECTION( "regressions" )
     {
         std::vector<int> collection;
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <forward_list>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/probes.h>
+#include <cpp-sort/probes/fused.h>
+#include <testing-tools/internal_compare.h>
+
+namespace
+{
+    template<typename Iterable, typename... Args>
+    auto check_measurements(const Iterable& iterable, Args... args)
+        -> void
+    {
+        using namespace cppsort::probe;
+
+        auto res = fused(iterable, args...);
+        CHECK( res.dis == dis(iterable, args...) );
+        CHECK( res.enc == enc(iterable, args...) );
+        CHECK( res.exc == exc(iterable, args...) );
+        CHECK( res.ham == ham(iterable, args...) );
+        CHECK( res.inv == inv(iterable, args...) );
+        CHECK( res.max == max(iterable, args...) );
+        CHECK( res.mono == mono(iterable, args...) );
+        CHECK( res.osc == osc(iterable, args...) );
+        CHECK( res.rem == rem(iterable, args...) );
+        CHECK( res.runs == runs(iterable, args...) );
+    }
+}
+
+TEST_CASE( "fused measures of presortedness", "[probe][fused]" )
+{
+    SECTION( "simple tests" )
+    {
+        std::forward_list<int> li = { 6, 3, 9, 8, 4, 7, 1, 11 };
+        check_measurements(li);
+        check_measurements(li, std::greater<>{});
+
+        std::vector<internal_compare<int>> tricky(li.begin(), li.end());
+        check_measurements(tricky, &internal_compare<int>::compare_to);
+    }
+
+    SECTION( "lower bound" )
+    {
+        const std::vector<int> vec = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+        auto res = cppsort::probe::fused(vec);
+        CHECK( res.dis == 0 );
+        CHECK( res.enc == 0 );
+        CHECK( res.exc == 0 );
+        CHECK( res.ham == 0 );
+        CHECK( res.inv == 0 );
+        CHECK( res.max == 0 );
+        CHECK( res.mono == 0 );
+        CHECK( res.osc == 0 );
+        CHECK( res.rem == 0 );
+        CHECK( res.runs == 0 );
+    }
+
+    SECTION( "small collections" )
+    {
+        std::vector<int> vec;
+        check_measurements(vec);
+        vec.push_back(1);
+        check_measurements(vec);
+        vec.push_back(0);
+        check_measurements(vec);
+    }
+
+    SECTION( "random collections" )
+    {
+        std::mt19937 engine(Catch::rngSeed());
+        for (int modulo : { 4, 50, 1'000'000 }) {
+            std::vector<long long int> vec;
+            for (int i = 0 ; i < 300 ; ++i) {
+                vec.push_back(engine() % modulo);
+            }
+            check_measurements(vec);
+            check_measurements(vec, std::greater<>{});
+            check_measurements(vec, std::less<>{}, std::negate<>{});
+
+            std::forward_list<long long int> li(vec.begin(), vec.end());
+            check_measurements(li);
+        }
+    }
+}
+
+TEST_CASE( "fused probe with a subset of measures", "[probe][fused]" )
+{
+    using cppsort::probe::measure;
+
+    const std::vector<int> vec = { 48, 43, 96, 44, 42, 34, 42, 57, 68, 69 };
+
+    auto res = cppsort::probe::fused_probe<measure::runs | measure::rem>{}(vec);
+    CHECK( res.runs == cppsort::probe::runs(vec) );
+    CHECK( res.rem == cppsort::probe::rem(vec) );
+    CHECK( res.inv == 0 );
+    CHECK( res.dis == 0 );
+
+    auto res2 = cppsort::probe::fused_probe<measure::dis | measure::max>{}(vec.begin(), vec.end());
+    CHECK( res2.dis == cppsort::probe::dis(vec) );
+    CHECK( res2.max == cppsort::probe::max(vec) );
+    CHECK( res2.runs == 0 );
+    CHECK( res2.ham == 0 );
+}
@@ -1,8 +1,9 @@
 /*
- * Copyright (c) 2016-2018 Morwenn
+ * Copyright (c) 2016-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #include <forward_list>
+#include <functional>
 #include <iterator>
 #include <vector>
 #include <catch2/catch.hpp>
@@ -24,6 +25,24 @@ TEST_CASE( "presortedness measure: osc", "[probe][osc]" )
         CHECK( cppsort::probe::osc(tricky, &internal_compare<int>::compare_to) == 17 );
     }
 
+    SECTION( "reversed order" )
+    {
+        // Being strictly between the elements of a pair doesn't depend
+        // on the order: 2 is between 4 and 1 and between 1 and 3, 3 is
+        // between 2 and 4 and between 4 and 1
+        std::vector<int> collection = { 2, 4, 1, 3 };
+        CHECK( cppsort::probe::osc(collection) == 4 );
+        CHECK( cppsort::probe::osc(collection, std::greater<>{}) == 4 );
+
+        // Only 2 is between 3 and 1
+        std::vector<int> collection2 = { 3, 1, 2, 1 };
+        CHECK( cppsort::probe::osc(collection2) == 1 );
+        CHECK( cppsort::probe::osc(collection2, std::greater<>{}) == 1 );
+
+        std::forward_list<int> li = { 6, 3, 9, 8, 4, 7, 1, 11 };
+        CHECK( cppsort::probe::osc(li, std::greater<>{}) == 17 );
+    }
+
     SECTION( "lower bound" )
     {
         std::forward_list<int> li = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <cstddef>
+#include <forward_list>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/probes/parallel_inv.h>
+#include <cpp-sort/utility/as_function.h>
+#include <testing-tools/internal_compare.h>
+
+namespace
+{
+    // Reference implementation that shares no code with the library:
+    // the inversions are counted while merge sorting the keys
+
+    template<typename T, typename Compare>
+    auto merge_count(std::vector<T>& keys, std::vector<T>& buffer,
+                     std::size_t first, std::size_t last, Compare compare)
+        -> std::ptrdiff_t
+    {
+        if (last - first < 2) return 0;
+
+        std::size_t middle = first + (last - first) / 2;
+        auto res = merge_count(keys, buffer, first, middle, compare)
+                 + merge_count(keys, buffer, middle, last, compare);
+
+        std::size_t left = first, right = middle, out = first;
+        while (left != middle && right != last) {
+            if (compare(keys[right], keys[left])) {
+                // Every remaining key of the left run is bigger
+                res += static_cast<std::ptrdiff_t>(middle - left);
+                buffer[out++] = keys[right++];
+            } else {
+                buffer[out++] = keys[left++];
+            }
+        }
+        while (left != middle) buffer[out++] = keys[left++];
+        while (right != last) buffer[out++] = keys[right++];
+        for (std::size_t i = first ; i != last ; ++i) {
+            keys[i] = buffer[i];
+        }
+        return res;
+    }
+
+    template<typename Collection, typename Compare, typename Projection>
+    auto reference_inv(const Collection& collection, Compare compare, Projection projection)
+        -> std::ptrdiff_t
+    {
+        auto&& proj = cppsort::utility::as_function(projection);
+        using key_type = std::decay_t<decltype(proj(*std::begin(collection)))>;
+
+        std::vector<key_type> keys;
+        for (const auto& elem: collection) {
+            keys.push_back(proj(elem));
+        }
+        std::vector<key_type> buffer(keys.size());
+        return merge_count(keys, buffer, 0, keys.size(), compare);
+    }
+}
+
+TEST_CASE( "presortedness measure: parallel_inv", "[probe][parallel_inv]" )
+{
+    SECTION( "simple test" )
+    {
+        const std::forward_list<int> li = { 48, 43, 96, 44, 42, 34, 42, 57, 68, 69 };
+        CHECK( cppsort::probe::parallel_inv(li) == 19 );
+        CHECK( cppsort::probe::parallel_inv(std::begin(li), std::end(li)) == 19 );
+
+        std::vector<internal_compare<int>> tricky(li.begin(), li.end());
+        CHECK( cppsort::probe::parallel_inv(tricky, &internal_compare<int>::compare_to) == 19 );
+    }
+
+    SECTION( "upper bound" )
+    {
+        const std::forward_list<int> li = { 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 };
+        CHECK( cppsort::probe::parallel_inv(li) == 55 );
+        CHECK( cppsort::probe::parallel_inv(li, std::greater<>{}) == 0 );
+    }
+}
+
+TEST_CASE( "parallel_inv with several threads", "[probe][parallel_inv]" )
+{
+    // Use a dedicated pool to make sure that the collections are
+    // split even on machines with a single hardware thread, the
+    // results must match those of the reference implementation
+
+    cppsort::utility::thread_pool pool(3);
+    auto parallel_inv = [&pool](const auto& collection, auto compare, auto projection) {
+        cppsort::detail::task_group group(pool);
+        return cppsort::probe::detail::inv_probe_algo(
+            std::begin(collection), std::end(collection),
+            static_cast<std::ptrdiff_t>(collection.size()),
+            compare, projection,
+            cppsort::detail::parallel_inversions_counter{&group}
+        );
+    };
+
+    std::mt19937 engine(Catch::rngSeed());
+    std::vector<int> collection;
+    for (int i = 0 ; i < 150'000 ; ++i) {
+        collection.push_back(static_cast<int>(engine() % 200'000) - 100'000);
+    }
+    auto identity = cppsort::utility::identity{};
+
+    SECTION( "integer keys" )
+    {
+        CHECK( parallel_inv(collection, std::less<>{}, identity)
+               == reference_inv(collection, std::less<>{}, identity) );
+        CHECK( parallel_inv(collection, std::greater<>{}, identity)
+               == reference_inv(collection, std::greater<>{}, identity) );
+    }
+
+    SECTION( "integer keys with a small range" )
+    {
+        auto small = [](int value) { return value % 100; };
+        CHECK( parallel_inv(collection, std::less<>{}, small)
+               == reference_inv(collection, std::less<>{}, small) );
+        CHECK( parallel_inv(collection, std::greater<>{}, small)
+               == reference_inv(collection, std::greater<>{}, small) );
+
+        // Too many different values for every thread to get a histogram
+        auto medium = [](int value) { return value % 15'000; };
+        CHECK( parallel_inv(collection, std::less<>{}, medium)
+               == reference_inv(collection, std::less<>{}, medium) );
+    }
+
+    SECTION( "floating point keys" )
+    {
+        auto halve = [](int value) { return value / 2.0; };
+        CHECK( parallel_inv(collection, std::less<>{}, halve)
+               == reference_inv(collection, std::less<>{}, halve) );
+    }
+
+    SECTION( "other types" )
+    {
+        std::forward_list<std::string> strings;
+        for (int value: collection) {
+            strings.push_front(std::to_string(value));
+        }
+        CHECK( parallel_inv(std::vector<std::string>(strings.begin(), strings.end()),
+                            std::less<>{}, identity)
+               == reference_inv(strings, std::less<>{}, identity) );
+        CHECK( parallel_inv(collection, std::less<int>{}, identity)
+               == reference_inv(collection, std::less<int>{}, identity) );
+    }
+}
@@ -1,8 +1,9 @@
 /*
- * Copyright (c) 2016-2018 Morwenn
+ * Copyright (c) 2016-2020 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #include <forward_list>
+#include <functional>
 #include <iterator>
 #include <vector>
 #include <catch2/catch.hpp>
@@ -25,6 +26,10 @@ TEST_CASE( "presortedness measure: rem", "[probe][rem]" )
 
         std::vector<internal_compare<int>> tricky(li.begin(), li.end());
         CHECK( cppsort::probe::rem(tricky, &internal_compare<int>::compare_to) == 4 );
+
+        // Projections are applied to the elements
+        CHECK( cppsort::probe::rem(li, std::negate<>{}) == 6 );
+        CHECK( cppsort::probe::rem(vec, std::greater<>{}, std::negate<>{}) == 4 );
     }
 
     SECTION( "lower bound" )
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/probes/inv.h>
+#include <cpp-sort/probes/rem.h>
+#include <cpp-sort/probes/runs.h>
+#include <cpp-sort/probes/sampled_inv.h>
+#include <cpp-sort/probes/sampled_rem.h>
+#include <cpp-sort/probes/sampled_runs.h>
+
+namespace
+{
+    template<typename Estimate, typename T>
+    auto contains(const Estimate& estimate, T exact)
+        -> bool
+    {
+        return estimate.lower <= estimate.value
+            && estimate.value <= estimate.upper
+            && estimate.lower <= exact
+            && exact <= estimate.upper;
+    }
+}
+
+TEST_CASE( "sampled measures of presortedness", "[probe][sampled]" )
+{
+    SECTION( "small collections are measured exactly" )
+    {
+        const std::vector<int> vec = { 48, 43, 96, 44, 42, 34, 42, 57, 68, 69 };
+
+        auto inv = cppsort::probe::sampled_inv(vec);
+        CHECK( inv.value == 19 );
+        CHECK( inv.lower == 19 );
+        CHECK( inv.upper == 19 );
+
+        auto runs = cppsort::probe::sampled_runs(vec);
+        CHECK( runs.value == cppsort::probe::runs(vec) );
+        CHECK( runs.lower == runs.upper );
+
+        auto rem = cppsort::probe::sampled_rem(vec.begin(), vec.end(), std::greater<>{});
+        CHECK( rem.value == cppsort::probe::rem(vec, std::greater<>{}) );
+        CHECK( rem.lower == rem.upper );
+    }
+
+    // The samples only depend on the size of the collection, and the
+    // values below are fully specified by the standard, which makes
+    // the following checks deterministic
+
+    std::mt19937 engine(123456);
+    std::vector<int> collection;
+    for (int i = 0 ; i < 50'000 ; ++i) {
+        collection.push_back(static_cast<int>(engine() % 1000));
+    }
+
+    SECTION( "sorted collections" )
+    {
+        std::sort(collection.begin(), collection.end());
+        CHECK( cppsort::probe::sampled_inv(collection).value == 0 );
+        CHECK( cppsort::probe::sampled_runs(collection).value == 0 );
+        CHECK( cppsort::probe::sampled_rem(collection).value == 0 );
+
+        // Every sampled pair is inverted in descending order
+        auto inv = cppsort::probe::sampled_inv(collection, std::greater<>{});
+        CHECK( contains(inv, cppsort::probe::inv(collection, std::greater<>{})) );
+    }
+
+    SECTION( "mostly sorted collections" )
+    {
+        std::sort(collection.begin(), collection.begin() + 40'000);
+        CHECK( contains(cppsort::probe::sampled_inv(collection),
+                        cppsort::probe::inv(collection)) );
+        CHECK( contains(cppsort::probe::sampled_runs(collection),
+                        cppsort::probe::runs(collection)) );
+        CHECK( contains(cppsort::probe::sampled_rem(collection),
+                        cppsort::probe::rem(collection)) );
+    }
+
+    SECTION( "random collections with projections" )
+    {
+        auto negate = std::negate<>{};
+        CHECK( contains(cppsort::probe::sampled_inv(collection, negate),
+                        cppsort::probe::inv(collection, negate)) );
+        CHECK( contains(cppsort::probe::sampled_runs(collection, negate),
+                        cppsort::probe::runs(collection, negate)) );
+        CHECK( contains(cppsort::probe::sampled_rem(collection, negate),
+                        cppsort::probe::rem(collection, negate)) );
+    }
+
+    SECTION( "custom sample size" )
+    {
+        cppsort::probe::sampled_inv_estimator<100'000> inv;
+        // The collection is smaller than the sample
+        auto res = inv(collection);
+        CHECK( res.value == cppsort::probe::inv(collection) );
+        CHECK( res.lower == res.upper );
+
+        cppsort::probe::sampled_runs_estimator<16> runs;
+        CHECK( contains(runs(collection), cppsort::probe::runs(collection)) );
+    }
+}
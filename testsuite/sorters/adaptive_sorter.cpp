@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/adaptive_sorter.h>
+#include <testing-tools/algorithm.h>
+
+TEST_CASE( "adaptive_sorter decisions", "[adaptive_sorter]" )
+{
+    // The measures are sampled, the distributions are chosen so that
+    // the decisions do not depend on the samples
+    std::mt19937 engine(123456);
+    std::vector<int> collection(10'000);
+    std::iota(std::begin(collection), std::end(collection), -5'000);
+
+    SECTION( "small collection" )
+    {
+        std::vector<int> small(std::begin(collection), std::begin(collection) + 100);
+        std::shuffle(std::begin(small), std::end(small), engine);
+        auto decision = cppsort::adaptive_sort(small);
+        CHECK( decision.sorter == cppsort::adaptive_sorter_choice::pdq_sorter );
+        CHECK( not decision.probed );
+        CHECK( std::is_sorted(std::begin(small), std::end(small)) );
+    }
+
+    SECTION( "few elements out of place" )
+    {
+        for (int i = 0 ; i < 100 ; ++i) {
+            collection[engine() % collection.size()] = static_cast<int>(engine() % 20'000) - 10'000;
+        }
+        auto decision = cppsort::adaptive_sort(collection);
+        CHECK( decision.sorter == cppsort::adaptive_sorter_choice::drop_merge_sorter );
+        CHECK( decision.probed );
+        CHECK( decision.rem <= 0.2 );
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "descending collection" )
+    {
+        std::reverse(std::begin(collection), std::end(collection));
+        auto decision = cppsort::adaptive_sort(collection);
+        CHECK( decision.sorter == cppsort::adaptive_sorter_choice::verge_sorter );
+        CHECK( decision.reversed_rem <= 0.2 );
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "shuffled integers" )
+    {
+        std::shuffle(std::begin(collection), std::end(collection), engine);
+        auto decision = cppsort::adaptive_sort(collection);
+        CHECK( decision.sorter == cppsort::adaptive_sorter_choice::ska_sorter );
+        CHECK( decision.radix_sortable );
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+
+        // No radix sort for other comparisons
+        std::shuffle(std::begin(collection), std::end(collection), engine);
+        decision = cppsort::adaptive_sort(collection, std::greater<>{});
+        CHECK( decision.sorter == cppsort::adaptive_sorter_choice::pdq_sorter );
+        CHECK( not decision.radix_sortable );
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection), std::greater<>{}) );
+    }
+
+    SECTION( "few long runs" )
+    {
+        // Eight interleaved ascending runs
+        std::vector<int> runs;
+        for (int run = 0 ; run < 8 ; ++run) {
+            for (int i = 0 ; i < 1'250 ; ++i) {
+                runs.push_back(i * 8 + run);
+            }
+        }
+        auto decision = cppsort::adaptive_sort(runs);
+        CHECK( decision.sorter == cppsort::adaptive_sorter_choice::verge_sorter );
+        CHECK( decision.radix_sortable );
+        CHECK( decision.step_downs <= 0.01 );
+        CHECK( std::is_sorted(std::begin(runs), std::end(runs)) );
+    }
+
+    SECTION( "strings" )
+    {
+        std::vector<std::string> strings;
+        for (int value: collection) {
+            strings.push_back(std::to_string(value));
+        }
+        std::shuffle(std::begin(strings), std::end(strings), engine);
+        auto decision = cppsort::adaptive_sort(strings);
+        CHECK( decision.sorter == cppsort::adaptive_sorter_choice::ska_sorter );
+        CHECK( std::is_sorted(std::begin(strings), std::end(strings)) );
+    }
+}
+
+TEST_CASE( "adaptive_sorter with custom thresholds", "[adaptive_sorter]" )
+{
+    std::mt19937 engine(123456);
+    std::vector<int> collection(5'000);
+    std::iota(std::begin(collection), std::end(collection), 0);
+    std::shuffle(std::begin(collection), std::end(collection), engine);
+
+    SECTION( "no radix sort" )
+    {
+        cppsort::adaptive_sorter_thresholds thresholds;
+        thresholds.min_radix_size = 1'000'000;
+        cppsort::adaptive_sorter sorter(thresholds);
+
+        auto decision = sorter.decide(collection);
+        CHECK( decision.sorter == cppsort::adaptive_sorter_choice::pdq_sorter );
+        CHECK( decision.radix_sortable );
+
+        decision = sorter(collection);
+        CHECK( decision.sorter == cppsort::adaptive_sorter_choice::pdq_sorter );
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "no measures" )
+    {
+        cppsort::adaptive_sorter_thresholds thresholds;
+        thresholds.min_probe_size = 1'000'000;
+        cppsort::adaptive_sorter sorter(thresholds);
+
+        auto decision = sorter(std::begin(collection), std::end(collection));
+        CHECK( decision.sorter == cppsort::adaptive_sorter_choice::pdq_sorter );
+        CHECK( not decision.probed );
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "projection" )
+    {
+        struct wrapper { int value; };
+        std::vector<wrapper> wrappers;
+        for (int value: collection) {
+            wrappers.push_back({ value });
+        }
+        std::sort(std::begin(wrappers), std::end(wrappers), [](auto lhs, auto rhs) {
+            return lhs.value > rhs.value;
+        });
+
+        auto decision = cppsort::adaptive_sort(wrappers, &wrapper::value);
+        CHECK( decision.sorter == cppsort::adaptive_sorter_choice::verge_sorter );
+        CHECK( helpers::is_sorted(std::begin(wrappers), std::end(wrappers),
+                                  std::less<>{}, &wrapper::value) );
+        CHECK( std::string(cppsort::to_string(decision.sorter)) == "verge_sorter" );
+    }
+}
@@ -4,8 +4,12 @@
  */
 #include <algorithm>
 #include <forward_list>
+#include <cstdint>
+#include <functional>
 #include <iterator>
+#include <limits>
 #include <list>
+#include <random>
 #include <vector>
 #include <catch2/catch.hpp>
 #include <cpp-sort/sorters/counting_sorter.h>
@@ -60,6 +64,35 @@ TEST_CASE( "counting_sorter tests", "[counting_sorter]" )
     }
 #endif
 
+    SECTION( "sort with outliers" )
+    {
+        // The values are too far apart to be counted in an array
+        std::vector<int> vec; vec.reserve(size + 2);
+        distribution(std::back_inserter(vec), size, -1568);
+        vec.push_back(std::numeric_limits<int>::min());
+        vec.push_back(std::numeric_limits<int>::max());
+        std::shuffle(std::begin(vec), std::end(vec), std::mt19937(Catch::rngSeed()));
+
+        auto copy = vec;
+        auto expected = vec;
+        std::sort(std::begin(expected), std::end(expected));
+        cppsort::counting_sort(vec);
+        CHECK( vec == expected );
+        cppsort::counting_sort(copy, std::greater<>{});
+        CHECK( std::equal(std::begin(copy), std::end(copy), expected.rbegin(), expected.rend()) );
+    }
+
+    SECTION( "sort with sparse values and duplicates" )
+    {
+        std::mt19937_64 engine(Catch::rngSeed());
+        std::forward_list<std::uint64_t> li;
+        for (int i = 0 ; i < size ; ++i) {
+            li.push_front(engine() % 500 * 0x0123456789ULL);
+        }
+        cppsort::counting_sort(li);
+        CHECK( std::is_sorted(std::begin(li), std::end(li)) );
+    }
+
     SECTION( "GitHub issue #103" )
     {
         // Specific bug in counting_sort due to another specific bug in
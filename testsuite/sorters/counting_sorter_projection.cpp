@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/sorters/counting_sorter.h>
+#include <testing-tools/algorithm.h>
+
+namespace
+{
+    enum class bucket: unsigned char
+    {
+        low, medium, high, critical
+    };
+
+    struct record
+    {
+        bucket priority;
+        int id;
+        std::string name;
+    };
+}
+
+TEST_CASE( "counting_sorter tests with projections",
+           "[counting_sorter][projection]" )
+{
+    // Pseudo-random number engine
+    std::mt19937_64 engine(Catch::rngSeed());
+
+    SECTION( "stable sort with an enum key" )
+    {
+        std::vector<record> vec;
+        for (int i = 0 ; i < 10'000 ; ++i) {
+            vec.push_back({ static_cast<bucket>(engine() % 4), i, std::to_string(i) });
+        }
+        auto expected = vec;
+        std::stable_sort(std::begin(expected), std::end(expected), [](const record& lhs, const record& rhs) {
+            return lhs.priority < rhs.priority;
+        });
+
+        cppsort::counting_sort(vec, &record::priority);
+        CHECK( std::equal(std::begin(vec), std::end(vec), std::begin(expected), std::end(expected),
+                          [](const record& lhs, const record& rhs) {
+                              return lhs.id == rhs.id && lhs.name == rhs.name;
+                          }) );
+    }
+
+    SECTION( "stable reverse sort with int iterators" )
+    {
+        std::list<std::pair<int, int>> li;
+        for (int i = 0 ; i < 10'000 ; ++i) {
+            li.emplace_back(static_cast<int>(engine() % 100) - 50, i);
+        }
+        cppsort::counting_sort(std::begin(li), std::end(li), std::greater<>{},
+                               &std::pair<int, int>::first);
+        CHECK( std::is_sorted(std::begin(li), std::end(li), [](const auto& lhs, const auto& rhs) {
+            return lhs.first > rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+        }) );
+    }
+
+    SECTION( "sort with sparse keys" )
+    {
+        // The keys are too far apart to be counted in an array
+        std::vector<std::pair<long long, int>> vec;
+        for (int i = 0 ; i < 10'000 ; ++i) {
+            vec.emplace_back(static_cast<long long>(engine() % 100) * 1'000'000'007LL, i);
+        }
+        cppsort::counting_sort(vec, &std::pair<long long, int>::first);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with a computed key" )
+    {
+        std::vector<int> vec(10'000);
+        std::iota(std::begin(vec), std::end(vec), 0);
+        std::shuffle(std::begin(vec), std::end(vec), engine);
+        cppsort::counting_sort(vec, std::negate<>{});
+        CHECK( helpers::is_sorted(std::begin(vec), std::end(vec),
+                                  std::greater<>{}) );
+    }
+}
+
+TEST_CASE( "counting_sorter stability with projections",
+           "[counting_sorter][projection][is_stable]" )
+{
+    using cppsort::is_stable;
+    using cppsort::utility::identity;
+    using sorter = cppsort::counting_sorter;
+    using iterator = std::vector<record>::iterator;
+    using priority_t = bucket record::*;
+
+    CHECK(( is_stable<sorter(std::vector<record>&, priority_t)>::value ));
+    CHECK(( is_stable<sorter(std::vector<record>&, std::greater<>, priority_t)>::value ));
+    CHECK(( is_stable<sorter(iterator, iterator, priority_t)>::value ));
+    CHECK(( is_stable<sorter(iterator, iterator, std::greater<>, priority_t)>::value ));
+
+    // Plain integers are rewritten from their counts
+    CHECK_FALSE(( is_stable<sorter(std::vector<int>&)>::value ));
+    CHECK_FALSE(( is_stable<sorter(std::vector<int>&, std::greater<>)>::value ));
+    CHECK_FALSE(( is_stable<sorter(std::vector<int>&, identity)>::value ));
+    CHECK_FALSE(( is_stable<sorter(std::vector<int>::iterator, std::vector<int>::iterator)>::value ));
+    CHECK_FALSE(( is_stable<sorter(std::vector<int>::iterator, std::vector<int>::iterator,
+                                   std::greater<>)>::value ));
+    CHECK_FALSE(( is_stable<sorter(std::vector<int>::iterator, std::vector<int>::iterator,
+                                   std::greater<>, identity)>::value ));
+}
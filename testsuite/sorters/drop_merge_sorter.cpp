@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/drop_merge_sorter.h>
+
+TEST_CASE( "drop_merge_sorter with outliers", "[drop_merge_sorter]" )
+{
+    std::mt19937 engine(Catch::rngSeed());
+
+    // Sorted collection where a few elements are replaced by random
+    // ones, there are duplicates to exercise the galloping merge
+    auto make_collection = [&engine](int size, int num_outliers) {
+        std::vector<int> res;
+        for (int i = 0 ; i < size ; ++i) {
+            res.push_back(i / 3);
+        }
+        std::uniform_int_distribution<int> pos_dist(0, size - 1);
+        std::uniform_int_distribution<int> value_dist(-10, size / 3 + 10);
+        for (int i = 0 ; i < num_outliers ; ++i) {
+            res[pos_dist(engine)] = value_dist(engine);
+        }
+        return res;
+    };
+
+    SECTION( "random-access iterators" )
+    {
+        for (int num_outliers: { 1, 10, 500, 5'000 }) {
+            auto vec = make_collection(20'000, num_outliers);
+            auto expected = vec;
+            std::sort(std::begin(expected), std::end(expected));
+            cppsort::drop_merge_sort(vec);
+            CHECK( vec == expected );
+        }
+    }
+
+    SECTION( "bidirectional iterators" )
+    {
+        for (int num_outliers: { 1, 10, 500, 5'000 }) {
+            auto vec = make_collection(20'000, num_outliers);
+            std::list<int> li(std::begin(vec), std::end(vec));
+            std::sort(std::begin(vec), std::end(vec));
+            cppsort::drop_merge_sort(li, std::greater<>{}, std::negate<>{});
+            CHECK( std::equal(std::begin(li), std::end(li), std::begin(vec), std::end(vec)) );
+        }
+    }
+
+    SECTION( "outliers at both ends" )
+    {
+        auto vec = make_collection(10'000, 0);
+        vec.front() = 5'000;
+        vec.back() = -5;
+        auto expected = vec;
+        std::sort(std::begin(expected), std::end(expected));
+        cppsort::drop_merge_sort(vec);
+        CHECK( vec == expected );
+    }
+
+    SECTION( "move-only types" )
+    {
+        auto vec = make_collection(10'000, 200);
+        std::vector<std::unique_ptr<int>> ptrs;
+        for (int value: vec) {
+            ptrs.push_back(std::make_unique<int>(value));
+        }
+        std::sort(std::begin(vec), std::end(vec));
+        cppsort::drop_merge_sort(ptrs, [](const auto& ptr) { return *ptr; });
+        CHECK( std::equal(std::begin(ptrs), std::end(ptrs), std::begin(vec), std::end(vec),
+                          [](const auto& ptr, int value) { return ptr && *ptr == value; }) );
+    }
+}
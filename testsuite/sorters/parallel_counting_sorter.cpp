@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/sorters/parallel_counting_sorter.h>
+#include <testing-tools/parallel.h>
+
+TEST_CASE_METHOD( helpers::parallel_fixture, "parallel_counting_sorter tests",
+                  "[parallel_counting_sorter]" )
+{
+    cppsort::parallel_counting_sorter<1024> sorter(pool);
+
+    SECTION( "sort with int iterable" )
+    {
+        CHECK( sorts_like_std_sort(sorter, shuffled_iota(300'000, -150'000)) );
+    }
+
+    SECTION( "reverse sort with few distinct values" )
+    {
+        std::vector<unsigned> vec;
+        for (int i = 0 ; i < 300'000 ; ++i) {
+            vec.push_back(static_cast<unsigned>(engine() % 100));
+        }
+        auto expected = vec;
+        std::sort(std::begin(expected), std::end(expected), std::greater<>{});
+        sorter(vec, std::greater<>{});
+        CHECK( vec == expected );
+    }
+
+    SECTION( "sort with a range too big for a count array per chunk" )
+    {
+        // Fewer chunks count the values than there are threads
+        std::vector<int> vec;
+        for (int i = 0 ; i < 300'000 ; ++i) {
+            vec.push_back(static_cast<int>(engine() % 500'000));
+        }
+        auto expected = vec;
+        std::sort(std::begin(expected), std::end(expected));
+        sorter(vec);
+        CHECK( vec == expected );
+    }
+
+    SECTION( "sort with sparse values" )
+    {
+        std::vector<std::int64_t> vec;
+        for (int i = 0 ; i < 300'000 ; ++i) {
+            vec.push_back(static_cast<std::int64_t>(engine() % 1000) * 1'000'000'007);
+        }
+        vec.push_back(std::numeric_limits<std::int64_t>::min());
+        vec.push_back(std::numeric_limits<std::int64_t>::max());
+        std::shuffle(std::begin(vec), std::end(vec), engine);
+
+        auto copy = vec;
+        auto expected = vec;
+        std::sort(std::begin(expected), std::end(expected));
+        sorter(vec);
+        CHECK( vec == expected );
+        sorter(copy, std::greater<>{});
+        CHECK( std::equal(std::begin(copy), std::end(copy), expected.rbegin(), expected.rend()) );
+    }
+
+    SECTION( "sort with sorted chunks" )
+    {
+        std::vector<int> vec(300'000);
+        std::iota(std::begin(vec), std::end(vec), 0);
+        sorter(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+
+        std::reverse(std::begin(vec), std::end(vec));
+        sorter(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "risky paths" )
+    {
+        check_risky_paths(sorter, 1024);
+        check_risky_paths(sorter, 1024, std::greater<>{});
+    }
+}
+
+TEST_CASE_METHOD( helpers::parallel_fixture, "parallel_counting_sorter tests with projections",
+                  "[parallel_counting_sorter][projection]" )
+{
+    cppsort::parallel_counting_sorter<1024> sorter(pool);
+
+    SECTION( "stable sort with small keys" )
+    {
+        std::vector<std::pair<unsigned char, int>> vec;
+        for (int i = 0 ; i < 300'000 ; ++i) {
+            vec.emplace_back(static_cast<unsigned char>(engine() % 16), i);
+        }
+        auto expected = vec;
+        std::stable_sort(std::begin(expected), std::end(expected), [](const auto& lhs, const auto& rhs) {
+            return lhs.first < rhs.first;
+        });
+        auto copy = vec;
+
+        sorter(vec, &std::pair<unsigned char, int>::first);
+        CHECK( vec == expected );
+
+        std::stable_sort(std::begin(expected), std::end(expected), [](const auto& lhs, const auto& rhs) {
+            return lhs.first > rhs.first;
+        });
+        sorter(copy, std::greater<>{}, &std::pair<unsigned char, int>::first);
+        CHECK( copy == expected );
+
+        using iterator = std::vector<std::pair<unsigned char, int>>::iterator;
+        using key_t = unsigned char std::pair<unsigned char, int>::*;
+        CHECK(( cppsort::is_stable<decltype(sorter)(iterator, iterator, key_t)>::value ));
+        CHECK(( cppsort::is_stable<decltype(sorter)(iterator, iterator, std::greater<>, key_t)>::value ));
+        CHECK_FALSE(( cppsort::is_stable<decltype(sorter)(iterator, iterator)>::value ));
+    }
+
+    SECTION( "sort with sparse keys" )
+    {
+        std::vector<std::pair<int, int>> vec;
+        for (int i = 0 ; i < 300'000 ; ++i) {
+            vec.emplace_back(static_cast<int>(engine() % 100) * 10'000'019, i);
+        }
+        auto expected = vec;
+        std::stable_sort(std::begin(expected), std::end(expected), [](const auto& lhs, const auto& rhs) {
+            return lhs.first < rhs.first;
+        });
+        sorter(vec, &std::pair<int, int>::first);
+        CHECK( vec == expected );
+    }
+}
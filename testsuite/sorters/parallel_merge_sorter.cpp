@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/parallel_merge_sorter.h>
+#include <testing-tools/algorithm.h>
+#include <testing-tools/distributions.h>
+#include <testing-tools/parallel.h>
+
+namespace
+{
+    struct wrapper
+    {
+        int value;
+        int order;
+    };
+}
+
+TEST_CASE_METHOD( helpers::parallel_fixture, "parallel_merge_sorter tests",
+                  "[parallel_merge_sorter]" )
+{
+    std::vector<int> vec;
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(vec), 100'000, 0);
+
+    SECTION( "sort with iterable" )
+    {
+        cppsort::parallel_merge_sort(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with iterators and compare" )
+    {
+        cppsort::parallel_merge_sorter<> sorter(pool);
+        sorter(std::begin(vec), std::end(vec), std::greater<>{});
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec), std::greater<>{}) );
+    }
+
+    SECTION( "small sequential threshold" )
+    {
+        cppsort::parallel_merge_sorter<100> sorter(pool);
+        CHECK( sorts_like_std_sort(sorter, vec) );
+    }
+
+    SECTION( "sort a deque of strings" )
+    {
+        std::deque<std::string> collection;
+        for (int value: vec) {
+            collection.push_back(std::to_string(value));
+        }
+
+        cppsort::parallel_merge_sorter<100> sorter(pool);
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "stability" )
+    {
+        std::vector<wrapper> collection(50'000);
+        std::size_t count = 0;
+        for (wrapper& wrap: collection) {
+            wrap.value = count++ % 17;
+        }
+        std::shuffle(std::begin(collection), std::end(collection), engine);
+        helpers::iota(std::begin(collection), std::end(collection), 0, &wrapper::order);
+
+        cppsort::parallel_merge_sorter<100> sorter(pool);
+        sorter(collection, &wrapper::value);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection),
+                              [](const wrapper& lhs, const wrapper& rhs) {
+                                  if (lhs.value != rhs.value) {
+                                      return lhs.value < rhs.value;
+                                  }
+                                  return lhs.order < rhs.order;
+                              }) );
+    }
+
+    SECTION( "risky paths" )
+    {
+        cppsort::parallel_merge_sorter<> sorter(pool);
+        check_risky_paths(sorter, 16384);
+        check_risky_paths(sorter, 16384, std::greater<>{});
+
+        cppsort::parallel_merge_sorter<100> small_sorter(pool);
+        check_risky_paths(small_sorter, 100);
+        check_risky_paths(small_sorter, 100, std::greater<>{});
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/parallel_pdq_sorter.h>
+#include <testing-tools/distributions.h>
+#include <testing-tools/parallel.h>
+
+TEST_CASE_METHOD( helpers::parallel_fixture, "parallel_pdq_sorter tests",
+                  "[parallel_pdq_sorter]" )
+{
+    auto vec = shuffled_iota(300'000);
+
+    SECTION( "sort with iterable" )
+    {
+        cppsort::parallel_pdq_sort(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with iterators and compare" )
+    {
+        cppsort::parallel_pdq_sorter<> sorter(pool);
+        sorter(std::begin(vec), std::end(vec), std::greater<>{});
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec), std::greater<>{}) );
+    }
+
+    SECTION( "sort with projection" )
+    {
+        cppsort::parallel_pdq_sorter<> sorter(pool);
+        sorter(vec, std::negate<>{});
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec), std::greater<>{}) );
+    }
+
+    SECTION( "small sequential threshold" )
+    {
+        cppsort::parallel_pdq_sorter<256> sorter(pool);
+        CHECK( sorts_like_std_sort(sorter, vec) );
+    }
+
+    SECTION( "many equal elements" )
+    {
+        std::vector<int> collection;
+        auto distribution = dist::shuffled_16_values{};
+        distribution(std::back_inserter(collection), 300'000);
+
+        cppsort::parallel_pdq_sorter<256> sorter(pool);
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "patterns" )
+    {
+        std::vector<int> collection;
+        auto distribution = dist::descending_sawtooth{};
+        distribution(std::back_inserter(collection), 300'000);
+
+        cppsort::parallel_pdq_sorter<256> sorter(pool);
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "non-branchless comparison" )
+    {
+        std::vector<std::string> collection;
+        for (int i = 0 ; i < 50'000 ; ++i) {
+            collection.push_back(std::to_string(engine()));
+        }
+
+        cppsort::parallel_pdq_sorter<256> sorter(pool);
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "risky paths" )
+    {
+        cppsort::parallel_pdq_sorter<256> sorter(pool);
+        check_risky_paths(sorter, 256);
+        check_risky_paths(sorter, 256, std::greater<>{});
+    }
+}
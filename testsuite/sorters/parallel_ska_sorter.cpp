@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/parallel_ska_sorter.h>
+#include <testing-tools/parallel.h>
+
+TEST_CASE_METHOD( helpers::parallel_fixture, "parallel_ska_sorter tests",
+                  "[parallel_ska_sorter]" )
+{
+    cppsort::parallel_ska_sorter<1024> sorter(pool);
+
+    SECTION( "sort with int iterable" )
+    {
+        CHECK( sorts_like_std_sort(sorter, shuffled_iota(300'000, -150'000)) );
+    }
+
+    SECTION( "sort with 64-bit integers of varying magnitudes" )
+    {
+        std::vector<std::int64_t> vec;
+        for (int i = 0 ; i < 300'000 ; ++i) {
+            // Most elements share their most significant bytes
+            vec.push_back(static_cast<std::int64_t>(engine() >> (engine() % 64)));
+        }
+        auto expected = vec;
+        std::sort(std::begin(expected), std::end(expected));
+        cppsort::parallel_ska_sorter<> default_sorter(pool);
+        default_sorter(std::begin(vec), std::end(vec));
+        CHECK( vec == expected );
+    }
+
+    SECTION( "sort with double iterable" )
+    {
+        std::vector<double> vec(300'000);
+        std::iota(std::begin(vec), std::end(vec), -1000.0);
+        std::shuffle(std::begin(vec), std::end(vec), engine);
+        sorter(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with pairs" )
+    {
+        std::vector<std::pair<int, unsigned>> vec;
+        for (int i = 0 ; i < 300'000 ; ++i) {
+            vec.emplace_back(static_cast<int>(engine() % 100), static_cast<unsigned>(engine()));
+        }
+        sorter(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with std::string" )
+    {
+        std::vector<std::string> vec;
+        for (int i = 0 ; i < 100'000 ; ++i) {
+            vec.push_back(std::to_string(i));
+        }
+        std::shuffle(std::begin(vec), std::end(vec), engine);
+        sorter(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with projection" )
+    {
+        std::vector<std::pair<std::string, int>> vec;
+        for (int i = 0 ; i < 100'000 ; ++i) {
+            vec.emplace_back(std::to_string(i), i);
+        }
+        std::shuffle(std::begin(vec), std::end(vec), engine);
+        sorter(vec, &std::pair<std::string, int>::second);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec), [](const auto& lhs, const auto& rhs) {
+            return lhs.second < rhs.second;
+        }) );
+    }
+
+    SECTION( "risky paths" )
+    {
+        check_risky_paths(sorter, 1024);
+    }
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/parallel_spread_sorter.h>
+#include <testing-tools/parallel.h>
+
+TEST_CASE_METHOD( helpers::parallel_fixture, "parallel_spread_sorter tests",
+                  "[parallel_spread_sorter]" )
+{
+    cppsort::parallel_spread_sorter<1024> sorter(pool);
+
+    SECTION( "sort with int iterable" )
+    {
+        CHECK( sorts_like_std_sort(sorter, shuffled_iota(300'000, -150'000)) );
+    }
+
+    SECTION( "sort with 64-bit integers of varying magnitudes" )
+    {
+        std::vector<std::int64_t> vec;
+        for (int i = 0 ; i < 300'000 ; ++i) {
+            // Most elements end up in the same few bins
+            vec.push_back(static_cast<std::int64_t>(engine() >> (engine() % 64)));
+        }
+        auto expected = vec;
+        std::sort(std::begin(expected), std::end(expected));
+        cppsort::parallel_spread_sorter<> default_sorter(pool);
+        default_sorter(std::begin(vec), std::end(vec));
+        CHECK( vec == expected );
+    }
+
+    SECTION( "sort with few distinct values" )
+    {
+        std::vector<unsigned> vec;
+        for (int i = 0 ; i < 300'000 ; ++i) {
+            vec.push_back(static_cast<unsigned>(engine() % 3));
+        }
+        sorter(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with double iterable" )
+    {
+        std::vector<double> vec;
+        for (int i = 0 ; i < 300'000 ; ++i) {
+            vec.push_back(std::ldexp(static_cast<double>(engine() % 2001) - 1000.0,
+                                     static_cast<int>(engine() % 41) - 20));
+        }
+        sorter(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with std::string" )
+    {
+        std::vector<std::string> vec;
+        for (int i = 0 ; i < 100'000 ; ++i) {
+            // Share a prefix and vary the lengths
+            vec.push_back("prefix-" + std::to_string(i % 20'000) + std::string(engine() % 3, 'x'));
+        }
+        std::shuffle(std::begin(vec), std::end(vec), engine);
+        auto copy = vec;
+
+        sorter(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+
+        sorter(copy, std::greater<>{});
+        CHECK( std::is_sorted(std::begin(copy), std::end(copy), std::greater<>{}) );
+    }
+
+    SECTION( "sort strings with a long common prefix" )
+    {
+        // The shared prefix is skipped at once instead of being
+        // distributed one character at a time
+        const std::string prefix(1'000, 'a');
+        std::vector<std::string> vec;
+        for (int i = 0 ; i < 20'000 ; ++i) {
+            auto suffix = std::to_string(engine() % 5'000);
+            switch (i % 4) {
+                case 0:  vec.push_back(prefix + suffix); break;
+                case 1:  vec.push_back(prefix + prefix.substr(0, i % 7) + suffix); break;
+                case 2:  vec.push_back(prefix.substr(0, i % 11)); break;
+                default: vec.push_back(prefix.substr(0, 500) + "b" + suffix); break;
+            }
+        }
+        std::shuffle(std::begin(vec), std::end(vec), engine);
+        auto expected = vec;
+        std::sort(std::begin(expected), std::end(expected));
+        auto copy = vec;
+
+        sorter(vec);
+        CHECK( vec == expected );
+
+        std::reverse(std::begin(expected), std::end(expected));
+        sorter(copy, std::greater<>{});
+        CHECK( copy == expected );
+    }
+
+    SECTION( "sort with projection" )
+    {
+        std::vector<std::pair<std::string, int>> vec;
+        for (int i = 0 ; i < 100'000 ; ++i) {
+            vec.emplace_back(std::to_string(i), i);
+        }
+        std::shuffle(std::begin(vec), std::end(vec), engine);
+        auto copy = vec;
+
+        sorter(vec, &std::pair<std::string, int>::second);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec), [](const auto& lhs, const auto& rhs) {
+            return lhs.second < rhs.second;
+        }) );
+
+        sorter(copy, &std::pair<std::string, int>::first);
+        CHECK( std::is_sorted(std::begin(copy), std::end(copy), [](const auto& lhs, const auto& rhs) {
+            return lhs.first < rhs.first;
+        }) );
+    }
+
+    SECTION( "risky paths" )
+    {
+        check_risky_paths(sorter, 1024);
+    }
+}
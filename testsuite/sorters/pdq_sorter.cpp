@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/detail/simd_partition.h>
+#include <cpp-sort/sorters/pdq_sorter.h>
+#include <cpp-sort/utility/functional.h>
+
+namespace
+{
+    template<typename T, typename Engine>
+    auto check_partitions(Engine& engine)
+        -> void
+    {
+        // Partitioning arithmetic values in contiguous memory might
+        // use vector instructions depending on the instruction sets
+        // enabled, few distinct values trigger more equal keys
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+        using iterator = typename std::vector<T>::iterator;
+        CHECK(( cppsort::detail::can_use_simd_partition<iterator, std::less<>, cppsort::utility::identity>::value ));
+        CHECK(( cppsort::detail::can_use_simd_partition<T*, std::greater<T>, cppsort::utility::identity>::value ));
+#endif
+
+        for (long long modulo : { 2LL, 100LL, 1LL << 40 }) {
+            std::vector<T> collection;
+            for (int i = 0 ; i < 10'000 ; ++i) {
+                collection.push_back(static_cast<T>(static_cast<long long>(engine() % modulo) - modulo / 3));
+            }
+
+            auto expected = collection;
+            std::sort(std::begin(expected), std::end(expected));
+            auto expected_greater = expected;
+            std::reverse(std::begin(expected_greater), std::end(expected_greater));
+
+            auto copy = collection;
+            cppsort::pdq_sort(collection);
+            CHECK( collection == expected );
+
+            collection = copy;
+            cppsort::pdq_sort(collection, std::greater<>{});
+            CHECK( collection == expected_greater );
+
+            collection = copy;
+            cppsort::pdq_sort(collection.data(), collection.data() + collection.size(), std::less<T>{});
+            CHECK( collection == expected );
+
+            collection = copy;
+            cppsort::pdq_sort(collection.data(), collection.data() + collection.size(), std::greater<T>{});
+            CHECK( collection == expected_greater );
+        }
+    }
+}
+
+TEST_CASE( "pdq_sorter with arithmetic types", "[pdq_sorter]" )
+{
+    std::mt19937_64 engine(Catch::rngSeed());
+
+    SECTION( "32-bit integers" )
+    {
+        check_partitions<std::int32_t>(engine);
+        check_partitions<std::uint32_t>(engine);
+    }
+
+    SECTION( "64-bit integers" )
+    {
+        check_partitions<std::int64_t>(engine);
+        check_partitions<std::uint64_t>(engine);
+    }
+
+    SECTION( "floating point numbers" )
+    {
+        check_partitions<float>(engine);
+        check_partitions<double>(engine);
+    }
+}
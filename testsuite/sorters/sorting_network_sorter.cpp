@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <catch2/catch.hpp>
+#include <cpp-sort/fixed/sorting_network_sorter.h>
+
+namespace
+{
+    // Sizes 4, 8 and 16 might be handled by vector kernels depending
+    // on the instruction sets enabled, the other ones ensure that the
+    // scalar networks still work alongside them
+
+    template<typename T, std::size_t N, typename Engine>
+    auto check_sizes(Engine& engine)
+        -> void
+    {
+        std::array<T, N> collection;
+        std::iota(std::begin(collection), std::end(collection), T(-3));
+
+        for (int i = 0 ; i < 10 ; ++i) {
+            std::shuffle(std::begin(collection), std::end(collection), engine);
+            cppsort::sorting_network_sorter<N>{}(collection);
+            CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+
+            std::shuffle(std::begin(collection), std::end(collection), engine);
+            cppsort::sorting_network_sorter<N>{}(collection, std::greater<>{});
+            CHECK( std::is_sorted(std::begin(collection), std::end(collection), std::greater<>{}) );
+
+            std::shuffle(std::begin(collection), std::end(collection), engine);
+            cppsort::sorting_network_sorter<N>{}(collection, [](T value) { return -value; });
+            CHECK( std::is_sorted(std::begin(collection), std::end(collection), std::greater<>{}) );
+        }
+    }
+
+    template<typename T, typename Engine>
+    auto check_all_sizes(Engine& engine)
+        -> void
+    {
+        check_sizes<T, 3>(engine);
+        check_sizes<T, 4>(engine);
+        check_sizes<T, 5>(engine);
+        check_sizes<T, 8>(engine);
+        check_sizes<T, 9>(engine);
+        check_sizes<T, 16>(engine);
+        check_sizes<T, 17>(engine);
+    }
+}
+
+TEST_CASE( "sorting_network_sorter with arithmetic types",
+           "[sorting_network_sorter]" )
+{
+    std::mt19937 engine(Catch::rngSeed());
+
+    SECTION( "int" )
+    {
+        check_all_sizes<int>(engine);
+    }
+
+    SECTION( "long long" )
+    {
+        check_all_sizes<long long>(engine);
+    }
+
+    SECTION( "float" )
+    {
+        check_all_sizes<float>(engine);
+    }
+
+    SECTION( "double" )
+    {
+        check_all_sizes<double>(engine);
+    }
+
+    SECTION( "extreme values" )
+    {
+        std::array<int, 8> collection = {{
+            0, std::numeric_limits<int>::max(), -1, std::numeric_limits<int>::min(),
+            std::numeric_limits<int>::max(), 1, std::numeric_limits<int>::min(), 0
+        }};
+        cppsort::sorting_network_sorter<8>{}(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+
+        std::array<double, 4> collection2 = {{
+            std::numeric_limits<double>::infinity(), -0.5,
+            -std::numeric_limits<double>::infinity(), 0.5
+        }};
+        cppsort::sorting_network_sorter<4>{}(collection2, std::greater<>{});
+        CHECK( std::is_sorted(std::begin(collection2), std::end(collection2), std::greater<>{}) );
+    }
+}
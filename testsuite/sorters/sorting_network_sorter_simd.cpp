@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <catch2/catch.hpp>
+#include <cpp-sort/detail/simd_sorting_network.h>
+#include <cpp-sort/fixed/sorting_network_sorter.h>
+
+//
+// This file is compiled once per vector instruction set supported by
+// the compiler and the machine running the tests, which makes sure
+// that the vector kernels are actually exercised
+//
+
+namespace
+{
+    // Zero-one principle: a network sorts every input if and only if
+    // it sorts every sequence of two distinct values; low and high
+    // are picked to catch signed and unsigned comparisons mixups
+    template<typename T, std::size_t N>
+    auto check_zero_one(T low, T high)
+        -> void
+    {
+        REQUIRE(( cppsort::detail::has_simd_sorting_network<T, N>::value ));
+
+        std::size_t nb_failures = 0;
+        for (std::uint32_t mask = 0 ; mask < (std::uint32_t(1) << N) ; ++mask) {
+            std::array<T, N> collection;
+            for (std::size_t i = 0 ; i < N ; ++i) {
+                collection[i] = (mask >> i) & 1 ? high : low;
+            }
+            auto copy = collection;
+
+            auto expected = collection;
+            std::sort(std::begin(expected), std::end(expected));
+            cppsort::sorting_network_sorter<N>{}(collection);
+            nb_failures += collection != expected;
+
+            std::reverse(std::begin(expected), std::end(expected));
+            cppsort::sorting_network_sorter<N>{}(copy, std::greater<>{});
+            nb_failures += copy != expected;
+        }
+        CHECK( nb_failures == 0 );
+    }
+
+    template<typename T, std::size_t N, typename Engine>
+    auto check_random(Engine& engine)
+        -> void
+    {
+        REQUIRE(( cppsort::detail::has_simd_sorting_network<T, N>::value ));
+
+        // Values spread over the whole range of the type, extremes included
+        std::array<T, N> collection;
+        collection[0] = std::numeric_limits<T>::lowest();
+        collection[1] = std::numeric_limits<T>::max();
+        std::uniform_int_distribution<std::int64_t> dist(-1'000'000, 1'000'000);
+        for (int i = 0 ; i < 100 ; ++i) {
+            for (std::size_t j = 2 ; j < N ; ++j) {
+                collection[j] = static_cast<T>(dist(engine) * (std::numeric_limits<T>::max() / 1'000'000));
+            }
+            std::shuffle(std::begin(collection), std::end(collection), engine);
+
+            auto expected = collection;
+            std::sort(std::begin(expected), std::end(expected));
+            auto copy = collection;
+            cppsort::sorting_network_sorter<N>{}(copy);
+            CHECK( copy == expected );
+
+            std::reverse(std::begin(expected), std::end(expected));
+            cppsort::sorting_network_sorter<N>{}(collection, std::greater<>{});
+            CHECK( collection == expected );
+        }
+    }
+
+    template<typename T, std::size_t N, typename Engine>
+    auto check_kernel(Engine& engine)
+        -> void
+    {
+        if (std::is_unsigned<T>::value) {
+            // Would be sorted the other way around by signed comparisons
+            check_zero_one<T, N>(T(1), static_cast<T>(std::numeric_limits<T>::max() - 1));
+        } else {
+            check_zero_one<T, N>(static_cast<T>(-1), T(1));
+        }
+        check_random<T, N>(engine);
+    }
+}
+
+TEST_CASE( "sorting_network_sorter with vector kernels",
+           "[sorting_network_sorter][simd]" )
+{
+    std::mt19937_64 engine(Catch::rngSeed());
+
+#ifdef __SSE4_1__
+    SECTION( "4 values with SSE4.1" )
+    {
+        check_kernel<std::int32_t, 4>(engine);
+        check_kernel<std::uint32_t, 4>(engine);
+        check_kernel<float, 4>(engine);
+    }
+#endif
+
+#ifdef __AVX2__
+    SECTION( "8 values with AVX2" )
+    {
+        check_kernel<std::int32_t, 8>(engine);
+        check_kernel<std::uint32_t, 8>(engine);
+        check_kernel<float, 8>(engine);
+    }
+
+    SECTION( "4 doubles with AVX2" )
+    {
+        check_kernel<double, 4>(engine);
+    }
+#endif
+
+#ifdef __AVX512F__
+    SECTION( "16 values with AVX-512F" )
+    {
+        check_kernel<std::int32_t, 16>(engine);
+        check_kernel<std::uint32_t, 16>(engine);
+        check_kernel<float, 16>(engine);
+    }
+
+    SECTION( "8 64-bit values with AVX-512F" )
+    {
+        check_kernel<std::int64_t, 8>(engine);
+        check_kernel<std::uint64_t, 8>(engine);
+        check_kernel<double, 8>(engine);
+    }
+#endif
+}
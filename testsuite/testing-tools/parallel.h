@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_TESTSUITE_PARALLEL_H_
+#define CPPSORT_TESTSUITE_PARALLEL_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/utility/thread_pool.h>
+
+namespace helpers
+{
+    // Fixture for the tests of the parallel sorters: the dedicated
+    // pool has several workers even on machines with a single hardware
+    // thread, which makes sure that the parallel paths are taken when
+    // the collections are bigger than the sequential threshold
+    struct parallel_fixture
+    {
+        cppsort::utility::thread_pool pool{3};
+        std::mt19937_64 engine{Catch::rngSeed()};
+
+        auto shuffled_iota(std::size_t size, int first=0)
+            -> std::vector<int>
+        {
+            std::vector<int> collection(size);
+            std::iota(std::begin(collection), std::end(collection), first);
+            std::shuffle(std::begin(collection), std::end(collection), engine);
+            return collection;
+        }
+
+        // Sorts a copy of the collection and compares the result
+        // with that of std::sort
+        template<typename Sorter, typename T, typename Compare=std::less<>>
+        auto sorts_like_std_sort(const Sorter& sorter, std::vector<T> collection,
+                                 Compare compare={})
+            -> bool
+        {
+            auto expected = collection;
+            std::sort(std::begin(expected), std::end(expected), compare);
+            sorter(collection, compare);
+            return collection == expected;
+        }
+
+        // Sorts collections whose sizes are just above the thresholds
+        // at which the parallel algorithms split the work, or which
+        // can't be split evenly between the workers, with patterns for
+        // which the chunks end up unbalanced
+        template<typename Sorter, typename Compare=std::less<>>
+        auto check_risky_paths(const Sorter& sorter, std::ptrdiff_t threshold,
+                               Compare compare={})
+            -> void
+        {
+            // Most parallel algorithms don't split chunks smaller than that
+            constexpr std::ptrdiff_t min_chunk_size = 1 << 14;
+
+            const std::ptrdiff_t sizes[] = {
+                threshold + 1,
+                2 * threshold + 1,
+                3 * threshold + 2,
+                2 * min_chunk_size + 1,
+                3 * min_chunk_size + 2,
+                (1 << 17) + 1
+            };
+            for (auto size: sizes) {
+                INFO( "size: " << size );
+
+                auto distinct = shuffled_iota(static_cast<std::size_t>(size), static_cast<int>(-size / 2));
+                CHECK( sorts_like_std_sort(sorter, distinct, compare) );
+
+                std::vector<int> all_equal(static_cast<std::size_t>(size), 42);
+                CHECK( sorts_like_std_sort(sorter, all_equal, compare) );
+
+                // One value in a chunk, another one everywhere else
+                std::vector<int> one_outlier(static_cast<std::size_t>(size), 5);
+                one_outlier[static_cast<std::size_t>(size / 3)] = -5;
+                CHECK( sorts_like_std_sort(sorter, one_outlier, compare) );
+
+                std::vector<int> few_values;
+                for (std::ptrdiff_t i = 0 ; i < size ; ++i) {
+                    few_values.push_back(static_cast<int>(engine() % 4));
+                }
+                CHECK( sorts_like_std_sort(sorter, few_values, compare) );
+
+                std::vector<int> descending(distinct);
+                std::sort(std::begin(descending), std::end(descending), std::greater<>{});
+                CHECK( sorts_like_std_sort(sorter, descending, compare) );
+            }
+        }
+    };
+}
+
+#endif // CPPSORT_TESTSUITE_PARALLEL_H_
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <thread>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/adapters/indirect_adapter.h>
+#include <cpp-sort/adapters/schwartz_adapter.h>
+#include <cpp-sort/detail/thread_pool.h>
+#include <cpp-sort/probes/inv.h>
+#include <cpp-sort/sorters/drop_merge_sorter.h>
+#include <cpp-sort/sorters/merge_sorter.h>
+#include <cpp-sort/sorters/parallel_merge_sorter.h>
+#include <cpp-sort/sorters/pdq_sorter.h>
+#include <cpp-sort/sorters/spin_sorter.h>
+#include <cpp-sort/sorters/spread_sorter.h>
+#include <cpp-sort/sorters/tim_sorter.h>
+#include <cpp-sort/utility/memory_resource.h>
+#include <cpp-sort/utility/thread_pool.h>
+#include <testing-tools/distributions.h>
+
+namespace
+{
+    // Forwards everything to the global operator new & delete while
+    // keeping track of the number of allocations
+    struct counting_resource final:
+        cppsort::utility::memory_resource
+    {
+        std::size_t allocations = 0;
+        std::size_t live_allocations = 0;
+
+        auto do_allocate(std::size_t bytes, std::size_t alignment)
+            -> void* override
+        {
+            ++allocations;
+            ++live_allocations;
+            return cppsort::utility::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        auto do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment)
+            -> void override
+        {
+            --live_allocations;
+            cppsort::utility::new_delete_resource()->deallocate(pointer, bytes, alignment);
+        }
+    };
+
+    struct wrapper { int value; };
+}
+
+TEST_CASE( "sorters draw scratch memory from the installed resource",
+           "[utility][memory_resource]" )
+{
+    std::vector<int> collection;
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 10'000, -1'000);
+
+    counting_resource resource;
+    cppsort::utility::scoped_memory_resource _(&resource);
+    CHECK( cppsort::utility::get_memory_resource() == &resource );
+
+    SECTION( "merge_sorter" )
+    {
+        cppsort::merge_sort(collection);
+    }
+
+    SECTION( "tim_sorter" )
+    {
+        cppsort::tim_sort(collection);
+    }
+
+    SECTION( "spin_sorter" )
+    {
+        cppsort::spin_sort(collection);
+    }
+
+    SECTION( "drop_merge_sorter" )
+    {
+        cppsort::drop_merge_sort(collection);
+    }
+
+    SECTION( "spread_sorter" )
+    {
+        cppsort::spread_sort(collection);
+    }
+
+    SECTION( "indirect_adapter" )
+    {
+        cppsort::indirect_adapter<cppsort::pdq_sorter>{}(collection);
+    }
+
+    SECTION( "schwartz_adapter" )
+    {
+        std::vector<wrapper> wrappers;
+        for (int value: collection) {
+            wrappers.push_back({value});
+        }
+        cppsort::schwartz_adapter<cppsort::pdq_sorter>{}(wrappers, &wrapper::value);
+        std::transform(std::begin(wrappers), std::end(wrappers), std::begin(collection),
+                       [](wrapper w) { return w.value; });
+    }
+
+    CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    CHECK( resource.allocations > 0 );
+    CHECK( resource.live_allocations == 0 );
+}
+
+TEST_CASE( "probe::inv draws scratch memory from the installed resource",
+           "[utility][memory_resource][probe][inv]" )
+{
+    std::vector<int> collection;
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 10'000, -1'000);
+
+    counting_resource resource;
+    cppsort::utility::scoped_memory_resource _(&resource);
+
+    // Exercise both the merge-based and the Fenwick tree algorithms
+    CHECK( cppsort::probe::inv(collection) > 0 );
+    auto allocations = resource.allocations;
+    CHECK( allocations > 0 );
+    CHECK( cppsort::probe::inv(collection, [](int value) { return value % 100; }) > 0 );
+    CHECK( resource.allocations > allocations );
+    CHECK( resource.live_allocations == 0 );
+}
+
+TEST_CASE( "thread pool tasks use the resource of the spawning thread",
+           "[utility][memory_resource][thread_pool]" )
+{
+    counting_resource resource;
+    cppsort::utility::scoped_memory_resource _(&resource);
+
+    // Wait for the task to run on the worker thread before joining
+    // it, since the joining thread could run the task otherwise
+    cppsort::utility::thread_pool pool(1);
+    std::atomic<bool> done(false);
+    std::thread::id task_thread;
+    cppsort::utility::memory_resource* task_resource = nullptr;
+    {
+        cppsort::detail::task_group group(pool);
+        group.spawn([&] {
+            task_thread = std::this_thread::get_id();
+            task_resource = cppsort::utility::get_memory_resource();
+            done = true;
+        });
+        while (not done) {
+            std::this_thread::yield();
+        }
+        group.wait();
+    }
+    CHECK( task_thread != std::this_thread::get_id() );
+    CHECK( task_resource == &resource );
+}
+
+TEST_CASE( "scratch_pool used by a parallel sorter",
+           "[utility][memory_resource][scratch_pool]" )
+{
+    std::vector<int> original;
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(original), 300'000, -100'000);
+
+    // The tasks of the sort allocate from the pool concurrently
+    counting_resource upstream;
+    cppsort::utility::scratch_pool pool(&upstream);
+    cppsort::utility::scoped_memory_resource _(&pool);
+
+    cppsort::utility::thread_pool threads(3);
+    cppsort::parallel_merge_sorter<> sorter(threads);
+    for (int i = 0 ; i < 2 ; ++i) {
+        auto collection = original;
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    // Only the chunk should still be alive at this point
+    CHECK( upstream.live_allocations == 1 );
+    CHECK( pool.capacity() > 0 );
+}
+
+TEST_CASE( "scoped_memory_resource restores the previous resource",
+           "[utility][memory_resource]" )
+{
+    counting_resource resource1;
+    counting_resource resource2;
+    CHECK( cppsort::utility::get_memory_resource() == cppsort::utility::new_delete_resource() );
+    {
+        cppsort::utility::scoped_memory_resource _(&resource1);
+        {
+            cppsort::utility::scoped_memory_resource _(&resource2);
+            CHECK( cppsort::utility::get_memory_resource() == &resource2 );
+        }
+        CHECK( cppsort::utility::get_memory_resource() == &resource1 );
+    }
+    CHECK( cppsort::utility::get_memory_resource() == cppsort::utility::new_delete_resource() );
+}
+
+TEST_CASE( "scratch_pool reaches an allocation-free steady state",
+           "[utility][memory_resource][scratch_pool]" )
+{
+    // Sorting the same data over and over again needs the same amount
+    // of memory every time
+    std::vector<int> original;
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(original), 10'000, -1'000);
+
+    counting_resource upstream;
+    cppsort::utility::scratch_pool pool(&upstream);
+    cppsort::utility::scoped_memory_resource _(&pool);
+
+    for (int i = 0 ; i < 2 ; ++i) {
+        auto collection = original;
+        cppsort::tim_sort(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    // Only the chunk should still be alive at this point
+    CHECK( upstream.live_allocations == 1 );
+    CHECK( pool.capacity() > 0 );
+
+    auto allocations = upstream.allocations;
+    auto collection = original;
+    cppsort::tim_sort(collection);
+    CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    CHECK( upstream.allocations == allocations );
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2020 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/utility/multiway_merge.h>
+#include <cpp-sort/utility/thread_pool.h>
+
+namespace
+{
+    // Runs of pairs whose first element is the key and whose second
+    // element is the position in the concatenation of the runs, used
+    // to check the stability of the merges
+    auto make_runs(std::mt19937_64& engine, std::size_t nb_runs, std::size_t max_size, int nb_keys)
+        -> std::vector<std::vector<std::pair<int, int>>>
+    {
+        std::vector<std::vector<std::pair<int, int>>> runs(nb_runs);
+        int position = 0;
+        for (auto& run: runs) {
+            auto size = engine() % (max_size + 1);
+            for (std::size_t i = 0 ; i < size ; ++i) {
+                run.emplace_back(static_cast<int>(engine() % static_cast<unsigned>(nb_keys)), 0);
+            }
+            std::sort(std::begin(run), std::end(run));
+            for (auto& elem: run) {
+                elem.second = position++;
+            }
+        }
+        return runs;
+    }
+
+    auto expected_merge(const std::vector<std::vector<std::pair<int, int>>>& runs)
+        -> std::vector<std::pair<int, int>>
+    {
+        std::vector<std::pair<int, int>> res;
+        for (auto& run: runs) {
+            res.insert(std::end(res), std::begin(run), std::end(run));
+        }
+        std::stable_sort(std::begin(res), std::end(res), [](const auto& lhs, const auto& rhs) {
+            return lhs.first < rhs.first;
+        });
+        return res;
+    }
+
+    // Runs of move-only elements holding the consecutive integers
+    // [0, nb_runs * run_size), dealt to the runs in turn
+    auto make_unique_runs(std::size_t nb_runs, int run_size)
+        -> std::vector<std::vector<std::unique_ptr<int>>>
+    {
+        std::vector<std::vector<std::unique_ptr<int>>> runs(nb_runs);
+        for (int i = 0 ; i < run_size ; ++i) {
+            for (std::size_t run = 0 ; run < nb_runs ; ++run) {
+                runs[run].push_back(std::make_unique<int>(i * static_cast<int>(nb_runs) + static_cast<int>(run)));
+            }
+        }
+        return runs;
+    }
+
+    auto is_iota(const std::vector<std::unique_ptr<int>>& res)
+        -> bool
+    {
+        for (std::size_t i = 0 ; i < res.size() ; ++i) {
+            if (not res[i] || *res[i] != static_cast<int>(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    auto deref = [](const std::unique_ptr<int>& ptr) { return *ptr; };
+}
+
+TEST_CASE( "multiway_merge tests", "[utility][multiway_merge]" )
+{
+    std::mt19937_64 engine(Catch::rngSeed());
+
+    SECTION( "stable merge of many runs" )
+    {
+        for (std::size_t nb_runs : { 0u, 1u, 2u, 3u, 7u, 64u }) {
+            auto runs = make_runs(engine, nb_runs, 500, 50);
+            auto expected = expected_merge(runs);
+
+            std::vector<std::pair<int, int>> res;
+            cppsort::utility::multiway_merge(runs, std::back_inserter(res),
+                                             std::less<>{}, &std::pair<int, int>::first);
+            CHECK( res == expected );
+        }
+    }
+
+    SECTION( "merge runs of bidirectional iterators" )
+    {
+        std::vector<std::list<int>> runs = {
+            { 1, 4, 7, 10 },
+            { },
+            { 2, 2, 8 },
+            { 0, 3, 5, 6, 9 }
+        };
+        std::vector<int> res;
+        cppsort::utility::multiway_merge(std::begin(runs), std::end(runs), std::back_inserter(res));
+        CHECK( res == std::vector<int>{ 0, 1, 2, 2, 3, 4, 5, 6, 7, 8, 9, 10 } );
+    }
+
+    SECTION( "merge with std::greater<>" )
+    {
+        std::vector<std::vector<int>> runs = {
+            { 9, 5, 1 },
+            { 8, 6, 4, 2 },
+            { 7, 3 }
+        };
+        std::vector<int> res(9);
+        auto end = cppsort::utility::multiway_merge(runs, std::begin(res), std::greater<>{});
+        CHECK( end == std::end(res) );
+        CHECK( res == std::vector<int>{ 9, 8, 7, 6, 5, 4, 3, 2, 1 } );
+    }
+
+    SECTION( "merge runs of move-only elements" )
+    {
+        for (std::size_t nb_runs : { 1u, 4u }) {
+            auto runs = make_unique_runs(nb_runs, 100);
+            std::vector<std::unique_ptr<int>> res;
+            cppsort::utility::multiway_merge(runs, std::back_inserter(res), std::less<>{}, deref);
+            CHECK( res.size() == nb_runs * 100 );
+            CHECK( is_iota(res) );
+        }
+    }
+}
+
+TEST_CASE( "parallel_multiway_merge tests", "[utility][multiway_merge]" )
+{
+    // The output is split between several tasks only when there are
+    // enough elements to merge, hence the big runs; use a dedicated
+    // pool to make sure that it happens even on machines with a
+    // single hardware thread
+
+    cppsort::utility::thread_pool pool(3);
+    std::mt19937_64 engine(Catch::rngSeed());
+
+    SECTION( "merge with a dedicated pool" )
+    {
+        for (int nb_keys : { 3, 1000, 1'000'000 }) {
+            for (std::size_t nb_runs : { 1u, 2u, 5u, 33u }) {
+                auto runs = make_runs(engine, nb_runs, 300'000 / nb_runs, nb_keys);
+                auto expected = expected_merge(runs);
+
+                std::vector<std::pair<int, int>> res(expected.size());
+                auto end = cppsort::utility::parallel_multiway_merge(
+                    pool, runs, std::begin(res), std::less<>{}, &std::pair<int, int>::first
+                );
+                CHECK( end == std::end(res) );
+                CHECK( res == expected );
+            }
+        }
+    }
+
+    SECTION( "merge with the shared pool" )
+    {
+        auto runs = make_runs(engine, 5, 60'000, 1000);
+        auto expected = expected_merge(runs);
+
+        std::vector<std::pair<int, int>> res(expected.size());
+        auto end = cppsort::utility::parallel_multiway_merge(
+            std::begin(runs), std::end(runs), std::begin(res),
+            std::less<>{}, &std::pair<int, int>::first
+        );
+        CHECK( end == std::end(res) );
+        CHECK( res == expected );
+    }
+
+    SECTION( "merge runs of move-only elements" )
+    {
+        auto runs = make_unique_runs(5, 20'000);
+        std::vector<std::unique_ptr<int>> res(100'000);
+        auto end = cppsort::utility::parallel_multiway_merge(pool, runs, std::begin(res),
+                                                             std::less<>{}, deref);
+        CHECK( end == std::end(res) );
+        CHECK( is_iota(res) );
+    }
+}